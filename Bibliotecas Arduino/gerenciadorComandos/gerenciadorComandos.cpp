@@ -47,6 +47,7 @@
 // Declaração das variáveis globais (definidas aqui, declaradas com 'extern' no .h)
 bool ajustarDistanciaSensor_Ativo = false;            // Flag que indica se o modo de Ajuste do Sensor esta Ativo.
 bool lerRPMSensor_Ativo = false;                      // Flag que indica se o modo de Leitura do RPM esta Ativo.
+static gerenciadorComandos* gerenciadorAtual = nullptr; // Dono dos pinos do motor: a tabela só guarda funções livres.
 
 /******************************************************************************
  * Definir Construtor
@@ -58,6 +59,7 @@ gerenciadorComandos::gerenciadorComandos(uint8_t pinoLigarMotor, uint8_t pinoSen
     // Configura os pinos do inversor como saída
     pinMode(_pinoLigarMotor, OUTPUT);
     pinMode(_pinoSentidoGiro, OUTPUT);
+    gerenciadorAtual = this; // Os comandos do motor da tabela chamam os métodos deste gerenciador.
 }
 
 /******************************************************************************
@@ -84,13 +86,13 @@ void tratarStatus(Comando comando, sensorOpticoPro &sensor) { // Verifica o Stat
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (comando.numValores != 0) {
-    Serial.println("Erro: A função 'status' não espera nenhum parâmetro.");
-    Serial.print("Número de parâmetros fornecidos: ");
-    Serial.println(comando.numValores);
+    saidaSerial.println("Erro: A função 'status' não espera nenhum parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
     return; // Saída antecipada da função em caso de erro
   } /* */
 
-	  Serial.println("online"); // Imprime "online" na Serial, indicando que o sistema está funcionando
+	  saidaSerial.println("online"); // Imprime "online" na Serial, indicando que o sistema está funcionando
 }
 
 // Funções de tratamento dos comandos
@@ -99,14 +101,14 @@ void gerenciadorComandos::tratarLigarMotor(Comando comando, sensorOpticoPro &sen
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (comando.numValores != 0) {
-    Serial.println("Erro: A função 'ligarMotor' não espera nenhum parâmetro.");
-    Serial.print("Número de parâmetros fornecidos: ");
-    Serial.println(comando.numValores);
+    saidaSerial.println("Erro: A função 'ligarMotor' não espera nenhum parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
     return; // Saída antecipada da função em caso de erro
   } /* */
   
     digitalWrite(_pinoLigarMotor, HIGH);
-    Serial.println("Motor Ligado");
+    saidaSerial.println("Motor Ligado");
 
 }
 
@@ -116,14 +118,14 @@ void gerenciadorComandos::tratarDesligarMotor(Comando comando, sensorOpticoPro &
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (comando.numValores != 0) {
-    Serial.println("Erro: A função 'desligarMotor' não espera nenhum parâmetro.");
-    Serial.print("Número de parâmetros fornecidos: ");
-    Serial.println(comando.numValores);
+    saidaSerial.println("Erro: A função 'desligarMotor' não espera nenhum parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
     return; // Saída antecipada da função em caso de erro
   } /* */
 
     digitalWrite(_pinoLigarMotor, LOW);
-    Serial.println("Motor Desligado");
+    saidaSerial.println("Motor Desligado");
 }
 
 // Funções de tratamento dos comandos
@@ -132,18 +134,18 @@ void gerenciadorComandos::tratarSentidoGiro(Comando comando, sensorOpticoPro &se
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (comando.numValores != 0) {
-    Serial.println("Erro: A função 'sentidoGiro' não espera nenhum parâmetro.");
-    Serial.print("Número de parâmetros fornecidos: ");
-    Serial.println(comando.numValores);
+    saidaSerial.println("Erro: A função 'sentidoGiro' não espera nenhum parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
     return; // Saída antecipada da função em caso de erro
   } /* */
 
     if(digitalRead(_pinoSentidoGiro) == HIGH){
       digitalWrite(_pinoSentidoGiro, LOW);
-      Serial.println("Sentido de giro invertido para Anti-Horario");
+      saidaSerial.println("Sentido de giro invertido para Anti-Horario");
     } else {
       digitalWrite(_pinoSentidoGiro, HIGH);
-      Serial.println("Sentido de giro invertido para Horario");
+      saidaSerial.println("Sentido de giro invertido para Horario");
     }
 
 } /* */
@@ -153,9 +155,9 @@ void tratarConfigurarParametrosSensorOptico(Comando comando, sensorOpticoPro &se
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (comando.numValores != 2) {
-    Serial.println("Erro: A função 'tratarConfigurarParametrosSensorOptico' espera exatamente dois parâmetro.");
-    Serial.print("Número de parâmetros fornecidos: ");
-    Serial.println(comando.numValores);
+    saidaSerial.println("Erro: A função 'tratarConfigurarParametrosSensorOptico' espera exatamente dois parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
     return; // Saída antecipada da função em caso de erro
   } /* */
 
@@ -166,16 +168,16 @@ void tratarConfigurarParametrosSensorOptico(Comando comando, sensorOpticoPro &se
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (intNumRiscos < 1 || intNumRiscos > 255) {
-    Serial.println("Erro: O valor para 'numRiscos' deve estar entre 1 e 255.");
-    Serial.print(" Valor fornecido: ");
-    Serial.println(intNumRiscos);
+    saidaSerial.println("Erro: O valor para 'numRiscos' deve estar entre 1 e 255.");
+    saidaSerial.print(" Valor fornecido: ");
+    saidaSerial.println(intNumRiscos);
     return; // Saída antecipada da função em caso de erro
   }
 
   if (intRpmMaximo < 1 || intRpmMaximo > 65535) {
-    Serial.println("Erro: O valor para 'rpmMaximo' deve estar entre 1 e 65535.");
-    Serial.print(" Valor fornecido: ");
-    Serial.println(intRpmMaximo);
+    saidaSerial.println("Erro: O valor para 'rpmMaximo' deve estar entre 1 e 65535.");
+    saidaSerial.print(" Valor fornecido: ");
+    saidaSerial.println(intRpmMaximo);
     return; // Saída antecipada da função em caso de erro
   } /* */
   
@@ -185,11 +187,11 @@ void tratarConfigurarParametrosSensorOptico(Comando comando, sensorOpticoPro &se
   sensor.configurarParametrosSensorOptico(numRiscos, rpmMaximo); // Chama a função da biblioteca sensorOpticoPro para configurar os parâmetros
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
-  Serial.print("Parâmetros do sensor óptico configurados:");
-  Serial.print(" Número de riscos (pulsos por ciclo): ");
-  Serial.print(numRiscos);
-  Serial.print(", RPM desejado: ");
-  Serial.println(rpmMaximo);
+  saidaSerial.print("Parâmetros do sensor óptico configurados:");
+  saidaSerial.print(" Número de riscos (pulsos por ciclo): ");
+  saidaSerial.print(numRiscos);
+  saidaSerial.print(", RPM desejado: ");
+  saidaSerial.println(rpmMaximo);
   /* */
 }
 
@@ -198,9 +200,9 @@ void tratarRpmMaximo(Comando comando, sensorOpticoPro &sensor) { //Configura nov
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (comando.numValores != 1) {
-    Serial.println("Erro: A função 'rpmMaximo' espera exatamente um parâmetro.");
-    Serial.print("Número de parâmetros fornecidos: ");
-    Serial.println(comando.numValores);
+    saidaSerial.println("Erro: A função 'rpmMaximo' espera exatamente um parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
     return; // Saída antecipada da função em caso de erro
   } /* */
 
@@ -209,9 +211,9 @@ void tratarRpmMaximo(Comando comando, sensorOpticoPro &sensor) { //Configura nov
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (intRpmMaximo < 1 || intRpmMaximo > 65535) {
-    Serial.println("Erro: O valor para 'rpmMaximo' deve estar entre 1 e 65535.");
-    Serial.print(" Valor fornecido: ");
-    Serial.println(intRpmMaximo);
+    saidaSerial.println("Erro: O valor para 'rpmMaximo' deve estar entre 1 e 65535.");
+    saidaSerial.print(" Valor fornecido: ");
+    saidaSerial.println(intRpmMaximo);
     return; // Saída antecipada da função em caso de erro
   } /* */
 
@@ -219,8 +221,8 @@ void tratarRpmMaximo(Comando comando, sensorOpticoPro &sensor) { //Configura nov
   sensor.novoRpmMaximo(rpmMaximo);
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
-  Serial.print("RPM Desejado configurado: ");
-  Serial.println(sensor.lerRpmMaximo());
+  saidaSerial.print("RPM Desejado configurado: ");
+  saidaSerial.println(sensor.lerRpmMaximo());
   /* */
 }
 
@@ -229,9 +231,9 @@ void tratarNumRiscos(Comando comando, sensorOpticoPro &sensor) { //Configura a n
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (comando.numValores != 1) {
-    Serial.println("Erro: A função 'numRiscos' espera exatamente um parâmetro.");
-    Serial.print("Número de parâmetros fornecidos: ");
-    Serial.println(comando.numValores);
+    saidaSerial.println("Erro: A função 'numRiscos' espera exatamente um parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
     return; // Saída antecipada da função em caso de erro
   } /* */
 
@@ -240,9 +242,9 @@ void tratarNumRiscos(Comando comando, sensorOpticoPro &sensor) { //Configura a n
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (intNumRiscos < 1 || intNumRiscos > 255) {
-    Serial.println("Erro: O valor para 'numRiscos' deve estar entre 1 e 255.");
-    Serial.print(" Valor fornecido: ");
-    Serial.println(intNumRiscos);
+    saidaSerial.println("Erro: O valor para 'numRiscos' deve estar entre 1 e 255.");
+    saidaSerial.print(" Valor fornecido: ");
+    saidaSerial.println(intNumRiscos);
     return; // Saída antecipada da função em caso de erro
   } /* */
 
@@ -250,8 +252,8 @@ void tratarNumRiscos(Comando comando, sensorOpticoPro &sensor) { //Configura a n
   sensor.novoNumRiscos(numRiscos);
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
-  Serial.print("Número de Pulsos/Ciclo configurado: ");
-  Serial.println(sensor.lerNumRiscos());
+  saidaSerial.print("Número de Pulsos/Ciclo configurado: ");
+  saidaSerial.println(sensor.lerNumRiscos());
   /* */
 } 
 
@@ -260,9 +262,9 @@ void tratarFatorAjusteLimiar(Comando comando, sensorOpticoPro &sensor) { // Conf
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (comando.numValores != 1) {
-    Serial.println("Erro: A função 'fatorAjusteLimiar' espera exatamente um parâmetro.");
-    Serial.print("Número de parâmetros fornecidos: ");
-    Serial.println(comando.numValores);
+    saidaSerial.println("Erro: A função 'fatorAjusteLimiar' espera exatamente um parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
     return; // Saída antecipada da função em caso de erro
   } /* */
 
@@ -275,18 +277,18 @@ void tratarFatorAjusteLimiar(Comando comando, sensorOpticoPro &sensor) { // Conf
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (fatorAjusteLimiar < 1.0) {
-    Serial.println("Aviso: Fatores de ajuste limiar muito baixos (menores que 1) tornam o sistema extremamente sensível a pequenas variações na leitura do sensor, aumentando o risco de falsos positivos devido a ruído ou pequenas mudanças na iluminação.");
+    saidaSerial.println("Aviso: Fatores de ajuste limiar muito baixos (menores que 1) tornam o sistema extremamente sensível a pequenas variações na leitura do sensor, aumentando o risco de falsos positivos devido a ruído ou pequenas mudanças na iluminação.");
   } else if (fatorAjusteLimiar > 10.0) {
-    Serial.println("Aviso: Fatores de ajuste limiar muito altos (maiores que 10) podem tornar o sistema insensível a movimentos reais, exigindo variações muito grandes no sinal do sensor para detectar movimento. Além disso, podem ocorrer problemas de saturação ou overflow dependendo da implementação.");
+    saidaSerial.println("Aviso: Fatores de ajuste limiar muito altos (maiores que 10) podem tornar o sistema insensível a movimentos reais, exigindo variações muito grandes no sinal do sensor para detectar movimento. Além disso, podem ocorrer problemas de saturação ou overflow dependendo da implementação.");
   } else if (fatorAjusteLimiar > 5.0 && fatorAjusteLimiar <= 10.0){
-    Serial.println("Aviso: Fatores de ajuste limiar entre 5 e 10 podem começar a apresentar perda de sensibilidade, teste o sistema para garantir que os movimentos desejados ainda sejam detectados.");
+    saidaSerial.println("Aviso: Fatores de ajuste limiar entre 5 e 10 podem começar a apresentar perda de sensibilidade, teste o sistema para garantir que os movimentos desejados ainda sejam detectados.");
   }
 
   if (fatorAjusteLimiar < fatorLimiarMin || fatorAjusteLimiar > fatorLimiarMax) {
-    Serial.print("Erro: O fator de ajuste limiar deve estar entre ");
-    Serial.print(fatorLimiarMin);
-    Serial.print(" e ");
-    Serial.println(fatorLimiarMax);
+    saidaSerial.print("Erro: O fator de ajuste limiar deve estar entre ");
+    saidaSerial.print(fatorLimiarMin);
+    saidaSerial.print(" e ");
+    saidaSerial.println(fatorLimiarMax);
     return;
   } /* */
 
@@ -294,8 +296,8 @@ void tratarFatorAjusteLimiar(Comando comando, sensorOpticoPro &sensor) { // Conf
   
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
-  Serial.print("Fator de ajuste limiar definido para: ");
-  Serial.println(fatorAjusteLimiar); 
+  saidaSerial.print("Fator de ajuste limiar definido para: ");
+  saidaSerial.println(fatorAjusteLimiar); 
   /* */
 }
 
@@ -304,9 +306,9 @@ void tratarNumAmostrasLimiar(Comando comando, sensorOpticoPro &sensor) { // Defi
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (comando.numValores != 1) {
-    Serial.println("Erro: A função 'numAmostrasLimiar' espera exatamente um parâmetro.");
-    Serial.print("Número de parâmetros fornecidos: ");
-    Serial.println(comando.numValores);
+    saidaSerial.println("Erro: A função 'numAmostrasLimiar' espera exatamente um parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
     return; // Saída antecipada da função em caso de erro
   } /* */
 
@@ -315,18 +317,18 @@ void tratarNumAmostrasLimiar(Comando comando, sensorOpticoPro &sensor) { // Defi
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (intNumAmostrasLimiar < 1 || intNumAmostrasLimiar > 65535) {
-    Serial.println("Erro: O valor para 'numAmostrasDetecMov' deve estar entre 1 e 250.");
-    Serial.print(" Valor fornecido: ");
-    Serial.println(intNumAmostrasLimiar);
+    saidaSerial.println("Erro: O valor para 'numAmostrasDetecMov' deve estar entre 1 e 250.");
+    saidaSerial.print(" Valor fornecido: ");
+    saidaSerial.println(intNumAmostrasLimiar);
     return; // Saída antecipada da função em caso de erro
   }
  
   if (intNumAmostrasLimiar > 100 && intNumAmostrasLimiar < 251) {
-    Serial.println("Aviso: Um valor alto para 'numAmostrasLimiar' (acima de 100) pode aumentar a precisão, mas também pode reduzir o desempenho do sistema.");  
+    saidaSerial.println("Aviso: Um valor alto para 'numAmostrasLimiar' (acima de 100) pode aumentar a precisão, mas também pode reduzir o desempenho do sistema.");  
   }
 
   if (intNumAmostrasLimiar > 250) {
-    Serial.println("Aviso: Valores acima de 250 são altamente não recomendados, podendo causar lentidão excessiva.");
+    saidaSerial.println("Aviso: Valores acima de 250 são altamente não recomendados, podendo causar lentidão excessiva.");
     return; // Saída antecipada da função em caso de erro
   } /* */
 
@@ -335,8 +337,8 @@ void tratarNumAmostrasLimiar(Comando comando, sensorOpticoPro &sensor) { // Defi
   
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
-  Serial.print("Número de amostras para calcular o Limiar ideal definido para: ");
-  Serial.println(numAmostrasLimiar); 
+  saidaSerial.print("Número de amostras para calcular o Limiar ideal definido para: ");
+  saidaSerial.println(numAmostrasLimiar); 
   /* */
 }
 
@@ -345,9 +347,9 @@ void tratarNumAmostrasDetecMov(Comando comando, sensorOpticoPro &sensor) { // De
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (comando.numValores != 1) {
-    Serial.println("Erro: A função 'numAmostrasDetecMov' espera exatamente um parâmetro.");
-    Serial.print("Número de parâmetros fornecidos: ");
-    Serial.println(comando.numValores);
+    saidaSerial.println("Erro: A função 'numAmostrasDetecMov' espera exatamente um parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
     return; // Saída antecipada da função em caso de erro
   } /* */
 
@@ -356,43 +358,537 @@ void tratarNumAmostrasDetecMov(Comando comando, sensorOpticoPro &sensor) { // De
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (intNumAmostrasDetecMov < 1 || intNumAmostrasDetecMov > 65535) {
-    Serial.println("Erro: O valor para 'numAmostrasDetecMov' deve estar entre 1 e 250.");
-    Serial.print(" Valor fornecido: ");
-    Serial.println(intNumAmostrasDetecMov);
+    saidaSerial.println("Erro: O valor para 'numAmostrasDetecMov' deve estar entre 1 e 250.");
+    saidaSerial.print(" Valor fornecido: ");
+    saidaSerial.println(intNumAmostrasDetecMov);
     return; // Saída antecipada da função em caso de erro
   }
  
   if (intNumAmostrasDetecMov > 100 && intNumAmostrasDetecMov < 251) {
-    Serial.println("Aviso: Um valor alto para 'numAmostrasDetecMov' (acima de 100) pode aumentar a precisão, mas também pode reduzir o desempenho do sistema.");  
+    saidaSerial.println("Aviso: Um valor alto para 'numAmostrasDetecMov' (acima de 100) pode aumentar a precisão, mas também pode reduzir o desempenho do sistema.");  
   }
 
   if (intNumAmostrasDetecMov > 250) {
-    Serial.println("Aviso: Valores acima de 250 são altamente não recomendados, podendo causar lentidão excessiva.");
+    saidaSerial.println("Aviso: Valores acima de 250 são altamente não recomendados, podendo causar lentidão excessiva.");
     return; // Saída antecipada da função em caso de erro
   } /* */
 
   uint16_t numAmostrasDetecMov = (uint16_t)intNumAmostrasDetecMov; // Converter para uint16_t
-  sensor.novoNumAmostrasLimiar(numAmostrasDetecMov); // Chama a função da biblioteca sensorOpticoPro para configurar o novo número de amostras utilizadas para o Calculo de Detecção de Movimento.
+  sensor.novoNumAmostrasDetecMov(numAmostrasDetecMov); // Chama a função da biblioteca sensorOpticoPro para configurar o novo número de amostras utilizadas para o Calculo de Detecção de Movimento.
   
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
-  Serial.print("Número de amostras para detecção de movimento definido para: ");
-  Serial.println(numAmostrasDetecMov);
+  saidaSerial.print("Número de amostras para detecção de movimento definido para: ");
+  saidaSerial.println(numAmostrasDetecMov);
   /* */
 }
 
-void tratarAjustarDistanciaSensorOptico(Comando comando, sensorOpticoPro &sensor) { // Utilizado para ajustar a distancia do Sensor Óptico.
+void tratarEstimadorRPM(Comando comando, sensorOpticoPro &sensor) { // Seleciona o estimador de RPM (0: período, 1: M/T, 2: volta) e, opcionalmente, a taxa de atualização em Hz.
 
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
-  if (comando.numValores != 0) {
-    Serial.println("Erro: A função 'ajustarDistanciaSensorOptico' não espera nenhum parâmetro.");
+  if (comando.numValores < 1 || comando.numValores > 2) {
+    saidaSerial.println("Erro: A função 'estimadorRPM' espera um ou dois parâmetros.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
+    return; // Saída antecipada da função em caso de erro
+  } /* */
+
+  int intEstimador = comando.valores[0].toInt();
+  sensor.novoEstimadorRPM(static_cast<EstimadorRPM>(intEstimador));
+
+  if (comando.numValores > 1) {
+    sensor.novaTaxaAtualizacaoRPM(static_cast<uint16_t>(comando.valores[1].toInt()));
+  }
+
+  saidaSerial.print(F("Estimador de RPM: "));
+  if (sensor.lerEstimadorRPM() == ESTIMADOR_MT) {
+    saidaSerial.print(F("M/T a "));
+    saidaSerial.print(sensor.lerTaxaAtualizacaoRPM());
+    saidaSerial.print(F(" Hz"));
+  } else if (sensor.lerEstimadorRPM() == ESTIMADOR_VOLTA) {
+    saidaSerial.print(F("Volta ("));
+    saidaSerial.print(sensor.lerNumRiscos());
+    saidaSerial.print(F(" riscos por medição, atualizada a cada borda)"));
+  } else {
+    saidaSerial.print(F("Período"));
+  }
+  saidaSerial.println();
+}
+
+void tratarFiltroGlitch(Comando comando, sensorOpticoPro &sensor) { // Define a fração (%) da mediana dos períodos usada pelo filtro de glitches e exibe as bordas rejeitadas.
+
+  //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
+  /*
+  if (comando.numValores > 1) {
+    saidaSerial.println("Erro: A função 'filtroGlitch' espera no máximo um parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
+    return; // Saída antecipada da função em caso de erro
+  } /* */
+
+  if (comando.numValores > 0) {
+    sensor.novaFracaoFiltroGlitch(static_cast<uint8_t>(comando.valores[0].toInt()));
+  }
+
+  saidaSerial.print(F("Filtro de glitches: "));
+  saidaSerial.print(sensor.lerFracaoFiltroGlitch());
+  saidaSerial.print(F("% da mediana | Período mediano (micros): "));
+  saidaSerial.print(sensor.lerPeriodoMediano());
+  saidaSerial.print(F(" | Bordas rejeitadas: "));
+  saidaSerial.println(sensor.lerBordasRejeitadas());
+}
+
+void tratarPulsos(Comando comando, sensorOpticoPro &sensor) { // Ativa (1) ou desativa (0) a correção da contagem de riscos e exibe os pulsos normais, perdidos e extras.
+
+  //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
+  /*
+  if (comando.numValores > 1) {
+    saidaSerial.println("Erro: A função 'pulsos' espera no máximo um parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
+    return; // Saída antecipada da função em caso de erro
+  } /* */
+
+  if (comando.numValores > 0) {
+    sensor.ativarCorrecaoPulsos(comando.valores[0].toInt() != 0);
+  }
+
+  saidaSerial.print(F("Correção de pulsos: "));
+  saidaSerial.print(sensor.lerCorrecaoPulsos() ? F("ativa") : F("inativa"));
+  saidaSerial.print(F(" | Normais: "));
+  saidaSerial.print(sensor.lerPulsosNormais());
+  saidaSerial.print(F(" | Perdidos: "));
+  saidaSerial.print(sensor.lerPulsosPerdidos());
+  saidaSerial.print(F(" | Extras: "));
+  saidaSerial.println(sensor.lerPulsosExtras());
+}
+
+void tratarGeometria(Comando comando, sensorOpticoPro &sensor) { // Aprende a geometria do disco (parâmetro: voltas), desativa (0) ou exibe a largura de cada risco.
+
+  //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
+  /*
+  if (comando.numValores > 1) {
+    saidaSerial.println("Erro: A função 'geometria' espera no máximo um parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
+    return; // Saída antecipada da função em caso de erro
+  } /* */
+
+  if (comando.numValores > 0) {
+    long voltas = comando.valores[0].toInt();
+    if (voltas > 0) {
+      sensor.aprenderGeometria(static_cast<uint16_t>(voltas));
+    } else {
+      sensor.desativarGeometria();
+      saidaSerial.println(F("Geometria desativada: todos os riscos com a largura nominal."));
+    }
+    return;
+  }
+
+  const geometriaDisco<SENSOR_OPTICO_MAX_RISCOS_GEOMETRIA>& geometria = sensor.lerGeometria();
+  if (geometria.aprendendo()) {
+    saidaSerial.print(F("Geometria: aprendendo, faltam "));
+    saidaSerial.print(geometria.lerVoltasRestantes());
+    saidaSerial.println(F(" voltas."));
+    return;
+  }
+  if (!geometria.ativa()) {
+    saidaSerial.println(F("Geometria: inativa (use 'geometria <voltas>' com o disco em velocidade constante)."));
+    return;
+  }
+  saidaSerial.print(F("Geometria ativa | Voltas: "));
+  saidaSerial.print(geometria.lerVoltasAprendidas());
+  saidaSerial.print(F(" | Variação da velocidade (milésimos): "));
+  saidaSerial.println(geometria.lerVariacaoVelocidadeMilesimos());
+  saidaSerial.println(F("Risco | Largura (nominal = 1.0000)"));
+  for (uint8_t i = 0; i < geometria.lerNumRiscos(); i++) {
+    saidaSerial.print(i);
+    saidaSerial.print(F(" | "));
+    saidaSerial.println((float)GEOMETRIA_UM_Q14 / geometria.lerFator(i), 4);
+  }
+}
+
+void tratarIndice(Comando comando, sensorOpticoPro &sensor) { // Seleciona a marca de índice do disco (0: nenhuma, 1: risco ausente, 2: risco largo) e exibe o ângulo absoluto e as voltas.
+
+  //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
+  /*
+  if (comando.numValores > 1) {
+    saidaSerial.println("Erro: A função 'indice' espera no máximo um parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
+    return; // Saída antecipada da função em caso de erro
+  } /* */
+
+  if (comando.numValores > 0) {
+    sensor.novaMarcaIndice(static_cast<MarcaIndice>(comando.valores[0].toInt()));
+  }
+
+  saidaSerial.print(F("Marca de índice: "));
+  saidaSerial.print(sensor.lerMarcaIndice());
+  saidaSerial.print(sensor.indiceSincronizado() ? F(" | Sincronizado | Ângulo absoluto: ") : F(" | Sem referência | Ângulo relativo: "));
+  saidaSerial.print(sensor.lerAnguloAtual());
+  saidaSerial.print(F(" | Voltas: "));
+  saidaSerial.print(sensor.lerVoltas());
+  saidaSerial.print(F(" | Marcas: "));
+  saidaSerial.print(sensor.lerMarcasIndice());
+  saidaSerial.print(F(" | Falhas: "));
+  saidaSerial.println(sensor.lerFalhasIndice());
+}
+
+void tratarRastreamento(Comando comando, sensorOpticoPro &sensor) { // Liga (1) ou desliga (0) o filtro de rastreamento, define o ruído de processo e exibe velocidade, aceleração e ganhos.
+
+  //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
+  /*
+  if (comando.numValores > 2) {
+    saidaSerial.println("Erro: A função 'rastreamento' espera no máximo dois parâmetros.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
+    return; // Saída antecipada da função em caso de erro
+  } /* */
+
+  if (comando.numValores > 1) {
+    sensor.novoRuidoProcesso(comando.valores[1].toFloat());
+  }
+  if (comando.numValores > 0) {
+    sensor.ativarFiltroRastreamento(comando.valores[0].toInt() != 0);
+  }
+
+  const filtroRastreamento& filtro = sensor.lerFiltroRastreamento();
+  saidaSerial.print(F("Rastreamento - RPM: "));
+  saidaSerial.print(sensor.lerRpmRastreado(), 3);
+  saidaSerial.print(F(" | Aceleração (RPM/s): "));
+  saidaSerial.print(sensor.lerAceleracaoRpm(), 1);
+  saidaSerial.print(F(" | Ruído de processo: "));
+  saidaSerial.print(filtro.lerRuidoProcesso(), 8);
+  saidaSerial.print(F(" | Ganhos: "));
+  for (uint8_t i = 0; i < 3; i++) {
+    saidaSerial.print(filtro.lerGanhos()[i], 6);
+    saidaSerial.print(' ');
+  }
+  saidaSerial.println();
+}
+
+void tratarParada(Comando comando, sensorOpticoPro &sensor) { // Define o tempo limite de parada (ms) e exibe o estado do disco e os eventos de parada e partida.
+
+  //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
+  /*
+  if (comando.numValores > 1) {
+    saidaSerial.println("Erro: A função 'parada' espera no máximo um parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
+    return; // Saída antecipada da função em caso de erro
+  } /* */
+
+  if (comando.numValores > 0) {
+    sensor.novoTempoParada(comando.valores[0].toInt());
+  }
+
+  uint8_t eventos = sensor.lerEventosMovimento();
+  saidaSerial.print(F("Tempo limite de parada: "));
+  saidaSerial.print(sensor.lerTempoParada());
+  saidaSerial.print(F(" ms | RPM mínimo: "));
+  saidaSerial.print(60000.0 / ((float)sensor.lerNumRiscos() * sensor.lerTempoParada()));
+  saidaSerial.print(sensor.girando() ? F(" | Girando") : F(" | Parado"));
+  saidaSerial.print(F(" | Eventos desde a última leitura:"));
+  if (eventos & EVENTO_PARADA) saidaSerial.print(F(" parada"));
+  if (eventos & EVENTO_PARTIDA) saidaSerial.print(F(" partida"));
+  if (eventos == EVENTO_NENHUM) saidaSerial.print(F(" nenhum"));
+  saidaSerial.println();
+}
+
+void tratarFiltro(Comando comando, sensorOpticoPro &sensor) { // Seleciona a cadeia de filtros do intervalo (0: nenhuma, 1: rápida, 2: suave, 3: robusta).
+
+  //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
+  /*
+  if (comando.numValores > 1) {
+    saidaSerial.println("Erro: A função 'filtro' espera no máximo um parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
+    return; // Saída antecipada da função em caso de erro
+  } /* */
+
+  if (comando.numValores > 0) {
+    sensor.novaCadeiaFiltro(static_cast<CadeiaFiltro>(comando.valores[0].toInt()));
+  }
+
+  saidaSerial.print(F("Cadeia de filtros: "));
+  switch (sensor.lerCadeiaFiltro()) {
+    case FILTRO_RAPIDO:  saidaSerial.println(F("1 - rápida (mediana de 3 + média exponencial 1/4)")); break;
+    case FILTRO_SUAVE:   saidaSerial.println(F("2 - suave (mediana de 5 + média móvel de 8)")); break;
+    case FILTRO_ROBUSTO: saidaSerial.println(F("3 - robusta (mediana de 3 + limitador de taxa 12,5%)")); break;
+    default:             saidaSerial.println(F("0 - nenhuma")); break;
+  }
+}
+
+// Ciclos por amostra de um estágio (ou cadeia), descontado o custo do laço medido com a cadeia vazia.
+template <typename Estagio, typename T>
+float medirCustoEstagio(T base, uint16_t amostras) {
+  Estagio estagio;
+  cadeiaFiltros<T> vazia;
+  volatile T saida; // Impede que o compilador descarte o resultado.
+
+  unsigned long inicio = micros();
+  for (uint16_t i = 0; i < amostras; i++) {
+    saida = vazia.filtrar(base + (T)(i & 7));
+  }
+  unsigned long laco = micros() - inicio;
+
+  inicio = micros();
+  for (uint16_t i = 0; i < amostras; i++) {
+    saida = estagio.filtrar(base + (T)(i & 7)); // Amostras variando, para a mediana e o limitador trocarem de ramo.
+  }
+  unsigned long duracao = micros() - inicio;
+  (void)saida;
+
+  long liquido = (long)duracao - (long)laco;
+  return (liquido > 0) ? (float)liquido * (F_CPU / 1000000UL) / amostras : 0.0;
+}
+
+void tratarCustoFiltros(Comando comando, sensorOpticoPro &sensor) { // Mede o custo em ciclos de cada estágio de filtro (intervalo inteiro e RPM em float) e das cadeias pré-montadas.
+
+  const uint16_t amostras = 1000;
+  const unsigned long intervalo = 1667; // Intervalo de um disco de 36 riscos a 1000 RPM.
+  const float rpm = 1000.0;
+
+  saidaSerial.println(F("Ciclos por amostra - intervalo (unsigned long) | RPM (float):"));
+  saidaSerial.print(F("Mediana de 3: "));
+  saidaSerial.print(medirCustoEstagio<filtroMediana<unsigned long, 3> >(intervalo, amostras));
+  saidaSerial.print(F(" | "));
+  saidaSerial.println(medirCustoEstagio<filtroMediana<float, 3> >(rpm, amostras));
+  saidaSerial.print(F("Mediana de 5: "));
+  saidaSerial.print(medirCustoEstagio<filtroMediana<unsigned long, 5> >(intervalo, amostras));
+  saidaSerial.print(F(" | "));
+  saidaSerial.println(medirCustoEstagio<filtroMediana<float, 5> >(rpm, amostras));
+  saidaSerial.print(F("Média exponencial 1/4: "));
+  saidaSerial.print(medirCustoEstagio<filtroMediaExponencial<unsigned long, 2> >(intervalo, amostras));
+  saidaSerial.print(F(" | "));
+  saidaSerial.println(medirCustoEstagio<filtroMediaExponencial<float, 2> >(rpm, amostras));
+  saidaSerial.print(F("Média móvel de 8: "));
+  saidaSerial.print(medirCustoEstagio<filtroMediaMovel<unsigned long, 8> >(intervalo, amostras));
+  saidaSerial.print(F(" | "));
+  saidaSerial.println(medirCustoEstagio<filtroMediaMovel<float, 8> >(rpm, amostras));
+  saidaSerial.print(F("Limitador de taxa 12,5%: "));
+  saidaSerial.print(medirCustoEstagio<filtroLimitadorTaxa<unsigned long, 3> >(intervalo, amostras));
+  saidaSerial.print(F(" | "));
+  saidaSerial.println(medirCustoEstagio<filtroLimitadorTaxa<float, 3> >(rpm, amostras));
+
+  saidaSerial.println(F("Cadeias pré-montadas (intervalo):"));
+  saidaSerial.print(F("1 - rápida: "));
+  saidaSerial.println(medirCustoEstagio<cadeiaIntervaloRapida>(intervalo, amostras));
+  saidaSerial.print(F("2 - suave: "));
+  saidaSerial.println(medirCustoEstagio<cadeiaIntervaloSuave>(intervalo, amostras));
+  saidaSerial.print(F("3 - robusta: "));
+  saidaSerial.println(medirCustoEstagio<cadeiaIntervaloRobusta>(intervalo, amostras));
+}
+
+void tratarTelemetria(Comando comando, sensorOpticoPro &sensor) { // Seleciona a saída das medições (0: desligada, 1: texto, 2: binária) e exibe os contadores da telemetria binária.
+
+  //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
+  /*
+  if (comando.numValores > 1) {
+    saidaSerial.println("Erro: A função 'telemetria' espera no máximo um parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
+    return; // Saída antecipada da função em caso de erro
+  } /* */
+
+  if (comando.numValores > 0) {
+    sensor.configurarTelemetria(static_cast<TelemetriaRPM>(comando.valores[0].toInt())); // Binária: quadros pela fila da Serial.
+  }
+
+  saidaSerial.print(F("Telemetria: "));
+  switch (sensor.lerModoTelemetria()) {
+    case TELEMETRIA_TEXTO:   saidaSerial.println(F("1 - texto")); break;
+    case TELEMETRIA_BINARIA: saidaSerial.println(F("2 - binária (quadros COBS terminados em 0x00)")); break;
+    default:                 saidaSerial.println(F("0 - desligada")); break;
+  }
+  const telemetriaBinaria<SENSOR_OPTICO_TAMANHO_QUADRO_TELEMETRIA>& telemetria = sensor.lerTelemetria();
+  saidaSerial.print(F("Amostras: "));
+  saidaSerial.print(telemetria.lerAmostrasEnviadas());
+  saidaSerial.print(F(", quadros: "));
+  saidaSerial.print(telemetria.lerQuadrosEnviados());
+  saidaSerial.print(F(", bytes: "));
+  saidaSerial.println(telemetria.lerBytesEnviados());
+}
+
+void tratarSaida(Comando comando, sensorOpticoPro &sensor) { // Seleciona a política da telemetria na fila de saída (0: descartar antigas, 1: dizimar; opcional: fator) e exibe ocupação e descartes.
+
+  //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
+  /*
+  if (comando.numValores > 2) {
+    Serial.println("Erro: A função 'saida' espera no máximo dois parâmetros.");
     Serial.print("Número de parâmetros fornecidos: ");
     Serial.println(comando.numValores);
     return; // Saída antecipada da função em caso de erro
   } /* */
 
-  Serial.println(F("Ajuste da distancia entre Sensor Óptico e Disco Decodificador iniciado!"));
+  filaSaidaSerial& fila = saidaSerial.lerFila();
+  if (comando.numValores > 0) {
+    uint8_t fator = (comando.numValores > 1) ? comando.valores[1].toInt() : fila.lerFatorDizimacao();
+    if (!fila.configurarPolitica(static_cast<PoliticaSaida>(comando.valores[0].toInt()), fator)) {
+      saidaSerial.println(F("Política inválida (0: descartar antigas, 1: dizimar) ou fator menor que 2."));
+    }
+  }
+
+  saidaSerial.print(F("Política da telemetria: "));
+  if (fila.lerPolitica() == POLITICA_DIZIMAR) {
+    saidaSerial.print(F("1 - dizimar (uma a cada "));
+    saidaSerial.print(fila.lerFatorDizimacao());
+    saidaSerial.println(F(" acima da metade da fila)"));
+  } else {
+    saidaSerial.println(F("0 - descartar antigas"));
+  }
+  saidaSerial.print(F("Respostas - ocupação máxima: "));
+  saidaSerial.print(fila.lerOcupacaoMaximaRespostas());
+  saidaSerial.print('/');
+  saidaSerial.println(fila.capacidadeRespostas());
+  saidaSerial.print(F("Telemetria - ocupação máxima: "));
+  saidaSerial.print(fila.lerOcupacaoMaximaTelemetria());
+  saidaSerial.print('/');
+  saidaSerial.print(fila.capacidadeTelemetria());
+  saidaSerial.print(F(", mensagens enviadas: "));
+  saidaSerial.println(fila.lerMensagensEnviadas());
+  saidaSerial.print(F("Descartadas - antigas: "));
+  saidaSerial.print(fila.lerDescartadasAntigas());
+  saidaSerial.print(F(", novas: "));
+  saidaSerial.print(fila.lerDescartadasNovas());
+  saidaSerial.print(F(", dizimadas: "));
+  saidaSerial.println(fila.lerDizimadas());
+}
+
+// Captura das bordas brutas do sensor do comando 'captura' (alimentada e atendida pelo calcularRPM()). Os quadros ficam
+// na arena dos sensores só enquanto a captura está em uso.
+capturaBordasSensor capturaComando(sensorOpticoPro::lerArena(), sensorOpticoPro::enviarCapturaSerial);
+
+void tratarCaptura(Comando comando, sensorOpticoPro &sensor) { // Captura as bordas brutas (0: parar, 1: armar até a próxima partida, 2: disparar agora; opcional: número de bordas) e exibe os contadores.
+
+  //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
+  /*
+  if (comando.numValores > 2) {
+    saidaSerial.println("Erro: A função 'captura' espera no máximo dois parâmetros.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
+    return; // Saída antecipada da função em caso de erro
+  } /* */
+
+  if (comando.numValores > 0) {
+    long acao = comando.valores[0].toInt();
+    unsigned long limite = (comando.numValores > 1) ? comando.valores[1].toInt() : 0;
+    sensor.associarCaptura(&capturaComando);
+    if (acao == 0) {
+      capturaComando.parar(); // Os quadros pendentes continuam saindo pelo calcularRPM().
+      capturaComando.atender(); // Sem quadros pendentes, a arena é devolvida já.
+    } else if ((acao == 1 || acao == 2) && !capturaComando.armar(limite)) {
+      saidaSerial.print(F("Sem espaço na arena para os quadros da captura ("));
+      saidaSerial.print((uint16_t)SENSOR_OPTICO_QUADROS_CAPTURA * SENSOR_OPTICO_TAMANHO_QUADRO_CAPTURA);
+      saidaSerial.print(F(" bytes; em uso: "));
+      saidaSerial.print(sensorOpticoPro::lerArena().emUso());
+      saidaSerial.print('/');
+      saidaSerial.print(sensorOpticoPro::lerArena().capacidade());
+      saidaSerial.println(F("). Troque o estimador de uma volta ou aumente SENSOR_OPTICO_TAMANHO_ARENA."));
+    } else if (acao == 1 || acao == 2) {
+      if (acao == 2) {
+        capturaComando.disparar();
+      }
+      lerRPMSensor_Ativo = true; // A captura recebe as bordas processadas pelo calcularRPM().
+    } else {
+      saidaSerial.println(F("Ação inválida (0: parar, 1: armar, 2: disparar)."));
+    }
+  }
+
+  saidaSerial.print(F("Captura: "));
+  switch (capturaComando.lerEstado()) {
+    case CAPTURA_ARMADA: saidaSerial.println(F("1 - armada (dispara na partida do disco ou com 'captura 2')")); break;
+    case CAPTURA_ATIVA:  saidaSerial.println(F("2 - ativa (quadros QUADRO_CAPTURA entre 0x00)")); break;
+    default:             saidaSerial.println(F("0 - parada")); break;
+  }
+  saidaSerial.print(F("Bordas: "));
+  saidaSerial.print(capturaComando.lerCapturadas());
+  if (capturaComando.lerLimite() != 0) {
+    saidaSerial.print('/');
+    saidaSerial.print(capturaComando.lerLimite());
+  }
+  saidaSerial.print(F(", perdidas: "));
+  saidaSerial.print(capturaComando.lerPerdidas());
+  saidaSerial.print(F(", quadros: "));
+  saidaSerial.print(capturaComando.lerQuadrosEnviados());
+  saidaSerial.print(F(", bytes: "));
+  saidaSerial.print(capturaComando.lerBytesEnviados());
+  saidaSerial.print(F(", pendentes: "));
+  saidaSerial.println(capturaComando.lerQuadrosPendentes());
+}
+
+void tratarMemoria(Comando comando, sensorOpticoPro &sensor) { // Exibe a RAM estática ocupada pelo sensor.
+
+  //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
+  /*
+  if (comando.numValores != 0) {
+    saidaSerial.println("Erro: A função 'memoria' não espera nenhum parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
+    return; // Saída antecipada da função em caso de erro
+  } /* */
+
+  sensor.exibirRelatorioMemoria();
+}
+
+void tratarLimiar(Comando comando, sensorOpticoPro &sensor) { // Exibe a calibração do limiar; com o parâmetro 1, reinicia a calibração.
+
+  //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
+  /*
+  if (comando.numValores > 1) {
+    saidaSerial.println("Erro: A função 'limiar' espera no máximo um parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
+    return; // Saída antecipada da função em caso de erro
+  } /* */
+
+  if (comando.numValores > 0 && comando.valores[0].toInt() == 1) {
+    sensor.recalibrarLimiar();
+    return;
+  }
+
+  const estatisticaWelford& alto = sensor.lerCalibracaoTempoAlto();
+  const estatisticaWelford& baixo = sensor.lerCalibracaoTempoBaixo();
+  saidaSerial.print(sensor.limiarCalibrado() ? F("Limiar calibrado (micros): ") : F("Calibrando... limiar atual (micros): "));
+  saidaSerial.println(sensor.lerLimiarPulsacoes());
+  saidaSerial.print(F("Alto - média: "));
+  saidaSerial.print(alto.media());
+  saidaSerial.print(F(" desvio: "));
+  saidaSerial.print(alto.desvioPadrao());
+  saidaSerial.print(F(" amostras: "));
+  saidaSerial.println(alto.amostras());
+  saidaSerial.print(F("Baixo - média: "));
+  saidaSerial.print(baixo.media());
+  saidaSerial.print(F(" desvio: "));
+  saidaSerial.print(baixo.desvioPadrao());
+  saidaSerial.print(F(" amostras: "));
+  saidaSerial.println(baixo.amostras());
+  saidaSerial.print(F("Erro relativo da média (%): "));
+  saidaSerial.println(sensor.lerErroRelativoLimiar() * 100.0, 3);
+  saidaSerial.print(F("Filtro de nível (micros, 0: inativo): "));
+  saidaSerial.print(sensor.lerLimiarNivel());
+  saidaSerial.print(F(" | Níveis curtos descartados: "));
+  saidaSerial.println(sensor.lerNiveisCurtos());
+}
+
+void tratarAjustarDistanciaSensorOptico(Comando comando, sensorOpticoPro &sensor) { // Utilizado para ajustar a distancia do Sensor Óptico.
+
+  //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
+  /*
+  if (comando.numValores > 1) {
+    saidaSerial.println("Erro: A função 'ajustarDistanciaSensorOptico' espera no máximo um parâmetro (relatórios por segundo).");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
+    return; // Saída antecipada da função em caso de erro
+  } /* */
+
+  if (comando.numValores > 0) {
+    sensor.novaTaxaPublicacaoAjuste(static_cast<uint8_t>(comando.valores[0].toInt())); // Relatórios por segundo.
+  }
+
+  saidaSerial.println(F("Ajuste da distancia entre Sensor Óptico e Disco Decodificador iniciado!"));
 
   // Ativa a flag `ajustarDistanciaSensorOptico`, indicando que o modo de piscar está em execução.
   ajustarDistanciaSensor_Ativo = true;
@@ -403,30 +899,31 @@ void tratarPararAjusteDistanciaSensorOptico(Comando comando, sensorOpticoPro &se
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (comando.numValores != 0) {
-    Serial.println("Erro: A função 'ajustarDistanciaSensorOptico' não espera nenhum parâmetro.");
-    Serial.print("Número de parâmetros fornecidos: ");
-    Serial.println(comando.numValores);
+    saidaSerial.println("Erro: A função 'ajustarDistanciaSensorOptico' não espera nenhum parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
     return; // Saída antecipada da função em caso de erro
   } /* */
 
-  Serial.println(F("Ajuste da distancia entre Sensor Óptico e Disco Decodificador finalizado!"));
+  saidaSerial.println(F("Ajuste da distancia entre Sensor Óptico e Disco Decodificador finalizado!"));
+  sensor.pararAjusteDistanciaSensorOptico();
 
   // Desativa a flag `ajustarDistanciaSensorOptico`, indicando que o modo de piscar está em execução.
   ajustarDistanciaSensor_Ativo = false;
 } 
 
-void tratarLerRPM(Comando comando) { // Utilizado para Ler o RPM atual
+void tratarLerRPM(Comando comando, sensorOpticoPro &sensor) { // Utilizado para Ler o RPM atual
 
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (comando.numValores != 0) {
-    Serial.println("Erro: A função 'lerRPM' não espera nenhum parâmetro.");
-    Serial.print("Número de parâmetros fornecidos: ");
-    Serial.println(comando.numValores);
+    saidaSerial.println("Erro: A função 'lerRPM' não espera nenhum parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
     return; // Saída antecipada da função em caso de erro
   } /* */
 
-    Serial.println("Leitura de RPM iniciada!");
+    saidaSerial.println("Leitura de RPM iniciada!");
 
   // Ativa a flag `ajustarDistanciaSensorOptico`, indicando que o modo de piscar está em execução.
   lerRPMSensor_Ativo = true;
@@ -437,50 +934,93 @@ void tratarPararLeituraRpm(Comando comando, sensorOpticoPro &sensor) { // Utiliz
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (comando.numValores != 0) {
-    Serial.println("Erro: A função 'pararLeituraRpm' não espera nenhum parâmetro.");
-    Serial.print("Número de parâmetros fornecidos: ");
-    Serial.println(comando.numValores);
+    saidaSerial.println("Erro: A função 'pararLeituraRpm' não espera nenhum parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
     return; // Saída antecipada da função em caso de erro
   } /* */
 
-  Serial.println(F("Leitura de RPM finalizada!"));
+  saidaSerial.println(F("Leitura de RPM finalizada!"));
   // Desativa a flag `ajustarDistanciaSensorOptico`, indicando que o modo de piscar está em execução.
   lerRPMSensor_Ativo = false;
 }  
 
+void tratarCapturaInterrupcao(Comando comando, sensorOpticoPro &sensor) { // Ativa (1) ou desativa (0) a captura das bordas do Sensor Óptico por interrupção.
+
+  //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
+  /*
+  if (comando.numValores != 1) {
+    saidaSerial.println("Erro: A função 'capturaInterrupcao' espera exatamente um parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
+    return; // Saída antecipada da função em caso de erro
+  } /* */
+
+  if (comando.valores[0].toInt() != 0) {
+    if (sensor.ativarCapturaPorInterrupcao()) {
+      saidaSerial.println(F("Captura de bordas por interrupção ativada!"));
+    }
+  } else {
+    sensor.desativarCapturaPorInterrupcao();
+    saidaSerial.println(F("Captura de bordas por interrupção desativada!"));
+  }
+
+  // Informa os contadores da fila de bordas acumulados até agora e os zera para a próxima medição.
+  saidaSerial.print(F("Bordas perdidas: "));
+  saidaSerial.print(sensor.lerBordasPerdidas());
+  saidaSerial.print(F(", Ocupação máxima da fila: "));
+  saidaSerial.println(sensor.lerOcupacaoMaximaFila());
+  sensor.zerarContadoresCaptura();
+}
+
 // Funções de tratamento dos comandos
-void tratarAjuda(Comando comando) { // Verifica o Status da Conexão Serial
+void tratarAjuda(Comando comando, sensorOpticoPro &sensor) { // Verifica o Status da Conexão Serial
 
   //As partes comentadas foram removidas pois serão implementadas no sistema web para economizar memoria da placa.
   /*
   if (comando.numValores != 0) {
-    Serial.println("Erro: A função 'ajuda' não espera nenhum parâmetro.");
-    Serial.print("Número de parâmetros fornecidos: ");
-    Serial.println(comando.numValores);
+    saidaSerial.println("Erro: A função 'ajuda' não espera nenhum parâmetro.");
+    saidaSerial.print("Número de parâmetros fornecidos: ");
+    saidaSerial.println(comando.numValores);
     return; // Saída antecipada da função em caso de erro
   } 
 
-	Serial.println("Lista de Comandos:");
-	Serial.println("------------------");
-	Serial.println("status: status: Exibe o estado atual do sistema.");
-	Serial.println("configurarParametrosSensorOptico: Define os parâmetros do sensor óptico, como número de riscos e RPM desejado.");
-	Serial.println("numRiscos: Define a quantidade de pulsos por ciclo do disco decodificador.");
-	Serial.println("rpmMaximo: Define a velocidade de rotação (RPM) desejada para o disco decodificador.");
-	Serial.println("fatorAjusteLimiar: Define o fator de ajuste para o cálculo do limiar de detecção, compensando variações na iluminação ambiente.");
-	Serial.println("numAmostrasLimiar: Define o número de amostras usadas para calcular o limiar ideal.");
-	Serial.println("numAmostrasDetecMov: Define o número de amostras usadas para detectar movimento.");
-	Serial.println("ajustarDistanciaSensorOptico: Auxilia no ajuste da distância ideal entre o sensor óptico e o disco decodificador.");
-	Serial.println("lerRPM: Inicia a leitura e exibe a velocidade de rotação (RPM) do disco decodificador.");
-	Serial.println("ajuda: Exibe esta lista de comandos.");
-	Serial.println("------------------"); 
+	saidaSerial.println("Lista de Comandos:");
+	saidaSerial.println("------------------");
+	saidaSerial.println("status: status: Exibe o estado atual do sistema.");
+	saidaSerial.println("configurarParametrosSensorOptico: Define os parâmetros do sensor óptico, como número de riscos e RPM desejado.");
+	saidaSerial.println("numRiscos: Define a quantidade de pulsos por ciclo do disco decodificador.");
+	saidaSerial.println("rpmMaximo: Define a velocidade de rotação (RPM) desejada para o disco decodificador.");
+	saidaSerial.println("fatorAjusteLimiar: Define o fator de ajuste para o cálculo do limiar de detecção, compensando variações na iluminação ambiente.");
+	saidaSerial.println("numAmostrasLimiar: Define o número mínimo de tempos em alto e em baixo antes de aceitar a calibração do limiar.");
+	saidaSerial.println("numAmostrasDetecMov: Define o número de amostras usadas para detectar movimento.");
+	saidaSerial.println("estimadorRPM: Seleciona o estimador de RPM (0: período, 1: M/T, 2: volta) e a taxa de atualização em Hz do M/T.");
+	saidaSerial.println("filtroGlitch: Define a fração (%) da mediana dos períodos abaixo da qual uma borda é rejeitada (0 desativa) e exibe as bordas rejeitadas.");
+	saidaSerial.println("pulsos: Ativa (1) ou desativa (0) a correção da contagem de riscos por pulsos perdidos e exibe os pulsos normais, perdidos e extras.");
+	saidaSerial.println("geometria: Aprende a largura de cada risco do disco durante o número de voltas informado (0 desativa) ou exibe a tabela.");
+	saidaSerial.println("indice: Seleciona a marca de índice do disco (0: nenhuma, 1: risco ausente, 2: risco largo) e exibe o ângulo absoluto e o contador de voltas.");
+	saidaSerial.println("rastreamento: Liga (1) ou desliga (0) o filtro de rastreamento de velocidade e aceleração (opcional: ruído de processo) e exibe as estimativas.");
+	saidaSerial.println("parada: Define o tempo limite sem bordas (ms) até a leitura ir a zero e exibe os eventos de parada e partida.");
+	saidaSerial.println("filtro: Seleciona a cadeia de filtros do intervalo entre bordas (0: nenhuma, 1: rápida, 2: suave, 3: robusta).");
+	saidaSerial.println("custoFiltros: Mede o custo em ciclos de cada estágio de filtro e das cadeias pré-montadas.");
+	saidaSerial.println("telemetria: Seleciona a saída das medições (0: desligada, 1: texto, 2: quadros binários COBS) e exibe amostras, quadros e bytes enviados.");
+	saidaSerial.println("saida: Seleciona a política da telemetria na fila de saída (0: descartar antigas, 1: dizimar; opcional: fator) e exibe ocupação e descartes.");
+	saidaSerial.println("captura: Captura as bordas brutas em quadros compactos (0: parar, 1: armar até a próxima partida, 2: disparar agora; opcional: número de bordas).");
+	saidaSerial.println("memoria: Exibe a RAM estática ocupada por sensor e por cada um dos seus vetores.");
+	saidaSerial.println("limiar: Exibe a calibração do limiar (média e desvio dos tempos em alto e em baixo, erro relativo) e o filtro de nível; 1 reinicia a calibração.");
+	saidaSerial.println("ajustarDistanciaSensorOptico: Auxilia no ajuste da distância ideal entre o sensor óptico e o disco decodificador (opcional: relatórios por segundo).");
+	saidaSerial.println("lerRPM: Inicia a leitura e exibe a velocidade de rotação (RPM) do disco decodificador.");
+	saidaSerial.println("capturaInterrupcao: Ativa (1) ou desativa (0) a captura das bordas do sensor por interrupção e exibe as bordas perdidas.");
+	saidaSerial.println("ajuda: Exibe esta lista de comandos.");
+	saidaSerial.println("------------------"); 
   /* */
 }
 
 ComandoInfo tabelaComandos[] = { // Tabela de despacho que associa nomes de comandos a funções de tratamento.
   {"status", tratarStatus}, // Associa o comando "status" à função tratarStatus
-  {"ligarMotor", tratarLigarMotor}, // Associa o comando "ligarMotor" à função tratarLigarMotor
-  {"desligarMotor", tratarDesligarMotor}, // Associa o comando "desligarMotor" à função tratarDesligarMotor
-  {"sentidoGiro", tratarSentidoGiro}, // Associa o comando "sentidoGiro" à função tratarSentidoGiro
+  {"ligarMotor", [](Comando comando, sensorOpticoPro &sensor) { gerenciadorAtual->tratarLigarMotor(comando, sensor); }}, // Associa o comando "ligarMotor" ao método tratarLigarMotor
+  {"desligarMotor", [](Comando comando, sensorOpticoPro &sensor) { gerenciadorAtual->tratarDesligarMotor(comando, sensor); }}, // Associa o comando "desligarMotor" ao método tratarDesligarMotor
+  {"sentidoGiro", [](Comando comando, sensorOpticoPro &sensor) { gerenciadorAtual->tratarSentidoGiro(comando, sensor); }}, // Associa o comando "sentidoGiro" ao método tratarSentidoGiro
   {"lerRPM", tratarLerRPM}, // Associa o comando "lerRPM" à função tratarLerRPM
   {"configurarParametrosSensorOptico", tratarConfigurarParametrosSensorOptico}, // Associa o comando "configurarParametrosSensorOptico" à função tratarConfigurarParametrosSensorOptico
   {"rpmMaximo", tratarRpmMaximo}, // Associa o comando "rpmMaximo" à função tratarRpmMaximo
@@ -488,15 +1028,30 @@ ComandoInfo tabelaComandos[] = { // Tabela de despacho que associa nomes de coma
   {"fatorAjusteLimiar", tratarFatorAjusteLimiar}, // Associa o comando "fatorAjusteLimiar" à função tratarFatorAjusteLimiar
   {"numAmostrasLimiar", tratarNumAmostrasLimiar}, // Associa o comando "numAmostrasLimiar" à função tratarNumAmostrasLimiar
   {"numAmostrasDetecMov", tratarNumAmostrasDetecMov}, // Associa o comando "numAmostrasDetecMov" à função tratarNumAmostrasDetecMov
+  {"estimadorRPM", tratarEstimadorRPM}, // Associa o comando "estimadorRPM" à função tratarEstimadorRPM
+  {"filtroGlitch", tratarFiltroGlitch}, // Associa o comando "filtroGlitch" à função tratarFiltroGlitch
+  {"pulsos", tratarPulsos}, // Associa o comando "pulsos" à função tratarPulsos
+  {"geometria", tratarGeometria}, // Associa o comando "geometria" à função tratarGeometria
+  {"indice", tratarIndice}, // Associa o comando "indice" à função tratarIndice
+  {"rastreamento", tratarRastreamento}, // Associa o comando "rastreamento" à função tratarRastreamento
+  {"parada", tratarParada}, // Associa o comando "parada" à função tratarParada
+  {"filtro", tratarFiltro}, // Associa o comando "filtro" à função tratarFiltro
+  {"custoFiltros", tratarCustoFiltros}, // Associa o comando "custoFiltros" à função tratarCustoFiltros
+  {"telemetria", tratarTelemetria}, // Associa o comando "telemetria" à função tratarTelemetria
+  {"saida", tratarSaida}, // Associa o comando "saida" à função tratarSaida
+  {"captura", tratarCaptura}, // Associa o comando "captura" à função tratarCaptura
+  {"memoria", tratarMemoria}, // Associa o comando "memoria" à função tratarMemoria
+  {"limiar", tratarLimiar}, // Associa o comando "limiar" à função tratarLimiar
   {"ajustarSensor", tratarAjustarDistanciaSensorOptico}, // Associa o comando "ajustarDistanciaSensorOptico" à função tratarAjustarDistanciaSensorOptico
   {"pararAjuste", tratarPararAjusteDistanciaSensorOptico}, // Associa o comando "pararAjuste" à função tratarPararAjusteDistanciaSensorOptico
   {"lerRPM", tratarLerRPM}, // Associa o comando "lerRPM" à função tratarLerRPM
   {"pararLeituraRPM", tratarPararLeituraRpm}, // Associa o comando "pararLeituraRpm" à função tratarPararLeituraRpm
+  {"capturaInterrupcao", tratarCapturaInterrupcao}, // Associa o comando "capturaInterrupcao" à função tratarCapturaInterrupcao
   {"ajuda", tratarAjuda}, // Associa o comando "ajuda" à função tratarAjuda
   {nullptr, nullptr} // Marcador de fim da tabela (obrigatório)
 };
 
-Comando gerenciadorComando::analisarComando(String comandoRecebido) {
+Comando gerenciadorComandos::analisarComando(String comandoRecebido) {
   /*
    * Objetivo: Esta função analisa uma string de comando recebida, separando o nome do comando e seus valores numéricos.
    * Parâmetro: comandoRecebido - A string contendo o comando e seus valores. Ex: "piscarLed 10 200 300"
@@ -566,7 +1121,7 @@ void gerenciadorComandos::processarComando(Comando comando, sensorOpticoPro &sen
     }
   }
     // Se o loop terminar sem encontrar o comando:
-  Serial.print("O comando '"); // Imprime uma mensagem indicando que o comando é inválido.
-  Serial.println(comando.nome);       // Imprime o nome do comando que foi digitado incorretamente.
-  Serial.println("' não existe. Digite 'ajuda' para listar os comandos disponíveis.");
+  saidaSerial.print("O comando '"); // Imprime uma mensagem indicando que o comando é inválido.
+  saidaSerial.println(comando.nome);       // Imprime o nome do comando que foi digitado incorretamente.
+  saidaSerial.println("' não existe. Digite 'ajuda' para listar os comandos disponíveis.");
 }
@@ -119,10 +119,25 @@ public:
   void tratarFatorAjusteLimiar(Comando comando, sensorOpticoPro &sensor);
   void tratarNumAmostrasLimiar(Comando comando, sensorOpticoPro &sensor);
   void tratarNumAmostrasDetecMov(Comando comando, sensorOpticoPro &sensor);
+  void tratarEstimadorRPM(Comando comando, sensorOpticoPro &sensor);
+  void tratarFiltroGlitch(Comando comando, sensorOpticoPro &sensor);
+  void tratarPulsos(Comando comando, sensorOpticoPro &sensor);
+  void tratarGeometria(Comando comando, sensorOpticoPro &sensor);
+  void tratarIndice(Comando comando, sensorOpticoPro &sensor);
+  void tratarRastreamento(Comando comando, sensorOpticoPro &sensor);
+  void tratarParada(Comando comando, sensorOpticoPro &sensor);
+  void tratarFiltro(Comando comando, sensorOpticoPro &sensor);
+  void tratarCustoFiltros(Comando comando, sensorOpticoPro &sensor);
+  void tratarTelemetria(Comando comando, sensorOpticoPro &sensor);
+  void tratarSaida(Comando comando, sensorOpticoPro &sensor);
+  void tratarCaptura(Comando comando, sensorOpticoPro &sensor);
+  void tratarMemoria(Comando comando, sensorOpticoPro &sensor);
+  void tratarLimiar(Comando comando, sensorOpticoPro &sensor);
   void tratarAjustarDistanciaSensorOptico(Comando comando, sensorOpticoPro &sensor);
   void tratarPararAjusteDistanciaSensorOptico(Comando comando, sensorOpticoPro &sensor);
   void tratarLerRPM(Comando comando, sensorOpticoPro &sensor);
   void tratarPararLeituraRpm(Comando comando, sensorOpticoPro &sensor);
+  void tratarCapturaInterrupcao(Comando comando, sensorOpticoPro &sensor);
   void tratarAjuda(Comando comando, sensorOpticoPro &sensor);
 
 };
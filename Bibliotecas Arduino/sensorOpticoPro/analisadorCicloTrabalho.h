@@ -0,0 +1,149 @@
+/*
+ * analisadorCicloTrabalho.h
+ *
+ * Descrição: Analisador contínuo do ciclo de trabalho (duty cycle) do sinal do
+ * sensor óptico, usado no ajuste da distância entre o sensor e o disco
+ * decodificador. Cada tempo em nível alto ou baixo é somado e contado em um
+ * histograma de faixas fixas, com custo O(1) por borda e sem vetor de
+ * amostras. O relatório (ciclo de trabalho, tempos médios e pontuação da
+ * distância) é montado apenas quando solicitado, na taxa escolhida por quem
+ * publica.
+ *
+ * Histogramas: as faixas são logarítmicas (uma por potência de 2 do tempo em
+ * micros), então a mesma configuração serve de poucos RPM a dezenas de
+ * milhares de RPM. A faixa 0 reúne tudo abaixo de 2^DESLOCAMENTO_FAIXAS micros
+ * (glitches) e a última reúne os tempos acima do alcance.
+ *
+ * Pontuação da distância (0 a 100):
+ *   - Simetria: um disco com riscos e espaços iguais, bem alinhado, fica 50% do
+ *     tempo em cada nível. Perde 2 pontos por ponto percentual de desvio.
+ *   - Consistência: fração dos tempos que caem na faixa mais frequente ou na
+ *     maior vizinha (o pior entre alto e baixo). Um sinal no limite de detecção
+ *     oscila e espalha os tempos pelo histograma.
+ *   Pontuação = simetria * consistência / 100.
+ *
+ * Não depende do Arduino.h, podendo ser compilado e testado no Linux.
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef analisadorCicloTrabalho_h // Guarda de inclusão.
+#define analisadorCicloTrabalho_h
+
+#include <inttypes.h> // Tipos inteiros de tamanho fixo.
+
+#define ANALISADOR_NUM_FAIXAS 16        // Faixas por histograma (alto e baixo).
+#define ANALISADOR_DESLOCAMENTO_FAIXAS 4 // A faixa 0 vai até 2^4 = 16 micros; a faixa 15 começa em 2^18 micros (~0,26 s).
+
+class analisadorCicloTrabalho
+{
+  private:
+    uint16_t _histogramaAlto[ANALISADOR_NUM_FAIXAS];  // Quantidade de tempos em nível alto por faixa.
+    uint16_t _histogramaBaixo[ANALISADOR_NUM_FAIXAS]; // Quantidade de tempos em nível baixo por faixa.
+    unsigned long _somaAlto = 0;  // Soma dos tempos (micros) em nível alto.
+    unsigned long _somaBaixo = 0; // Soma dos tempos (micros) em nível baixo.
+    uint16_t _contagemAlto = 0;   // Tempos em nível alto registrados.
+    uint16_t _contagemBaixo = 0;  // Tempos em nível baixo registrados.
+    uint8_t _modaAlto = 0;        // Faixa mais frequente dos tempos em nível alto (mantida a cada registro).
+    uint8_t _modaBaixo = 0;       // Faixa mais frequente dos tempos em nível baixo.
+
+    // Índice da faixa: posição do bit mais significativo (log2 inteiro), deslocada e limitada ao histograma.
+    static uint8_t faixa(unsigned long duracao) {
+      if (duracao >> ANALISADOR_DESLOCAMENTO_FAIXAS == 0) {
+        return 0;
+      }
+      uint8_t bit = (uint8_t)(sizeof(unsigned long) * 8 - 1 - __builtin_clzl(duracao));
+      uint8_t indice = bit - ANALISADOR_DESLOCAMENTO_FAIXAS + 1;
+      return (indice < ANALISADOR_NUM_FAIXAS) ? indice : ANALISADOR_NUM_FAIXAS - 1;
+    }
+
+    // Porcentagem dos tempos na faixa 'moda' e na maior vizinha (um tempo estável perto do limite entre duas faixas se divide entre elas).
+    static uint8_t consistencia(const uint16_t* histograma, uint8_t moda, uint16_t contagem) {
+      if (contagem == 0) {
+        return 0;
+      }
+      uint16_t anterior = (moda > 0) ? histograma[moda - 1] : 0;
+      uint16_t seguinte = (moda + 1 < ANALISADOR_NUM_FAIXAS) ? histograma[moda + 1] : 0;
+      unsigned long proximos = (unsigned long)histograma[moda] + ((anterior > seguinte) ? anterior : seguinte);
+      return (uint8_t)(proximos * 100 / contagem);
+    }
+
+  public:
+    analisadorCicloTrabalho() {
+      zerar();
+    }
+
+    // Apaga os histogramas e as somas (início de uma nova janela de publicação).
+    void zerar() {
+      for (uint8_t i = 0; i < ANALISADOR_NUM_FAIXAS; i++) {
+        _histogramaAlto[i] = 0;
+        _histogramaBaixo[i] = 0;
+      }
+      _somaAlto = 0;
+      _somaBaixo = 0;
+      _contagemAlto = 0;
+      _contagemBaixo = 0;
+      _modaAlto = 0;
+      _modaBaixo = 0;
+    }
+
+    // Registra a duração de um nível que terminou. O(1): uma soma, um incremento e uma comparação.
+    void registrar(bool nivelAlto, unsigned long duracao) {
+      uint16_t* histograma = nivelAlto ? _histogramaAlto : _histogramaBaixo;
+      uint16_t& contagem = nivelAlto ? _contagemAlto : _contagemBaixo;
+      unsigned long& soma = nivelAlto ? _somaAlto : _somaBaixo;
+      uint8_t& moda = nivelAlto ? _modaAlto : _modaBaixo;
+
+      if (contagem == 0xFFFF || soma + duracao < soma) {
+        return; // Janela saturada: o restante é ignorado até a próxima publicação.
+      }
+      uint8_t indice = faixa(duracao);
+      histograma[indice]++;
+      if (histograma[indice] > histograma[moda]) {
+        moda = indice;
+      }
+      soma += duracao;
+      contagem++;
+    }
+
+    // Ciclo de trabalho em décimos de porcentagem (0 a 1000): tempo em alto / tempo total.
+    uint16_t lerCicloTrabalhoDecimos() const {
+      unsigned long alto = _somaAlto;
+      unsigned long total = _somaAlto + _somaBaixo;
+      if (total < _somaAlto || total == 0) { // Soma estourada ou vazia.
+        return (total == 0) ? 0 : 500;
+      }
+      while (total > 4000000UL) { // Mantém alto * 1000 dentro de 32 bits.
+        alto >>= 1;
+        total >>= 1;
+      }
+      return (uint16_t)(alto * 1000 / total);
+    }
+
+    // Pontuação da distância (0 a 100): simetria do ciclo de trabalho * consistência dos tempos.
+    uint8_t lerPontuacaoDistancia() const {
+      uint16_t ciclo = lerCicloTrabalhoDecimos();
+      uint16_t desvio = (ciclo > 500) ? ciclo - 500 : 500 - ciclo;  // Décimos de ponto percentual.
+      uint16_t simetria = (desvio >= 500) ? 0 : 100 - desvio / 5;     // 2 pontos por ponto percentual.
+      uint8_t consistenciaAlto = consistencia(_histogramaAlto, _modaAlto, _contagemAlto);
+      uint8_t consistenciaBaixo = consistencia(_histogramaBaixo, _modaBaixo, _contagemBaixo);
+      uint8_t consistenciaPior = (consistenciaAlto < consistenciaBaixo) ? consistenciaAlto : consistenciaBaixo;
+      return (uint8_t)(simetria * consistenciaPior / 100);
+    }
+
+    unsigned long lerMediaAlto() const { return (_contagemAlto == 0) ? 0 : _somaAlto / _contagemAlto; }     // Tempo médio em nível alto (micros).
+    unsigned long lerMediaBaixo() const { return (_contagemBaixo == 0) ? 0 : _somaBaixo / _contagemBaixo; } // Tempo médio em nível baixo (micros).
+    uint16_t lerContagemAlto() const { return _contagemAlto; }
+    uint16_t lerContagemBaixo() const { return _contagemBaixo; }
+    const uint16_t* lerHistogramaAlto() const { return _histogramaAlto; }
+    const uint16_t* lerHistogramaBaixo() const { return _histogramaBaixo; }
+
+    // Limite inferior (micros) de uma faixa do histograma.
+    static unsigned long inicioFaixa(uint8_t indice) {
+      return (indice == 0) ? 0 : 1UL << (indice + ANALISADOR_DESLOCAMENTO_FAIXAS - 1);
+    }
+};
+
+#endif // analisadorCicloTrabalho_h
@@ -0,0 +1,150 @@
+/*
+ * arenaMemoria.h
+ *
+ * Descrição: Arena de memória com capacidade fixada na compilação, dividida
+ * em execução entre os vetores que só existem em alguns modos do sensor
+ * óptico (a janela do estimador de uma volta, os quadros da captura de
+ * bordas). Um vetor que ficasse dentro do objeto ocuparia a RAM mesmo com o
+ * modo desligado; reservado na arena, ele só ocupa espaço enquanto o modo
+ * está em uso, e o mesmo espaço serve a outro modo depois.
+ *
+ * As janelas de amostras da calibração do limiar e da detecção de movimento
+ * não passam pela arena: a calibração é incremental (estatisticaWelford, sem
+ * vetor de amostras) e o histórico da detecção é um vetor de bits de
+ * capacidade fixa no próprio objeto (historicoBits), redimensionado em
+ * execução dentro dessa capacidade.
+ *
+ * Funcionamento:
+ *   - reservar() procura o primeiro espaço livre que comporte o bloco
+ *     (alinhado para unsigned long) e retorna nullptr se não houver espaço ou
+ *     se os ARENA_MEMORIA_MAX_BLOCOS blocos já estiverem em uso: quem reserva
+ *     decide o que fazer sem a memória (o estimador de uma volta volta ao M/T,
+ *     a captura não é armada). Nunca usa o heap.
+ *   - liberar() devolve um bloco; ponteiros que não vieram da arena são
+ *     recusados.
+ *   - emUso(), usoMaximo() e recusas() alimentam o relatório de memória.
+ *
+ * arenaMemoriaFixa<Tamanho> contém os bytes da arena; as funções ficam na
+ * classe base, sem depender do tamanho, para que os usuários recebam apenas
+ * arenaMemoria&.
+ *
+ * Memória: Tamanho + 4 bytes por bloco + 10 bytes de controle.
+ *
+ * Não depende do Arduino.h, podendo ser compilada e testada no Linux.
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef arenaMemoria_h // Guarda de inclusão.
+#define arenaMemoria_h
+
+#include <inttypes.h> // Tipos inteiros de tamanho fixo.
+
+#ifndef ARENA_MEMORIA_MAX_BLOCOS
+#define ARENA_MEMORIA_MAX_BLOCOS 4 // Blocos reservados ao mesmo tempo (janela de uma volta de cada sensor e a captura).
+#endif
+
+class arenaMemoria
+{
+  private:
+    static const uint8_t ALINHAMENTO = alignof(unsigned long); // 1 no AVR: nenhum byte perdido no alinhamento.
+
+    struct Bloco {
+      uint16_t inicio;
+      uint16_t tamanho; // 0: posição livre.
+    };
+
+    uint8_t* _memoria;
+    uint16_t _capacidade;
+    Bloco _blocos[ARENA_MEMORIA_MAX_BLOCOS] = {};
+    uint16_t _emUso = 0;
+    uint16_t _usoMaximo = 0;
+    uint16_t _recusas = 0;
+
+    // Verifica se [inicio, inicio + tamanho) não se sobrepõe a nenhum bloco reservado.
+    bool livre(uint16_t inicio, uint16_t tamanho) const {
+      for (uint8_t i = 0; i < ARENA_MEMORIA_MAX_BLOCOS; i++) {
+        const Bloco& bloco = _blocos[i];
+        if (bloco.tamanho != 0 && inicio < bloco.inicio + bloco.tamanho && bloco.inicio < inicio + tamanho) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+  protected:
+    arenaMemoria(uint8_t* memoria, uint16_t capacidade) : _memoria(memoria), _capacidade(capacidade) {}
+
+  public:
+    // Reserva 'bytes' bytes. Retorna nullptr se não houver espaço contíguo ou posição de bloco livre.
+    void* reservar(uint16_t bytes) {
+      if (bytes == 0) {
+        return nullptr;
+      }
+      uint16_t tamanho = (uint16_t)((bytes + ALINHAMENTO - 1) / ALINHAMENTO * ALINHAMENTO);
+      int8_t posicao = -1;
+      for (uint8_t i = 0; i < ARENA_MEMORIA_MAX_BLOCOS && posicao < 0; i++) {
+        if (_blocos[i].tamanho == 0) {
+          posicao = i;
+        }
+      }
+      // Candidatos: o começo da arena e o fim de cada bloco reservado (primeiro espaço que couber).
+      for (int8_t candidato = -1; posicao >= 0 && candidato < ARENA_MEMORIA_MAX_BLOCOS; candidato++) {
+        uint16_t inicio = 0;
+        if (candidato >= 0) {
+          if (_blocos[candidato].tamanho == 0) {
+            continue;
+          }
+          inicio = _blocos[candidato].inicio + _blocos[candidato].tamanho;
+        }
+        if (tamanho <= _capacidade && inicio <= _capacidade - tamanho && livre(inicio, tamanho)) {
+          _blocos[posicao].inicio = inicio;
+          _blocos[posicao].tamanho = tamanho;
+          _emUso += tamanho;
+          if (_emUso > _usoMaximo) {
+            _usoMaximo = _emUso;
+          }
+          return _memoria + inicio;
+        }
+      }
+      _recusas++;
+      return nullptr;
+    }
+
+    // Devolve um bloco reservado. Retorna false (sem alterar nada) se o ponteiro não for o início de um bloco da arena.
+    bool liberar(const void* ponteiro) {
+      for (uint8_t i = 0; i < ARENA_MEMORIA_MAX_BLOCOS; i++) {
+        Bloco& bloco = _blocos[i];
+        if (bloco.tamanho != 0 && ponteiro == _memoria + bloco.inicio) {
+          _emUso -= bloco.tamanho;
+          bloco.tamanho = 0;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    uint16_t capacidade() const { return _capacidade; }
+    uint16_t emUso() const { return _emUso; }         // Bytes reservados agora (com o alinhamento).
+    uint16_t usoMaximo() const { return _usoMaximo; } // Maior ocupação desde o início.
+    uint16_t recusas() const { return _recusas; }     // Reservas recusadas por falta de espaço.
+};
+
+template <uint16_t Tamanho>
+class arenaMemoriaFixa : public arenaMemoria
+{
+  static_assert(Tamanho >= 1, "A arena deve ter pelo menos um byte.");
+
+  private:
+    union {
+      uint8_t _bytes[Tamanho];
+      unsigned long _alinhamento; // Alinha o início da arena para os blocos de unsigned long.
+    };
+
+  public:
+    arenaMemoriaFixa() : arenaMemoria(_bytes, Tamanho) {}
+};
+
+#endif // arenaMemoria_h
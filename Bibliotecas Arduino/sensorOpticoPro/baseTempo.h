@@ -0,0 +1,88 @@
+/*
+ * baseTempo.h
+ *
+ * Descrição: Base de tempo de 64 bits para o sensorOpticoPro. O micros() do
+ * Arduino é um contador de 32 bits que dá a volta a cada ~71,6 minutos; a base
+ * de tempo estende esse contador para 64 bits (~584 mil anos) contando as
+ * voltas: a cada leitura, um valor menor que o anterior indica que o contador
+ * passou por zero. O custo é uma comparação por leitura, e a única condição é
+ * que a base seja lida pelo menos uma vez a cada volta do contador (o
+ * calcularRPM() chamado no loop() garante isso).
+ *
+ * A fonte do contador é um ponteiro para função, injetado no construtor ou em
+ * configurarFonte(): micros() no Arduino, ou um relógio simulado nos testes e
+ * bancadas (lerRelogioSimulado), que pode começar perto da volta do contador.
+ *
+ * Carimbos de 32 bits capturados antes (na interrupção, por exemplo) são
+ * estendidos em relação à última leitura com estender(), válido enquanto o
+ * carimbo estiver a menos de meia volta (~35 minutos) dessa leitura.
+ * Intervalos curtos continuam em 32 bits: a diferença sem sinal entre dois
+ * carimbos é correta mesmo que o contador tenha dado a volta entre eles.
+ *
+ * Não depende do Arduino.h, podendo ser compilada e testada no Linux.
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef baseTempo_h // Guarda de inclusão.
+#define baseTempo_h
+
+#include <inttypes.h> // Tipos inteiros de tamanho fixo.
+
+typedef unsigned long (*FonteTempo)(); // Contador livre de 32 bits em micros (assinatura do micros()).
+
+// Relógio simulado: a fonte devolve o valor que o teste escreve em relogioSimulado().
+inline unsigned long& relogioSimulado() {
+  static unsigned long valor = 0;
+  return valor;
+}
+
+inline unsigned long lerRelogioSimulado() {
+  return (uint32_t)relogioSimulado(); // O contador tem 32 bits mesmo onde unsigned long tem 64 (Linux).
+}
+
+class baseTempo
+{
+  private:
+    FonteTempo _fonte;               // Contador de 32 bits.
+    uint32_t _ultimaLeitura = 0;      // Última leitura do contador (32 bits baixos do instante).
+    unsigned long _voltas = 0;        // Voltas do contador desde a configuração da fonte (32 bits altos).
+
+  public:
+    explicit baseTempo(FonteTempo fonte) : _fonte(fonte) {}
+
+    // Troca a fonte do contador. A contagem de voltas recomeça a partir da leitura atual.
+    void configurarFonte(FonteTempo fonte) {
+      _fonte = fonte;
+      _ultimaLeitura = (uint32_t)fonte();
+      _voltas = 0;
+    }
+
+    // Instante atual em micros, 64 bits.
+    uint64_t lerMicros() {
+      uint32_t leitura = (uint32_t)_fonte();
+      if (leitura < _ultimaLeitura) {
+        _voltas++; // O contador passou por zero desde a última leitura.
+      }
+      _ultimaLeitura = leitura;
+      return ((uint64_t)_voltas << 32) | leitura;
+    }
+
+    // Leitura de 32 bits do contador, sem atualizar a extensão (rotinas de interrupção e intervalos curtos).
+    unsigned long lerContador() const {
+      return _fonte();
+    }
+
+    // Estende um carimbo de 32 bits a até meia volta (antes ou depois) da última leitura.
+    uint64_t estender(unsigned long instante) const {
+      uint64_t referencia = ((uint64_t)_voltas << 32) | _ultimaLeitura;
+      return referencia + (int64_t)(int32_t)((uint32_t)instante - _ultimaLeitura);
+    }
+
+    unsigned long lerVoltas() const { return _voltas; } // Voltas do contador de 32 bits (diagnóstico).
+    FonteTempo lerFonte() const { return _fonte; }
+};
+
+#endif // baseTempo_h
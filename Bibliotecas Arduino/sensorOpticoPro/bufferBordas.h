@@ -0,0 +1,124 @@
+/*
+ * bufferBordas.h
+ *
+ * Descrição: Fila circular de tamanho fixo, sem travas (lock-free), para um
+ * único produtor e um único consumidor (SPSC). Foi criada para transportar
+ * as bordas do sensor óptico da rotina de interrupção (produtor) até o
+ * calcularRPM() executado no loop() (consumidor), de forma que nenhuma borda
+ * seja perdida enquanto o loop está ocupado (Serial, comandos, etc.).
+ *
+ * Funcionamento:
+ *   - O produtor escreve apenas em '_cabeca' e o consumidor apenas em '_cauda'.
+ *     Como os índices são de 8 bits, a leitura/escrita é atômica no AVR e não
+ *     é preciso desabilitar interrupções para inserir ou retirar registros.
+ *   - A capacidade deve ser potência de 2 (máscara no lugar do operador %).
+ *     Uma posição fica sempre livre para diferenciar fila cheia de vazia.
+ *   - Quando a fila está cheia, o registro novo é descartado e o contador de
+ *     transbordos é incrementado (o consumidor decide o que fazer com isso).
+ *
+ * Não depende do Arduino.h, podendo ser compilada e testada no Linux com o
+ * produtor alimentado por uma fonte de bordas simulada.
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef bufferBordas_h // Guarda de inclusão.
+#define bufferBordas_h
+
+#include <inttypes.h> // Tipos inteiros de tamanho fixo.
+
+#if defined(__AVR__)
+  #include <util/atomic.h> // ATOMIC_BLOCK para ler contadores de 16 bits sem ser interrompido.
+  #define BUFFER_BORDAS_BARREIRA() __asm__ __volatile__("" ::: "memory") // Núcleo único: basta impedir o compilador de reordenar.
+  #define BUFFER_BORDAS_SECAO_CRITICA ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#else
+  #define BUFFER_BORDAS_BARREIRA() __sync_synchronize() // Barreira completa para ARM/x86 (produtor em outra thread no Linux).
+  #define BUFFER_BORDAS_SECAO_CRITICA
+#endif
+
+// Registro de uma borda capturada: instante em microssegundos e nível lógico após a transição.
+struct RegistroBorda {
+  unsigned long instante; // Valor de micros() no momento da borda.
+  uint8_t nivel;          // HIGH (1) para borda de subida, LOW (0) para borda de descida.
+};
+
+template <typename T, uint8_t Capacidade>
+class bufferCircularSPSC
+{
+  static_assert(Capacidade >= 2 && Capacidade <= 128 && (Capacidade & (Capacidade - 1)) == 0,
+                "A capacidade da fila deve ser potencia de 2 entre 2 e 128.");
+
+  private:
+    static const uint8_t MASCARA = Capacidade - 1; // Substitui o operador % no avanço dos índices.
+
+    T _registros[Capacidade];           // Armazenamento fixo (sem alocação dinâmica).
+    volatile uint8_t _cabeca = 0;       // Próxima posição de escrita (somente o produtor altera).
+    volatile uint8_t _cauda = 0;        // Próxima posição de leitura (somente o consumidor altera).
+    volatile uint16_t _transbordos = 0; // Registros descartados por fila cheia (somente o produtor altera).
+    uint8_t _ocupacaoMaxima = 0;        // Maior ocupação observada pelo consumidor (nível de alerta da fila).
+
+  public:
+    // Lado do produtor (rotina de interrupção ou fonte simulada). Retorna false se a fila estava cheia.
+    bool inserir(const T& registro) {
+      uint8_t cabeca = _cabeca;
+      uint8_t proxima = (cabeca + 1) & MASCARA;
+      if (proxima == _cauda) { // Fila cheia: descarta o registro novo e contabiliza o transbordo.
+        _transbordos = _transbordos + 1;
+        return false;
+      }
+      _registros[cabeca] = registro;
+      BUFFER_BORDAS_BARREIRA(); // Garante que o registro esteja escrito antes de publicar a nova cabeça.
+      _cabeca = proxima;
+      return true;
+    }
+
+    // Lado do consumidor. Copia até 'maximo' registros para 'destino' e retorna quantos foram retirados.
+    uint8_t retirarLote(T* destino, uint8_t maximo) {
+      uint8_t cauda = _cauda;
+      uint8_t cabeca = _cabeca;
+      BUFFER_BORDAS_BARREIRA(); // Lê a cabeça antes dos registros que ela publica.
+
+      uint8_t ocupacao = (cabeca - cauda) & MASCARA;
+      if (ocupacao > _ocupacaoMaxima) {
+        _ocupacaoMaxima = ocupacao;
+      }
+
+      uint8_t retirados = 0;
+      while (cauda != cabeca && retirados < maximo) {
+        destino[retirados++] = _registros[cauda];
+        cauda = (cauda + 1) & MASCARA;
+      }
+      BUFFER_BORDAS_BARREIRA(); // Termina a cópia antes de liberar as posições para o produtor.
+      _cauda = cauda;
+      return retirados;
+    }
+
+    // Descarta todo o conteúdo pendente (lado do consumidor).
+    void esvaziar() {
+      _cauda = _cabeca;
+    }
+
+    // Zera os contadores de diagnóstico.
+    void zerarContadores() {
+      BUFFER_BORDAS_SECAO_CRITICA {
+        _transbordos = 0;
+      }
+      _ocupacaoMaxima = 0;
+    }
+
+    uint8_t ocupacao() const { return (uint8_t)(_cabeca - _cauda) & MASCARA; } // Registros aguardando o consumidor.
+    uint8_t lerOcupacaoMaxima() const { return _ocupacaoMaxima; }             // Maior ocupação já observada.
+    static uint8_t capacidadeUtil() { return Capacidade - 1; }                 // Uma posição fica sempre livre.
+
+    uint16_t lerTransbordos() const { // Leitura protegida: no AVR um valor de 16 bits exige duas instruções.
+      uint16_t transbordos;
+      BUFFER_BORDAS_SECAO_CRITICA {
+        transbordos = _transbordos;
+      }
+      return transbordos;
+    }
+};
+
+#endif // bufferBordas_h
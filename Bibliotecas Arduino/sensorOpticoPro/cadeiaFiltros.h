@@ -0,0 +1,224 @@
+/*
+ * cadeiaFiltros.h
+ *
+ * Descrição: Estágios de filtro para os sinais do sensorOpticoPro (intervalo
+ * entre bordas em micros ou RPM em float) e uma cadeia que os compõe na
+ * compilação. A cadeia é um template variádico: cada estágio é um membro e
+ * filtrar() chama os estágios em sequência, sem funções virtuais nem
+ * ponteiros para função, de modo que o compilador pode expandir tudo em
+ * linha. O custo da cadeia é a soma do custo dos estágios.
+ *
+ * Estágios (T = unsigned long ou float):
+ *   - filtroMediana<T, K>: mediana das últimas K amostras (K = 3 ou 5) por
+ *     rede de ordenação (3 ou 7 comparações), O(K). Remove picos isolados.
+ *   - filtroMediaExponencial<T, D>: y += (x - y) / 2^D, O(1).
+ *   - filtroMediaMovel<T, N>: média das últimas N amostras com soma
+ *     incremental, O(1).
+ *   - filtroLimitadorTaxa<T, D>: limita a variação entre amostras a
+ *     1/2^D do valor anterior, O(1). Segura um degrau espúrio sem atrasar
+ *     mudanças graduais.
+ *
+ * Utilização:
+ *   cadeiaFiltros<unsigned long, filtroMediana<unsigned long, 3>, filtroMediaExponencial<unsigned long, 2> > cadeia;
+ *   unsigned long intervaloFiltrado = cadeia.filtrar(intervalo);
+ *
+ * Não depende do Arduino.h, podendo ser compilado e testado no Linux.
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef cadeiaFiltros_h // Guarda de inclusão.
+#define cadeiaFiltros_h
+
+#include <inttypes.h> // Tipos inteiros de tamanho fixo.
+
+// Troca a e b se estiverem fora de ordem (elemento da rede de ordenação).
+template <typename T>
+inline void compararTrocar(T& a, T& b) {
+  if (b < a) {
+    T temporario = a;
+    a = b;
+    b = temporario;
+  }
+}
+
+// Redes de ordenação parciais: deixam a mediana na posição central do vetor.
+template <typename T, uint8_t K> struct redeMediana;
+
+template <typename T> struct redeMediana<T, 3> {
+  static T mediana(T v[3]) {
+    compararTrocar(v[0], v[1]);
+    compararTrocar(v[1], v[2]);
+    compararTrocar(v[0], v[1]);
+    return v[1];
+  }
+};
+
+template <typename T> struct redeMediana<T, 5> {
+  static T mediana(T v[5]) { // 7 comparações (rede mínima para a mediana de 5).
+    compararTrocar(v[0], v[1]);
+    compararTrocar(v[3], v[4]);
+    compararTrocar(v[0], v[3]);
+    compararTrocar(v[1], v[4]);
+    compararTrocar(v[1], v[2]);
+    compararTrocar(v[2], v[3]);
+    compararTrocar(v[1], v[2]);
+    return v[2];
+  }
+};
+
+template <typename T, uint8_t K>
+class filtroMediana
+{
+  static_assert(K == 3 || K == 5, "A mediana usa redes de ordenacao de 3 ou 5 amostras.");
+
+  private:
+    T _janela[K];          // Últimas K amostras (circular).
+    uint8_t _posicao = 0;  // Próxima posição de escrita.
+    uint8_t _amostras = 0; // Amostras recebidas (até K).
+
+  public:
+    void zerar() {
+      _posicao = 0;
+      _amostras = 0;
+    }
+
+    T filtrar(T x) {
+      _janela[_posicao] = x;
+      _posicao = (_posicao + 1 < K) ? _posicao + 1 : 0;
+      if (_amostras < K) {
+        _amostras++;
+        return x; // Janela incompleta: passa a amostra adiante.
+      }
+      T copia[K];
+      for (uint8_t i = 0; i < K; i++) {
+        copia[i] = _janela[i];
+      }
+      return redeMediana<T, K>::mediana(copia);
+    }
+};
+
+template <typename T, uint8_t D>
+class filtroMediaExponencial
+{
+  private:
+    T _valor = 0;
+    bool _iniciado = false;
+
+  public:
+    void zerar() {
+      _iniciado = false;
+    }
+
+    T filtrar(T x) {
+      if (!_iniciado) {
+        _valor = x;
+        _iniciado = true;
+        return x;
+      }
+      // Diferença sempre positiva: funciona com tipos sem sinal (a divisão por 2^D vira deslocamento nos inteiros).
+      if (x > _valor) {
+        _valor += (x - _valor) / (T)(1UL << D);
+      } else {
+        _valor -= (_valor - x) / (T)(1UL << D);
+      }
+      return _valor;
+    }
+};
+
+template <typename T, uint8_t N>
+class filtroMediaMovel
+{
+  static_assert(N >= 1, "A media movel precisa de pelo menos uma amostra.");
+
+  private:
+    T _janela[N];          // Últimas N amostras (circular).
+    T _soma = 0;           // Soma das amostras da janela.
+    uint8_t _posicao = 0;  // Próxima posição de escrita.
+    uint8_t _amostras = 0; // Amostras na janela (até N).
+
+  public:
+    void zerar() {
+      _soma = 0;
+      _posicao = 0;
+      _amostras = 0;
+    }
+
+    T filtrar(T x) {
+      if (_amostras < N) {
+        _amostras++;
+      } else {
+        _soma -= _janela[_posicao]; // Sai a amostra mais antiga.
+      }
+      _janela[_posicao] = x;
+      _soma += x;
+      _posicao = (_posicao + 1 < N) ? _posicao + 1 : 0;
+      return _soma / (T)_amostras;
+    }
+};
+
+template <typename T, uint8_t D>
+class filtroLimitadorTaxa
+{
+  private:
+    T _valor = 0;
+    bool _iniciado = false;
+
+  public:
+    void zerar() {
+      _iniciado = false;
+    }
+
+    T filtrar(T x) {
+      if (!_iniciado) {
+        _valor = x;
+        _iniciado = true;
+        return x;
+      }
+      T limite = _valor / (T)(1UL << D); // Maior variação aceita por amostra.
+      if (x > _valor + limite) {
+        _valor += limite;
+      } else if (x + limite < _valor) {
+        _valor -= limite;
+      } else {
+        _valor = x;
+      }
+      return _valor;
+    }
+};
+
+// Cadeia de estágios composta na compilação: filtrar(x) = ultimo(...(segundo(primeiro(x)))).
+template <typename T, typename... Estagios> class cadeiaFiltros;
+
+template <typename T>
+class cadeiaFiltros<T>
+{
+  public:
+    static const uint8_t NUM_ESTAGIOS = 0;
+    void zerar() {}
+    T filtrar(T x) { return x; }
+};
+
+template <typename T, typename Primeiro, typename... Resto>
+class cadeiaFiltros<T, Primeiro, Resto...>
+{
+  private:
+    Primeiro _estagio;                // Primeiro estágio da cadeia.
+    cadeiaFiltros<T, Resto...> _resto; // Demais estágios.
+
+  public:
+    static const uint8_t NUM_ESTAGIOS = 1 + sizeof...(Resto);
+
+    void zerar() {
+      _estagio.zerar();
+      _resto.zerar();
+    }
+
+    T filtrar(T x) {
+      return _resto.filtrar(_estagio.filtrar(x));
+    }
+};
+
+#endif // cadeiaFiltros_h
@@ -0,0 +1,309 @@
+/*
+ * capturaBordas.h
+ *
+ * Descrição: Captura das bordas brutas do sensor óptico para análise fora da
+ * placa. Enquanto a captura está ativa, cada borda processada pelo
+ * calcularRPM() vira um registro compacto:
+ *
+ *   registro = varint((instante - instante anterior) << 1 | nível)
+ *
+ * O nível é 1 na borda de subida e 0 na de descida. Intervalos de até 63 µs
+ * ocupam 1 byte e até 8191 µs ocupam 2 bytes: a 20 mil bordas por segundo
+ * (50 µs entre bordas) a captura gera ~1,4 bytes por borda com o quadro, 28%
+ * da Serial a 1 Mbaud.
+ *
+ * Os registros são agrupados em quadros QUADRO_CAPTURA, fechados com o mesmo
+ * CRC e COBS da telemetria binária (telemetriaBinaria.h):
+ *
+ *   tipo, sequência (1 byte), perdidas (varint), referência (varint), registros...
+ *
+ * 'referência' é o instante (micros de 32 bits) a partir do qual o primeiro
+ * registro conta; 'perdidas' são as bordas descartadas antes do quadro por
+ * falta de espaço na placa. Cada quadro é decodificado sozinho. Os quadros
+ * saem entre dois 0x00 (um antes e o terminador), então texto das respostas
+ * entre dois quadros não corrompe nenhum deles.
+ *
+ * Os quadros são montados no próprio vetor de saída: NumQuadros vetores de
+ * TamanhoQuadro bytes formam uma fila circular de quadros prontos, reservada
+ * na arena (arenaMemoria.h) por armar() e devolvida por atender() depois que a
+ * captura para e o último quadro sai: parada, a captura não ocupa a memória
+ * dos quadros, que serve à janela do estimador de uma volta. atender()
+ * entrega os prontos à saída enquanto ela aceitar (uma saída que nunca
+ * descarta, como filaSaida::tentarEnviarMensagem()); com a fila cheia, as
+ * bordas novas são contadas como perdidas e o quadro seguinte recomeça com
+ * referência própria. Rajadas acima da taxa da Serial ficam guardadas até
+ * NumQuadros quadros.
+ *
+ * Disparo: armar() deixa a captura esperando; disparar() (comando) ou
+ * sinalizarPartida() (primeira borda depois de uma parada) começam a gravação
+ * pela última borda vista enquanto armada. Com um limite de bordas, a captura
+ * para sozinha ao atingi-lo.
+ *
+ * Memória: NumQuadros + 45 bytes no objeto; NumQuadros * TamanhoQuadro bytes
+ * na arena enquanto a captura estiver armada, ativa ou com quadros a enviar.
+ *
+ * Não depende do Arduino.h, podendo ser compilada e testada no Linux.
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef capturaBordas_h // Guarda de inclusão.
+#define capturaBordas_h
+
+#include <inttypes.h>          // Tipos inteiros de tamanho fixo.
+#include "telemetriaBinaria.h" // CRC, COBS e o tipo QUADRO_CAPTURA.
+#include "arenaMemoria.h"      // Memória dos quadros, reservada só enquanto a captura está em uso.
+
+typedef bool (*EnvioCaptura)(const uint8_t* quadro, uint8_t tamanho); // Entrega um quadro; false se a saída não tiver espaço agora.
+
+// Situação da captura.
+enum EstadoCaptura : uint8_t {
+  CAPTURA_PARADA = 0, // Nenhuma borda é registrada.
+  CAPTURA_ARMADA = 1, // Esperando o disparo (comando ou partida do disco).
+  CAPTURA_ATIVA = 2   // Registrando cada borda.
+};
+
+// Cabeçalho de um quadro de captura decodificado.
+struct CabecalhoCaptura {
+  uint8_t sequencia;   // Número do quadro (volta a 0 depois de 255): lacunas indicam quadros perdidos no caminho.
+  uint32_t perdidas;   // Bordas descartadas na placa antes deste quadro.
+  uint32_t referencia; // Instante (micros de 32 bits) somado ao primeiro registro.
+  uint8_t posicao;     // Posição do primeiro registro no conteúdo.
+};
+
+template <uint8_t TamanhoQuadro, uint8_t NumQuadros>
+class capturaBordas
+{
+  static_assert(TamanhoQuadro >= 32 && TamanhoQuadro <= 254, "O quadro de captura deve ter entre 32 e 254 bytes.");
+  static_assert(NumQuadros >= 2, "A captura precisa de pelo menos dois quadros (um em montagem e um em envio).");
+
+  private:
+    static const uint8_t MAX_REGISTRO = 5; // Varint de 32 bits.
+    static const uint8_t RODAPE = 3;       // CRC (2 bytes) e o terminador 0x00.
+
+    uint8_t (*_quadros)[TamanhoQuadro] = nullptr; // Na arena (nullptr: parada e sem quadros). Posição 0: 0x00 separador; posição 1: primeiro código COBS.
+    uint8_t _tamanhos[NumQuadros];               // Bytes de cada quadro pronto.
+    arenaMemoria& _arena;
+    EnvioCaptura _envio;
+    uint8_t _primeiro = 0;          // Quadro pronto mais antigo.
+    uint8_t _prontos = 0;           // Quadros prontos aguardando a saída (o quadro em montagem vem logo depois).
+    uint8_t _tamanhoMontagem = 0;   // Bytes do quadro em montagem (0: nenhum).
+    uint8_t _sequencia = 0;
+    EstadoCaptura _estado = CAPTURA_PARADA;
+    uint8_t _ultimoNivel = 0;       // Última borda vista enquanto armada (início da gravação no disparo).
+    bool _temUltima = false;
+    uint32_t _ultimoInstante = 0;   // Instante da borda anterior (ou a referência do quadro).
+    uint32_t _perdidasQuadro = 0;   // Bordas perdidas desde o último quadro aberto.
+    unsigned long _limite = 0;      // Bordas a capturar (0: até parar()).
+    unsigned long _capturadas = 0;
+    unsigned long _perdidas = 0;
+    unsigned long _bytesEnviados = 0;
+    unsigned long _quadrosEnviados = 0;
+
+    uint8_t* quadroMontagem() {
+      uint8_t posicao = _primeiro + _prontos;
+      return _quadros[posicao >= NumQuadros ? posicao - NumQuadros : posicao];
+    }
+
+    void escreverVarint(uint8_t* quadro, uint32_t valor) {
+      while (valor >= 0x80) {
+        quadro[_tamanhoMontagem++] = (uint8_t)valor | 0x80;
+        valor >>= 7;
+      }
+      quadro[_tamanhoMontagem++] = (uint8_t)valor;
+    }
+
+    // Abre um quadro com a referência dada. Retorna false se todos os quadros estiverem aguardando a saída.
+    bool abrirQuadro(uint32_t referencia) {
+      if (_prontos >= NumQuadros) {
+        return false;
+      }
+      uint8_t* quadro = quadroMontagem();
+      quadro[0] = 0x00; // Separa o quadro de qualquer texto transmitido antes dele.
+      _tamanhoMontagem = 2; // Posição 1: primeiro código COBS.
+      quadro[_tamanhoMontagem++] = QUADRO_CAPTURA;
+      quadro[_tamanhoMontagem++] = _sequencia++;
+      escreverVarint(quadro, _perdidasQuadro);
+      escreverVarint(quadro, referencia);
+      _perdidasQuadro = 0;
+      _ultimoInstante = referencia;
+      return true;
+    }
+
+    void fecharQuadro() {
+      uint8_t posicao = _primeiro + _prontos;
+      if (posicao >= NumQuadros) {
+        posicao -= NumQuadros;
+      }
+      _tamanhos[posicao] = 1 + enquadrarTelemetria(&_quadros[posicao][1], _tamanhoMontagem - 1);
+      _prontos++;
+      _tamanhoMontagem = 0;
+    }
+
+    void gravar(uint32_t instante, uint8_t nivel) {
+      if (_tamanhoMontagem == 0 && !abrirQuadro(instante)) {
+        _perdidas++;
+        _perdidasQuadro++;
+        return;
+      }
+      uint32_t delta = instante - _ultimoInstante;
+      if (delta >= 0x80000000UL) { // Mais de meia volta do micros() sem bordas: recomeça com referência própria.
+        fecharQuadro();
+        if (!abrirQuadro(instante)) {
+          _perdidas++;
+          _perdidasQuadro++;
+          return;
+        }
+        delta = 0;
+      }
+      escreverVarint(quadroMontagem(), (delta << 1) | (nivel ? 1 : 0));
+      _ultimoInstante = instante;
+      _capturadas++;
+      if (_tamanhoMontagem + MAX_REGISTRO + RODAPE > TamanhoQuadro) {
+        fecharQuadro();
+      }
+      if (_limite != 0 && _capturadas >= _limite) {
+        parar();
+      }
+    }
+
+  public:
+    capturaBordas(arenaMemoria& arena, EnvioCaptura envio) : _arena(arena), _envio(envio) {}
+
+    ~capturaBordas() {
+      _arena.liberar(_quadros);
+    }
+
+    // Registra uma borda (instante em micros de 32 bits e nível após a transição). Parada, não faz nada.
+    void registrar(unsigned long instante, uint8_t nivel) {
+      if (_estado == CAPTURA_ATIVA) {
+        gravar((uint32_t)instante, nivel);
+      } else if (_estado == CAPTURA_ARMADA) {
+        _ultimoInstante = (uint32_t)instante;
+        _ultimoNivel = nivel;
+        _temUltima = true;
+      }
+    }
+
+    // Entrega os quadros prontos à saída, enquanto ela aceitar; parada e sem quadros a enviar, devolve os quadros à
+    // arena. Chamar a cada passagem do loop().
+    void atender() {
+      while (_prontos > 0 && _envio(_quadros[_primeiro], _tamanhos[_primeiro])) {
+        _bytesEnviados += _tamanhos[_primeiro];
+        _quadrosEnviados++;
+        if (++_primeiro >= NumQuadros) {
+          _primeiro = 0;
+        }
+        _prontos--;
+      }
+      if (_estado == CAPTURA_PARADA && _prontos == 0 && _tamanhoMontagem == 0 && _quadros != nullptr) {
+        _arena.liberar(_quadros);
+        _quadros = nullptr;
+      }
+    }
+
+    // Arma a captura de 'limite' bordas (0: sem limite). Descarta o que ainda não foi enviado e zera os contadores.
+    // Retorna false, sem alterar nada, se a arena não tiver espaço para os quadros.
+    bool armar(unsigned long limite) {
+      if (_quadros == nullptr) {
+        _quadros = static_cast<uint8_t (*)[TamanhoQuadro]>(_arena.reservar((uint16_t)NumQuadros * TamanhoQuadro));
+        if (_quadros == nullptr) {
+          return false;
+        }
+      }
+      _estado = CAPTURA_ARMADA;
+      _limite = limite;
+      _temUltima = false;
+      _prontos = 0;
+      _tamanhoMontagem = 0;
+      _sequencia = 0;
+      _perdidasQuadro = 0;
+      _capturadas = 0;
+      _perdidas = 0;
+      _bytesEnviados = 0;
+      _quadrosEnviados = 0;
+      return true;
+    }
+
+    // Começa a gravar a partir da última borda vista enquanto armada. Retorna false se não estiver armada.
+    bool disparar() {
+      if (_estado != CAPTURA_ARMADA) {
+        return false;
+      }
+      _estado = CAPTURA_ATIVA;
+      if (_temUltima) {
+        gravar(_ultimoInstante, _ultimoNivel);
+      }
+      return true;
+    }
+
+    // Partida do disco (primeira borda de subida depois de uma parada): dispara uma captura armada.
+    void sinalizarPartida() {
+      disparar();
+    }
+
+    // Para a captura; o quadro em montagem fica pronto para a saída.
+    void parar() {
+      _estado = CAPTURA_PARADA;
+      descarregar();
+    }
+
+    // Fecha o quadro em montagem sem esperar ele encher (parada do disco, fim da captura).
+    void descarregar() {
+      if (_tamanhoMontagem != 0) {
+        fecharQuadro();
+      }
+    }
+
+    // Lê o cabeçalho de um quadro decodificado por desenquadrarTelemetria(). Retorna false se não for um quadro de captura.
+    static bool lerCabecalho(const uint8_t* conteudo, uint8_t tamanho, CabecalhoCaptura& cabecalho) {
+      if (tamanho < 2 || conteudo[0] != QUADRO_CAPTURA) {
+        return false;
+      }
+      cabecalho.sequencia = conteudo[1];
+      cabecalho.posicao = 2;
+      return lerVarint(conteudo, tamanho, cabecalho.posicao, cabecalho.perdidas)
+          && lerVarint(conteudo, tamanho, cabecalho.posicao, cabecalho.referencia);
+    }
+
+    // Lê o próximo registro a partir de 'posicao' (atualizada). Retorna false no fim do conteúdo ou em varint truncado.
+    static bool lerRegistro(const uint8_t* conteudo, uint8_t tamanho, uint8_t& posicao, uint32_t& delta, uint8_t& nivel) {
+      uint32_t valor;
+      if (!lerVarint(conteudo, tamanho, posicao, valor)) {
+        return false;
+      }
+      delta = valor >> 1;
+      nivel = valor & 1;
+      return true;
+    }
+
+    static bool lerVarint(const uint8_t* conteudo, uint8_t tamanho, uint8_t& posicao, uint32_t& valor) {
+      valor = 0;
+      for (uint8_t deslocamento = 0; deslocamento < 35; deslocamento += 7) {
+        if (posicao >= tamanho) {
+          return false;
+        }
+        uint8_t byte = conteudo[posicao++];
+        valor |= (uint32_t)(byte & 0x7F) << deslocamento;
+        if (!(byte & 0x80)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    EstadoCaptura lerEstado() const { return _estado; }
+    unsigned long lerLimite() const { return _limite; }
+    unsigned long lerCapturadas() const { return _capturadas; }       // Bordas gravadas desde o armar().
+    unsigned long lerPerdidas() const { return _perdidas; }           // Bordas descartadas por falta de quadro livre.
+    unsigned long lerBytesEnviados() const { return _bytesEnviados; } // Bytes entregues à saída (com os separadores).
+    unsigned long lerQuadrosEnviados() const { return _quadrosEnviados; }
+    uint8_t lerQuadrosPendentes() const { return _prontos; }
+    bool lerQuadrosReservados() const { return _quadros != nullptr; } // Ocupa a arena agora.
+    static uint8_t tamanhoQuadro() { return TamanhoQuadro; }
+    static uint8_t numQuadros() { return NumQuadros; }
+};
+
+#endif // capturaBordas_h
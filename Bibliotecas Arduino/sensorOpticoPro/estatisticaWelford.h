@@ -0,0 +1,70 @@
+/*
+ * estatisticaWelford.h
+ *
+ * Descrição: Média e variância calculadas em uma única passagem, amostra por
+ * amostra, pelo algoritmo de Welford. Nenhuma amostra é armazenada: o estado
+ * ocupa 10 bytes, qualquer que seja o número de amostras, e cada amostra
+ * custa uma divisão e duas multiplicações (sem pow() e sem segunda passagem
+ * sobre um vetor).
+ *
+ * Usada na calibração do limiar do sensorOpticoPro, que acumula os tempos em
+ * nível alto e em nível baixo dos pulsos ao longo de várias chamadas do loop().
+ *
+ * Funcionamento (a cada amostra x):
+ *   n = n + 1
+ *   delta = x - media
+ *   media = media + delta / n
+ *   m2 = m2 + delta * (x - media)      (variância amostral = m2 / (n - 1))
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef estatisticaWelford_h // Guarda de inclusão.
+#define estatisticaWelford_h
+
+#include <inttypes.h> // Tipos inteiros de tamanho fixo.
+#include <math.h>     // sqrt()
+
+class estatisticaWelford
+{
+  private:
+    float _media = 0.0;  // Média das amostras acumuladas.
+    float _m2 = 0.0;     // Soma dos quadrados das diferenças em relação à média.
+    uint16_t _n = 0;     // Amostras acumuladas (satura em 65535).
+
+  public:
+    void zerar() {
+      _media = 0.0;
+      _m2 = 0.0;
+      _n = 0;
+    }
+
+    // Acumula uma amostra. Retorna false (sem acumular) se o contador estiver saturado.
+    bool adicionar(float x) {
+      if (_n == 0xFFFF) {
+        return false;
+      }
+      _n++;
+      float delta = x - _media;
+      _media += delta / _n;
+      _m2 += delta * (x - _media);
+      return true;
+    }
+
+    uint16_t amostras() const { return _n; }
+    float media() const { return _media; }
+    float variancia() const { return (_n > 1) ? _m2 / (_n - 1) : 0.0; } // Variância amostral.
+    float desvioPadrao() const { return sqrt(variancia()); }
+
+    // Erro padrão da média relativo à média (desvio / (média * raiz(n))). 1.0 enquanto não houver amostras suficientes.
+    float erroRelativo() const {
+      if (_n < 2 || _media <= 0.0) {
+        return 1.0;
+      }
+      return desvioPadrao() / (_media * sqrt((float)_n));
+    }
+};
+
+#endif // estatisticaWelford_h
@@ -0,0 +1,300 @@
+/*
+ * filaSaida.h
+ *
+ * Descrição: Fila de saída com prioridades que separa a medição da escrita na
+ * Serial. Quem mede apenas copia os bytes para a RAM; a transmissão acontece em
+ * atender(), chamado no loop(), que entrega à saída somente os bytes que ela
+ * aceita sem bloquear (Serial.availableForWrite()). Assim o pior tempo de uma
+ * passagem do loop() deixa de depender da velocidade da Serial.
+ *
+ * Duas classes de mensagens, em vetores circulares separados:
+ *   - Respostas: texto dos comandos, transmitido antes da telemetria e nunca
+ *     descartado. Com o vetor cheio, a escrita espera a saída esvaziar (o
+ *     comando bloqueia, como antes, mas a medição não).
+ *   - Telemetria: mensagens de até 255 bytes (linhas de texto ou quadros
+ *     binários) montadas entre iniciarMensagem() e concluirMensagem(). Nunca
+ *     bloqueia: sem espaço, aplica a política:
+ *       POLITICA_DESCARTAR_ANTIGAS: descarta as mensagens mais antigas ainda
+ *         não iniciadas até a nova caber (o receptor recebe os dados recentes);
+ *       POLITICA_DIZIMAR: com a fila acima da metade, aceita apenas uma a cada
+ *         'fator' mensagens novas (a taxa cai antes de a fila encher); cheia,
+ *         descarta a nova.
+ *
+ * A transmissão nunca intercala mensagens: uma mensagem de telemetria já
+ * iniciada termina antes de a próxima resposta começar. A espera máxima de uma
+ * resposta é, portanto, o restante de uma mensagem (até 255 bytes).
+ *
+ * Cada mensagem de telemetria ocupa 1 byte de tamanho + o conteúdo. Descartar a
+ * mais antiga enquanto outra está em transmissão desloca os bytes restantes da
+ * que está em transmissão (no máximo 255 cópias), sem alocação.
+ *
+ * A escrita e o espaço livre da saída são ponteiros para função (Serial no
+ * Arduino, um vetor ou um contador nas bancadas e testes).
+ *
+ * Memória: CapacidadeRespostas + CapacidadeTelemetria + 32 bytes.
+ *
+ * Não depende do Arduino.h, podendo ser compilada e testada no Linux.
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef filaSaida_h // Guarda de inclusão.
+#define filaSaida_h
+
+#include <inttypes.h> // Tipos inteiros de tamanho fixo.
+
+typedef void (*EscritaSaida)(const uint8_t* dados, uint8_t tamanho); // Escreve bytes que cabem na saída (não deve bloquear).
+typedef int (*EspacoSaida)();                                         // Bytes que a saída aceita sem bloquear.
+
+// O que fazer com a telemetria quando a fila não acompanha a taxa de geração.
+enum PoliticaSaida : uint8_t {
+  POLITICA_DESCARTAR_ANTIGAS = 0, // Descarta as mensagens mais antigas até a nova caber.
+  POLITICA_DIZIMAR = 1            // Acima da metade da fila, aceita uma a cada 'fator' mensagens; cheia, descarta a nova.
+};
+
+template <uint16_t CapacidadeRespostas, uint16_t CapacidadeTelemetria>
+class filaSaida
+{
+  static_assert(CapacidadeRespostas >= 1, "A fila de respostas precisa de pelo menos um byte.");
+  static_assert(CapacidadeTelemetria >= 16, "A fila de telemetria precisa de pelo menos 16 bytes.");
+  static_assert(CapacidadeRespostas <= 16384 && CapacidadeTelemetria <= 16384, "Capacidade acima do limite dos índices de 16 bits.");
+
+  private:
+    EscritaSaida _escrita;
+    EspacoSaida _espaco;
+
+    uint8_t _respostas[CapacidadeRespostas];   // Texto das respostas (circular, sem separação em mensagens).
+    uint8_t _telemetria[CapacidadeTelemetria]; // Restante da mensagem em transmissão + mensagens [tamanho][conteúdo] (circular).
+    uint16_t _inicioRespostas = 0;
+    uint16_t _ocupacaoRespostas = 0;
+    uint16_t _inicioTelemetria = 0;
+    uint16_t _ocupacaoTelemetria = 0;  // Bytes das mensagens concluídas (a mensagem em montagem fica logo depois).
+    uint16_t _tamanhoMontagem = 0;     // Bytes da mensagem em montagem, incluindo o byte de tamanho.
+    uint16_t _restantesCabeca = 0;     // Bytes ainda não transmitidos da mensagem em transmissão (0: nenhuma).
+    uint16_t _ocupacaoMaximaRespostas = 0;
+    uint16_t _ocupacaoMaximaTelemetria = 0;
+
+    unsigned long _mensagensEnviadas = 0;   // Mensagens de telemetria cuja transmissão começou.
+    unsigned long _descartadasAntigas = 0;  // Mensagens removidas para dar lugar a uma nova (POLITICA_DESCARTAR_ANTIGAS).
+    unsigned long _descartadasNovas = 0;    // Mensagens novas que não couberam (fila cheia ou mais de 255 bytes).
+    unsigned long _dizimadas = 0;           // Mensagens novas recusadas pela dizimação.
+
+    PoliticaSaida _politica = POLITICA_DESCARTAR_ANTIGAS;
+    uint8_t _fatorDizimacao = 4;
+    uint8_t _contadorDizimacao = 0;
+    bool _montando = false;            // Os bytes escritos vão para a mensagem de telemetria em montagem.
+    bool _montagemDescartada = false;  // A mensagem em montagem não coube e será descartada na conclusão.
+    bool _montagemDizimada = false;    // A mensagem em montagem foi recusada pela dizimação.
+
+    static uint16_t indice(uint16_t posicao, uint16_t capacidade) {
+      return (posicao >= capacidade) ? posicao - capacidade : posicao;
+    }
+
+    // Remove a mensagem concluída mais antiga que ainda não começou a ser transmitida. Retorna false se não houver.
+    bool descartarMaisAntiga() {
+      if (_ocupacaoTelemetria <= _restantesCabeca) {
+        return false; // Só resta a mensagem em transmissão.
+      }
+      uint16_t tamanho = 1 + _telemetria[indice(_inicioTelemetria + _restantesCabeca, CapacidadeTelemetria)];
+      // Os bytes restantes da mensagem em transmissão avançam sobre a mensagem descartada (do fim para o começo).
+      for (uint16_t k = _restantesCabeca; k > 0; k--) {
+        _telemetria[indice(_inicioTelemetria + tamanho + k - 1, CapacidadeTelemetria)] = _telemetria[indice(_inicioTelemetria + k - 1, CapacidadeTelemetria)];
+      }
+      _inicioTelemetria = indice(_inicioTelemetria + tamanho, CapacidadeTelemetria);
+      _ocupacaoTelemetria -= tamanho;
+      _descartadasAntigas++;
+      return true;
+    }
+
+    void escreverResposta(uint8_t valor) {
+      while (_ocupacaoRespostas >= CapacidadeRespostas) {
+        atender(true); // Resposta maior que a fila: espera a saída (contexto de comando, não de medição).
+      }
+      _respostas[indice(_inicioRespostas + _ocupacaoRespostas, CapacidadeRespostas)] = valor;
+      _ocupacaoRespostas++;
+      if (_ocupacaoRespostas > _ocupacaoMaximaRespostas) {
+        _ocupacaoMaximaRespostas = _ocupacaoRespostas;
+      }
+    }
+
+    void escreverMensagem(uint8_t valor) {
+      if (_montagemDescartada || _montagemDizimada) {
+        return;
+      }
+      if (_tamanhoMontagem > 255 || _tamanhoMontagem + 1 > CapacidadeTelemetria) { // Acima de 255 bytes (byte de tamanho) ou maior que a fila.
+        _montagemDescartada = true;
+        return;
+      }
+      while (_ocupacaoTelemetria + _tamanhoMontagem + 1 > CapacidadeTelemetria) {
+        if (_politica != POLITICA_DESCARTAR_ANTIGAS || !descartarMaisAntiga()) {
+          _montagemDescartada = true;
+          return;
+        }
+      }
+      _telemetria[indice(_inicioTelemetria + _ocupacaoTelemetria + _tamanhoMontagem, CapacidadeTelemetria)] = valor;
+      _tamanhoMontagem++;
+    }
+
+  public:
+    filaSaida(EscritaSaida escrita, EspacoSaida espaco) : _escrita(escrita), _espaco(espaco) {}
+
+    // Destino dos bytes escritos: a mensagem de telemetria em montagem ou as respostas.
+    void escrever(uint8_t valor) {
+      if (_montando) {
+        escreverMensagem(valor);
+      } else {
+        escreverResposta(valor);
+      }
+    }
+
+    // Começa uma mensagem de telemetria: os bytes escritos até concluirMensagem() formam uma mensagem (até 255 bytes).
+    void iniciarMensagem() {
+      _montando = true;
+      _tamanhoMontagem = 1; // Byte de tamanho, preenchido na conclusão.
+      _montagemDescartada = false;
+      _montagemDizimada = false;
+      if (_politica == POLITICA_DIZIMAR && 2 * _ocupacaoTelemetria >= CapacidadeTelemetria) {
+        if (++_contadorDizimacao < _fatorDizimacao) {
+          _montagemDizimada = true;
+          _dizimadas++;
+        } else {
+          _contadorDizimacao = 0;
+        }
+      }
+    }
+
+    // Conclui a mensagem em montagem: ela entra na fila inteira, ou é descartada inteira.
+    void concluirMensagem() {
+      if (!_montando) {
+        return;
+      }
+      _montando = false;
+      if (_montagemDizimada) {
+        return;
+      }
+      if (_montagemDescartada) {
+        _descartadasNovas++;
+        return;
+      }
+      if (_tamanhoMontagem <= 1) {
+        return; // Mensagem vazia.
+      }
+      _telemetria[indice(_inicioTelemetria + _ocupacaoTelemetria, CapacidadeTelemetria)] = (uint8_t)(_tamanhoMontagem - 1);
+      _ocupacaoTelemetria += _tamanhoMontagem;
+      if (_ocupacaoTelemetria > _ocupacaoMaximaTelemetria) {
+        _ocupacaoMaximaTelemetria = _ocupacaoTelemetria;
+      }
+    }
+
+    // Enfileira uma mensagem de telemetria pronta (um quadro binário, por exemplo).
+    void enviarMensagem(const uint8_t* dados, uint8_t tamanho) {
+      iniciarMensagem();
+      for (uint8_t i = 0; i < tamanho; i++) {
+        escreverMensagem(dados[i]);
+      }
+      concluirMensagem();
+    }
+
+    // Enfileira uma mensagem pronta somente se ela couber no espaço livre, sem descartar nem dizimar nada.
+    // Retorna false se não couber: quem envia guarda a mensagem e tenta de novo (dados que não podem ter lacunas).
+    bool tentarEnviarMensagem(const uint8_t* dados, uint8_t tamanho) {
+      if (_montando || tamanho == 0 || _ocupacaoTelemetria + tamanho + 1 > CapacidadeTelemetria) {
+        return false;
+      }
+      uint16_t posicao = _inicioTelemetria + _ocupacaoTelemetria;
+      _telemetria[indice(posicao, CapacidadeTelemetria)] = tamanho;
+      for (uint8_t i = 0; i < tamanho; i++) {
+        _telemetria[indice(posicao + 1 + i, CapacidadeTelemetria)] = dados[i];
+      }
+      _ocupacaoTelemetria += tamanho + 1;
+      if (_ocupacaoTelemetria > _ocupacaoMaximaTelemetria) {
+        _ocupacaoMaximaTelemetria = _ocupacaoTelemetria;
+      }
+      return true;
+    }
+
+    // Transmite o que a saída aceitar sem bloquear: primeiro o restante da mensagem em transmissão, depois as
+    // respostas, depois a telemetria. Com 'bloquear', transmite pelo menos um byte mesmo sem espaço livre.
+    void atender(bool bloquear = false) {
+      int espaco = _espaco();
+      if (bloquear && espaco < 1) {
+        espaco = 1;
+      }
+      while (espaco > 0) {
+        uint16_t quantidade;
+        if (_restantesCabeca == 0 && _ocupacaoRespostas > 0) {
+          quantidade = CapacidadeRespostas - _inicioRespostas; // Trecho contínuo até o fim do vetor.
+          if (quantidade > _ocupacaoRespostas) quantidade = _ocupacaoRespostas;
+          if ((int)quantidade > espaco) quantidade = espaco;
+          if (quantidade > 255) quantidade = 255;
+          _escrita(&_respostas[_inicioRespostas], (uint8_t)quantidade);
+          _inicioRespostas = indice(_inicioRespostas + quantidade, CapacidadeRespostas);
+          _ocupacaoRespostas -= quantidade;
+          espaco -= quantidade;
+          continue;
+        }
+        if (_restantesCabeca == 0) {
+          if (_ocupacaoTelemetria == 0) {
+            return; // Nada a transmitir.
+          }
+          _restantesCabeca = _telemetria[_inicioTelemetria]; // Começa a próxima mensagem: o byte de tamanho sai da fila.
+          _inicioTelemetria = indice(_inicioTelemetria + 1, CapacidadeTelemetria);
+          _ocupacaoTelemetria--;
+          _mensagensEnviadas++;
+          continue;
+        }
+        quantidade = CapacidadeTelemetria - _inicioTelemetria;
+        if (quantidade > _restantesCabeca) quantidade = _restantesCabeca;
+        if ((int)quantidade > espaco) quantidade = espaco;
+        _escrita(&_telemetria[_inicioTelemetria], (uint8_t)quantidade);
+        _inicioTelemetria = indice(_inicioTelemetria + quantidade, CapacidadeTelemetria);
+        _ocupacaoTelemetria -= quantidade;
+        _restantesCabeca -= quantidade;
+        espaco -= quantidade;
+      }
+    }
+
+    // Transmite tudo, esperando a saída (fim de um comando longo, antes de reiniciar a placa...).
+    void esvaziar() {
+      while (_ocupacaoRespostas > 0 || _ocupacaoTelemetria > 0) {
+        atender(true);
+      }
+    }
+
+    // Seleciona a política da telemetria (fator: uma a cada 'fator' mensagens na dizimação, 2 a 255).
+    bool configurarPolitica(PoliticaSaida politica, uint8_t fatorDizimacao) {
+      if (politica > POLITICA_DIZIMAR || fatorDizimacao < 2) {
+        return false;
+      }
+      _politica = politica;
+      _fatorDizimacao = fatorDizimacao;
+      _contadorDizimacao = 0;
+      return true;
+    }
+
+    PoliticaSaida lerPolitica() const { return _politica; }
+    uint8_t lerFatorDizimacao() const { return _fatorDizimacao; }
+    uint16_t lerOcupacaoRespostas() const { return _ocupacaoRespostas; }
+    uint16_t lerOcupacaoTelemetria() const { return _ocupacaoTelemetria; }
+    uint16_t lerOcupacaoMaximaRespostas() const { return _ocupacaoMaximaRespostas; }
+    uint16_t lerOcupacaoMaximaTelemetria() const { return _ocupacaoMaximaTelemetria; }
+    unsigned long lerMensagensEnviadas() const { return _mensagensEnviadas; }
+    unsigned long lerDescartadasAntigas() const { return _descartadasAntigas; }
+    unsigned long lerDescartadasNovas() const { return _descartadasNovas; }
+    unsigned long lerDizimadas() const { return _dizimadas; }
+    unsigned long lerDescartadas() const { return _descartadasAntigas + _descartadasNovas + _dizimadas; }
+    void zerarContadores() {
+      _mensagensEnviadas = 0;
+      _descartadasAntigas = 0;
+      _descartadasNovas = 0;
+      _dizimadas = 0;
+      _ocupacaoMaximaRespostas = _ocupacaoRespostas;
+      _ocupacaoMaximaTelemetria = _ocupacaoTelemetria;
+    }
+    static uint16_t capacidadeRespostas() { return CapacidadeRespostas; }
+    static uint16_t capacidadeTelemetria() { return CapacidadeTelemetria; }
+};
+
+#endif // filaSaida_h
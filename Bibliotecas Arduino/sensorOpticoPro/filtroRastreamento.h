@@ -0,0 +1,152 @@
+/*
+ * filtroRastreamento.h
+ *
+ * Descrição: Filtro de rastreamento (alfa-beta-gama com os ganhos do filtro
+ * de Kalman em regime permanente) para a velocidade e a aceleração do disco.
+ * Consome os instantes das bordas de subida e mantém três estimativas:
+ * instante previsto da próxima borda, passo (micros por risco) e variação do
+ * passo por risco. A velocidade e a aceleração saem do passo, sem o atraso
+ * de uma média móvel e sem o ruído do inverso de um único intervalo.
+ *
+ * Modelo: a variável independente é a posição (riscos), não o tempo. Como as
+ * bordas chegam em posições conhecidas (um risco por borda), o passo entre as
+ * medições é sempre 1 e os ganhos são constantes: são calculados uma vez, ao
+ * configurar o ruído de processo, iterando a equação de Riccati do modelo de
+ * aceleração constante. Cada borda custa ~10 operações em float.
+ *
+ *   previsão:    instante += passo + variacao / 2;  passo += variacao
+ *   atualização: r = instante medido - instante previsto
+ *                instante += K0 * r;  passo += K1 * r;  variacao += K2 * r
+ *
+ * Conversões (N = riscos por volta, passo p em micros, variação j em micros/risco):
+ *   RPM = 60e6 / (N * p)
+ *   aceleração (RPM/s) = -60e12 * j / (N * p^3)
+ *
+ * Ruído de processo: razão entre a variância da variação do passo de um
+ * risco para o outro e a variância do ruído de medição (jitter da borda).
+ * Valores maiores acompanham mudanças mais rápidas, com mais ruído.
+ *
+ * Não depende do Arduino.h, podendo ser compilado e testado no Linux.
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef filtroRastreamento_h // Guarda de inclusão.
+#define filtroRastreamento_h
+
+#include <inttypes.h> // Tipos inteiros de tamanho fixo.
+
+#define RASTREAMENTO_ITERACOES_RICCATI 200 // Iterações da equação de Riccati até os ganhos convergirem.
+
+class filtroRastreamento
+{
+  private:
+    float _ganho[3] = { 0.0, 0.0, 0.0 }; // K0 (instante), K1 (passo), K2 (variação do passo).
+    float _ruidoProcesso = 0.0;  // Razão ruído de processo / ruído de medição usada nos ganhos.
+    float _desvio = 0.0;         // Instante estimado da última borda menos o instante medido (micros).
+    float _passo = 0.0;          // Micros por risco.
+    float _variacao = 0.0;       // Variação do passo por risco (micros/risco).
+    bool _iniciado = false;      // Já houve um intervalo para inicializar o passo.
+
+  public:
+    filtroRastreamento() {
+      configurarRuido(0.000001);
+    }
+
+    // Calcula os ganhos em regime permanente para o ruído de processo (razão de variâncias, maior que zero).
+    // Modelo de aceleração constante com passo 1: F = [1 1 1/2; 0 1 1; 0 0 1], H = [1 0 0],
+    // Q = q * G * G' com G = [1/6 1/2 1]' (variação do passo aleatória entre riscos), R = 1.
+    bool configurarRuido(float ruidoProcesso) {
+      if (!(ruidoProcesso > 0.0)) {
+        return false;
+      }
+      _ruidoProcesso = ruidoProcesso;
+      const float g[3] = { 1.0 / 6.0, 0.5, 1.0 };
+      float p[3][3] = { { 1e6, 0.0, 0.0 }, { 0.0, 1e6, 0.0 }, { 0.0, 0.0, 1e6 } };
+      for (uint16_t iteracao = 0; iteracao < RASTREAMENTO_ITERACOES_RICCATI; iteracao++) {
+        // Previsão: P = F P F' + Q.
+        float fp[3][3];
+        for (uint8_t c = 0; c < 3; c++) {
+          fp[0][c] = p[0][c] + p[1][c] + 0.5 * p[2][c];
+          fp[1][c] = p[1][c] + p[2][c];
+          fp[2][c] = p[2][c];
+        }
+        for (uint8_t l = 0; l < 3; l++) {
+          p[l][0] = fp[l][0] + fp[l][1] + 0.5 * fp[l][2] + ruidoProcesso * g[l] * g[0];
+          p[l][1] = fp[l][1] + fp[l][2] + ruidoProcesso * g[l] * g[1];
+          p[l][2] = fp[l][2] + ruidoProcesso * g[l] * g[2];
+        }
+        // Atualização: K = P H' / (H P H' + R), P = (I - K H) P.
+        float s = p[0][0] + 1.0;
+        for (uint8_t l = 0; l < 3; l++) {
+          _ganho[l] = p[l][0] / s;
+        }
+        float linha0[3] = { p[0][0], p[0][1], p[0][2] };
+        for (uint8_t l = 0; l < 3; l++) {
+          for (uint8_t c = 0; c < 3; c++) {
+            p[l][c] -= _ganho[l] * linha0[c];
+          }
+        }
+      }
+      return true;
+    }
+
+    // Volta ao estado inicial (a próxima borda reinicia o passo). Os ganhos são mantidos.
+    void zerar() {
+      _desvio = 0.0;
+      _passo = 0.0;
+      _variacao = 0.0;
+      _iniciado = false;
+    }
+
+    // Registra o intervalo (micros) entre duas bordas aceitas que cobriu 'riscos' riscos.
+    void registrar(unsigned long intervalo, uint8_t riscos) {
+      if (!_iniciado) {
+        _passo = (float)intervalo / riscos;
+        _variacao = 0.0;
+        _desvio = 0.0;
+        _iniciado = true;
+        return;
+      }
+
+      // Previsão risco a risco (riscos perdidos: várias previsões e uma atualização).
+      float previsto = _desvio;
+      for (uint8_t r = 0; r < riscos; r++) {
+        previsto += _passo + 0.5 * _variacao;
+        _passo += _variacao;
+      }
+      float residuo = (float)intervalo - previsto; // Instante medido - instante previsto, relativo à borda anterior.
+
+      _desvio = -residuo * (1.0 - _ganho[0]); // Novo instante estimado menos o instante medido.
+      _passo += _ganho[1] * residuo;
+      _variacao += _ganho[2] * residuo;
+      if (_passo <= 0.0) {
+        _passo = (float)intervalo / riscos; // Divergência (parada ou partida brusca): reinicia o passo pela medição.
+        _variacao = 0.0;
+      }
+    }
+
+    float lerPasso() const { return _passo; }           // Micros por risco (0 antes da primeira medição).
+    float lerVariacaoPasso() const { return _variacao; } // Micros/risco por risco.
+    float lerRuidoProcesso() const { return _ruidoProcesso; }
+    const float* lerGanhos() const { return _ganho; }
+    bool iniciado() const { return _iniciado; }
+
+    // Velocidade em RPM para um disco de 'numRiscos' riscos.
+    float lerRpm(uint8_t numRiscos) const {
+      return (_passo > 0.0) ? 60000000.0 / ((float)numRiscos * _passo) : 0.0;
+    }
+
+    // Aceleração em RPM/s: dv/dt = -60e12 * j / (N * p^3).
+    float lerAceleracaoRpm(uint8_t numRiscos) const {
+      if (_passo <= 0.0) {
+        return 0.0;
+      }
+      float rpm = lerRpm(numRiscos);
+      return -rpm * 1000000.0 * _variacao / (_passo * _passo);
+    }
+};
+
+#endif // filtroRastreamento_h
@@ -0,0 +1,202 @@
+/*
+ * geometriaDisco.h
+ *
+ * Descrição: Tabela de calibração da geometria do disco decodificador. Um
+ * disco impresso ou cortado à mão não tem os riscos igualmente espaçados (e
+ * pode estar excêntrico no eixo), o que aparece como uma ondulação de uma vez
+ * por volta no RPM calculado a cada borda. A tabela guarda, para cada posição
+ * de risco, o inverso da largura angular do intervalo que termina naquele
+ * risco, e o estimador corrige cada intervalo com uma única multiplicação,
+ * sem precisar de uma janela de média longa (e da latência que ela traz).
+ *
+ * Aprendizado (com o disco girando em velocidade constante):
+ *   - Os intervalos são somados por posição de risco durante 'voltas' voltas
+ *     completas (a primeira volta só começa quando o índice passa pelo risco 0).
+ *   - Largura do risco i = numRiscos * soma[i] / soma total (média 1,0).
+ *   - A tabela só é aceita se a duração das voltas variou menos que
+ *     GEOMETRIA_VARIACAO_MAXIMA_MILESIMOS: aceleração durante o aprendizado
+ *     seria confundida com erro de espaçamento.
+ *   - Um intervalo com riscos perdidos (k riscos) é dividido igualmente entre
+ *     as k posições, para que todas recebam o mesmo número de amostras.
+ *
+ * A tabela é indexada pela posição do risco contada pelo sensorOpticoPro, que
+ * começa no risco onde a medição começou. Se a contagem for reiniciada
+ * (iniciar(), novo número de riscos), a tabela precisa ser aprendida de novo.
+ *
+ * Ponto fixo: fatores em Q2.14 (16384 = 1,0; de 0,5 a 2,0), de modo que
+ * intervalo * fator cabe em 32 bits para intervalos até 65535 micros. Acima
+ * disso a correção usa duas multiplicações (só abaixo de ~25 RPM em 36 riscos).
+ *
+ * Memória: 6 bytes por risco (fator e soma) + 20 bytes de controle.
+ *
+ * Não depende do Arduino.h, podendo ser compilada e testada no Linux.
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef geometriaDisco_h // Guarda de inclusão.
+#define geometriaDisco_h
+
+#include <inttypes.h> // Tipos inteiros de tamanho fixo.
+
+#define GEOMETRIA_UM_Q14 16384U                // Fator 1,0 em Q2.14 (risco com a largura nominal).
+#define GEOMETRIA_VARIACAO_MAXIMA_MILESIMOS 20 // Maior variação (max - min) / min da duração das voltas aceita no aprendizado (2%).
+
+template <uint8_t MaxRiscos>
+class geometriaDisco
+{
+  static_assert(MaxRiscos >= 1, "A tabela de geometria deve ter pelo menos um risco.");
+
+  private:
+    uint16_t _fator[MaxRiscos];      // Inverso da largura de cada risco, em Q2.14 (intervalo corrigido = intervalo * fator).
+    unsigned long _soma[MaxRiscos];  // Aprendizado: soma dos intervalos (micros) que terminaram em cada risco.
+    uint8_t _numRiscos = 0;          // Riscos do disco usados na tabela.
+    uint16_t _voltasRestantes = 0;   // Voltas que ainda faltam no aprendizado.
+    uint16_t _voltasAprendidas = 0;  // Voltas completas somadas.
+    unsigned long _instanteVolta = 0;    // Instante (micros) em que a volta atual começou.
+    unsigned long _duracaoVoltaMin = 0;  // Menor duração de volta (micros) durante o aprendizado.
+    unsigned long _duracaoVoltaMax = 0;  // Maior duração de volta (micros) durante o aprendizado.
+    bool _aprendendo = false;        // Aprendizado em andamento.
+    bool _voltaIniciada = false;     // O índice já passou pelo risco 0 desde o início do aprendizado.
+    bool _ativa = false;             // A tabela está sendo aplicada pelo estimador.
+
+    // Soma um intervalo à posição do risco, interrompendo o aprendizado se a soma estourar 32 bits.
+    void somar(uint8_t indice, unsigned long intervalo) {
+      if (_soma[indice] + intervalo < _soma[indice]) {
+        _voltasRestantes = 0;
+        return;
+      }
+      _soma[indice] += intervalo;
+    }
+
+  public:
+    geometriaDisco() {
+      desativar();
+    }
+
+    // Volta todos os fatores a 1,0 e para o aprendizado.
+    void desativar() {
+      for (uint8_t i = 0; i < MaxRiscos; i++) {
+        _fator[i] = GEOMETRIA_UM_Q14;
+      }
+      _ativa = false;
+      _aprendendo = false;
+    }
+
+    // Começa a aprender a geometria durante 'voltas' voltas. Retorna false se o disco não couber na tabela.
+    bool iniciarAprendizado(uint8_t numRiscos, uint16_t voltas) {
+      if (numRiscos == 0 || numRiscos > MaxRiscos || voltas == 0) {
+        return false;
+      }
+      for (uint8_t i = 0; i < MaxRiscos; i++) {
+        _soma[i] = 0;
+      }
+      _numRiscos = numRiscos;
+      _voltasRestantes = voltas;
+      _voltasAprendidas = 0;
+      _duracaoVoltaMin = 0xFFFFFFFFUL;
+      _duracaoVoltaMax = 0;
+      _voltaIniciada = false;
+      _aprendendo = true;
+      return true;
+    }
+
+    // Registra um intervalo aceito que terminou no risco 'indice' e cobriu 'riscos' riscos.
+    // 'novaVolta' indica que o índice passou pelo risco 0 neste intervalo.
+    // Retorna true quando a última volta foi somada (o chamador deve chamar concluirAprendizado()).
+    bool registrar(unsigned long instante, unsigned long intervalo, uint8_t indice, uint8_t riscos, bool novaVolta) {
+      if (!_aprendendo) {
+        return false;
+      }
+      if (!_voltaIniciada) {
+        if (novaVolta) { // A primeira volta completa começa no risco 0.
+          _voltaIniciada = true;
+          _instanteVolta = instante - intervalo * indice / riscos; // Instante estimado da passagem pelo risco 0.
+        }
+        return false;
+      }
+
+      // Divide o intervalo entre os riscos que ele cobriu (indice, indice - 1, ...).
+      unsigned long parte = intervalo / riscos;
+      for (uint8_t r = 0; r < riscos; r++) {
+        uint8_t posicao = (indice >= r) ? indice - r : indice + _numRiscos - r;
+        somar(posicao, parte);
+      }
+
+      if (novaVolta && _voltasRestantes > 0) {
+        unsigned long passagemZero = instante - parte * indice; // Instante (estimado) da passagem pelo risco 0.
+        unsigned long duracao = passagemZero - _instanteVolta;
+        _instanteVolta = passagemZero;
+        if (duracao < _duracaoVoltaMin) _duracaoVoltaMin = duracao;
+        if (duracao > _duracaoVoltaMax) _duracaoVoltaMax = duracao;
+        _voltasAprendidas++;
+        _voltasRestantes--;
+      }
+      return _voltasRestantes == 0;
+    }
+
+    // Calcula a tabela a partir das somas. Retorna false (tabela anterior mantida) se a velocidade variou demais.
+    bool concluirAprendizado() {
+      _aprendendo = false;
+      if (_voltasAprendidas == 0 || lerVariacaoVelocidadeMilesimos() > GEOMETRIA_VARIACAO_MAXIMA_MILESIMOS) {
+        return false;
+      }
+
+      float total = 0.0;
+      for (uint8_t i = 0; i < _numRiscos; i++) {
+        if (_soma[i] == 0) {
+          return false;
+        }
+        total += _soma[i];
+      }
+
+      // fator = 1 / largura = soma total / (numRiscos * soma[i]), limitado a 0,5..2,0.
+      for (uint8_t i = 0; i < _numRiscos; i++) {
+        float fator = total / ((float)_numRiscos * _soma[i]) * GEOMETRIA_UM_Q14;
+        if (fator < GEOMETRIA_UM_Q14 / 2) fator = GEOMETRIA_UM_Q14 / 2;
+        if (fator > 2.0 * GEOMETRIA_UM_Q14) fator = 2.0 * GEOMETRIA_UM_Q14 - 1;
+        _fator[i] = (uint16_t)(fator + 0.5);
+      }
+      for (uint8_t i = _numRiscos; i < MaxRiscos; i++) {
+        _fator[i] = GEOMETRIA_UM_Q14;
+      }
+      _ativa = true;
+      return true;
+    }
+
+    // Intervalo (micros) que o estimador teria medido se o risco 'indice' tivesse a largura nominal. Uma multiplicação.
+    unsigned long corrigir(unsigned long intervalo, uint8_t indice) const {
+      uint16_t fator = _fator[indice];
+      if (intervalo <= 0xFFFFUL) {
+        return (intervalo * fator + GEOMETRIA_UM_Q14 / 2) >> 14;
+      }
+      return (intervalo >> 14) * fator + (((intervalo & 0x3FFFUL) * fator) >> 14); // Intervalos longos: evita estourar 32 bits.
+    }
+
+    // Variação da duração das voltas no aprendizado, em milésimos ((max - min) / min).
+    uint16_t lerVariacaoVelocidadeMilesimos() const {
+      if (_voltasAprendidas == 0 || _duracaoVoltaMin == 0) {
+        return 0;
+      }
+      unsigned long variacao = _duracaoVoltaMax - _duracaoVoltaMin;
+      unsigned long referencia = _duracaoVoltaMin;
+      while (variacao > 4000000UL) { // Mantém variacao * 1000 dentro de 32 bits.
+        variacao >>= 1;
+        referencia >>= 1;
+      }
+      unsigned long milesimos = (referencia == 0) ? 0xFFFF : variacao * 1000 / referencia;
+      return (milesimos > 0xFFFF) ? 0xFFFF : (uint16_t)milesimos;
+    }
+
+    bool ativa() const { return _ativa; }
+    bool aprendendo() const { return _aprendendo; }
+    uint16_t lerVoltasAprendidas() const { return _voltasAprendidas; }
+    uint16_t lerVoltasRestantes() const { return _voltasRestantes; }
+    uint8_t lerNumRiscos() const { return _numRiscos; }
+    uint16_t lerFator(uint8_t indice) const { return (indice < MaxRiscos) ? _fator[indice] : GEOMETRIA_UM_Q14; } // Q2.14.
+    static uint8_t capacidade() { return MaxRiscos; }
+};
+
+#endif // geometriaDisco_h
@@ -0,0 +1,209 @@
+/*
+ * grupoSensorOpticoPro.h
+ *
+ * Descrição: Atende N sensores ópticos em uma única passagem pelo loop().
+ * Cada canal é um sensorOpticoPro completo, com o seu próprio bloco de estado
+ * (EstadoMedicao): filtro de nível, filtro de glitches, correção de riscos
+ * perdidos, estimadores (período, M/T, volta), índice e detecção de parada
+ * são exatamente os do sensor isolado. O grupo só substitui a leitura dos
+ * pinos: os níveis de todos os canais são lidos em sequência, com um único
+ * micros() por passagem, e cada borda (subida ou descida) entra na fila do
+ * canal pela mesma porta de entrada da captura por interrupção
+ * (registrarBorda(); os sensores ficam em ativarCapturaExterna()). Em
+ * seguida o calcularRPM() de cada canal esvazia a sua fila.
+ *
+ * Custo: o tempo gasto em cada passagem é acumulado e pode ser lido dividido
+ * pelo número de canais (lerCustoMedioPorSensor), permitindo verificar que o
+ * custo por sensor se mantém constante à medida que N cresce.
+ *
+ * Amostragem por porta: portaSensorOpticoPro<N> (até 8 canais na mesma porta
+ * do microcontrolador) lê o registrador de entrada da porta uma única vez por
+ * passagem e encontra as bordas de todos os canais ao mesmo tempo com uma
+ * máscara XOR sobre a leitura anterior, no lugar de N chamadas a digitalRead()
+ * (cada uma refaz a conversão pino -> porta -> bit em tabelas na flash).
+ *
+ * Memória: os sensores são declarados pelo programa (o grupo guarda apenas os
+ * ponteiros); cada um ocupa sizeof(sensorOpticoPro) bytes de RAM
+ * (exibirRelatorioMemoria), o que limita o número de canais no Uno.
+ *
+ * Utilização:
+ *   sensorOpticoPro disco0(2), disco1(3), disco2(4), disco3(5);
+ *   sensorOpticoPro* sensores[] = {&disco0, &disco1, &disco2, &disco3};
+ *   grupoSensorOpticoPro<4> discos(sensores);
+ *   discos.iniciar(36);               // setup()
+ *   discos.atualizar();               // loop()
+ *   float rpm = discos.lerRpmAtual(0);
+ *
+ * Dependências:
+ *   - Arduino.h
+ *   - sensorOpticoPro.h
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef grupoSensorOpticoPro_h // Guarda de inclusão.
+#define grupoSensorOpticoPro_h
+
+#include "Arduino.h"
+#include "sensorOpticoPro.h"
+
+template <uint8_t N>
+class grupoSensorOpticoPro
+{
+  static_assert(N >= 1 && N <= 32, "O grupo atende de 1 a 32 canais (um bit por canal em 32 bits).");
+
+  protected:
+    sensorOpticoPro* _sensores[N];          // Sensor de cada canal (estado de medição próprio).
+    uint8_t _pinos[N];                      // Pino digital de cada canal.
+    uint32_t _estadosAnteriores = 0;        // Bit i: último nível lido no canal i.
+
+    // Medição de custo
+    unsigned long _custoAcumulado = 0;      // Soma dos tempos (micros) gastos nas passagens.
+    unsigned long _passagens = 0;           // Número de passagens somadas em _custoAcumulado.
+
+    // Entrega a borda de um canal ao seu sensor. Retorna false se a fila do canal estiver cheia (borda perdida).
+    bool registrarBorda(uint8_t canal, unsigned long instante, bool nivel) {
+      if (nivel) {
+        _estadosAnteriores |= (uint32_t)1 << canal;
+      } else {
+        _estadosAnteriores &= ~((uint32_t)1 << canal);
+      }
+      return _sensores[canal]->registrarBorda(instante, nivel);
+    }
+
+    // Calcula o RPM de todos os canais (cada um esvazia a sua fila). Retorna a máscara dos canais com medição nova.
+    uint32_t calcularRPM() {
+      uint32_t atualizados = 0;
+      for (uint8_t i = 0; i < N; i++) {
+        float anterior = _sensores[i]->lerRpmAtual();
+        if (_sensores[i]->calcularRPM() != anterior) {
+          atualizados |= (uint32_t)1 << i;
+        }
+      }
+      return atualizados;
+    }
+
+  public:
+    grupoSensorOpticoPro(sensorOpticoPro* const (&sensores)[N]) {
+      for (uint8_t i = 0; i < N; i++) {
+        _sensores[i] = sensores[i];
+        _pinos[i] = sensores[i]->lerPinoSensor();
+      }
+    }
+
+    // Inicia os sensores com o disco informado e passa a entregar as bordas pela fila de cada um.
+    void iniciar(uint8_t numRiscos = 36) {
+      _estadosAnteriores = 0;
+      for (uint8_t i = 0; i < N; i++) {
+        _sensores[i]->iniciar();
+        if (_sensores[i]->lerNumRiscos() != numRiscos) {
+          _sensores[i]->novoNumRiscos(numRiscos);
+        }
+        _sensores[i]->ativarCapturaExterna();
+        if (digitalRead(_pinos[i]) == HIGH) {
+          _estadosAnteriores |= (uint32_t)1 << i; // Evita uma borda falsa na primeira passagem.
+        }
+      }
+      zerarCusto();
+    }
+
+    // Uma passagem por todos os canais. Retorna a máscara dos canais com medição nova.
+    uint32_t atualizar() {
+      unsigned long instante = micros(); // Um único carimbo de tempo para todos os canais desta passagem.
+
+      for (uint8_t i = 0; i < N; i++) {
+        bool nivel = digitalRead(_pinos[i]);
+        if (nivel != (bool)(_estadosAnteriores & ((uint32_t)1 << i))) {
+          registrarBorda(i, instante, nivel);
+        }
+      }
+      uint32_t atualizados = calcularRPM();
+
+      _custoAcumulado += micros() - instante;
+      _passagens++;
+      return atualizados;
+    }
+
+    float lerRpmAtual(uint8_t canal) const { return _sensores[canal]->lerRpmAtual(); } // Getter do RPM de um canal.
+    sensorOpticoPro& lerSensor(uint8_t canal) { return *_sensores[canal]; } // Sensor de um canal (configuração e demais leituras).
+    uint8_t lerPino(uint8_t canal) const { return _pinos[canal]; }      // Getter do pino de um canal.
+    static uint8_t numCanais() { return N; }                             // Número de canais do grupo.
+
+    // Custo médio por sensor em microssegundos (custo de uma passagem dividido pelo número de canais).
+    float lerCustoMedioPorSensor() const {
+      if (_passagens == 0) {
+        return 0.0;
+      }
+      return (float)_custoAcumulado / ((float)_passagens * N);
+    }
+
+    void zerarCusto() {
+      _custoAcumulado = 0;
+      _passagens = 0;
+    }
+};
+
+template <uint8_t N>
+class portaSensorOpticoPro : public grupoSensorOpticoPro<N>
+{
+  static_assert(N <= 8, "A amostragem por porta atende no maximo 8 canais (uma porta de 8 bits).");
+
+  protected:
+    volatile uint8_t* _registradorEntrada = nullptr; // Registrador de entrada da porta (PINx no AVR). nullptr se os pinos estiverem em portas diferentes.
+    uint8_t _mascaraCanal[N];                        // Bit de cada canal dentro da porta.
+    uint8_t _mascaraPorta = 0;                       // União dos bits de todos os canais.
+    uint8_t _portaAnterior = 0;                      // Leitura da porta na passagem anterior (apenas os bits dos canais).
+
+  public:
+    // Resolve a porta e os bits dos pinos uma única vez. Se os pinos não estiverem na mesma porta, atualizar() usa digitalRead() por pino.
+    portaSensorOpticoPro(sensorOpticoPro* const (&sensores)[N]) : grupoSensorOpticoPro<N>(sensores) {
+      uint8_t porta = digitalPinToPort(this->_pinos[0]);
+      bool mesmaPorta = (porta != NOT_A_PIN);
+      for (uint8_t i = 0; i < N; i++) {
+        _mascaraCanal[i] = digitalPinToBitMask(this->_pinos[i]);
+        _mascaraPorta |= _mascaraCanal[i];
+        mesmaPorta = mesmaPorta && (digitalPinToPort(this->_pinos[i]) == porta);
+      }
+      if (mesmaPorta) {
+        _registradorEntrada = portInputRegister(porta);
+      }
+    }
+
+    void iniciar(uint8_t numRiscos = 36) {
+      grupoSensorOpticoPro<N>::iniciar(numRiscos);
+      if (_registradorEntrada != nullptr) {
+        _portaAnterior = *_registradorEntrada & _mascaraPorta; // Leitura de referência para a primeira passagem.
+      }
+    }
+
+    // Uma passagem com uma única leitura da porta. Retorna a máscara dos canais com medição nova.
+    uint32_t atualizar() {
+      if (_registradorEntrada == nullptr) {
+        return grupoSensorOpticoPro<N>::atualizar(); // Pinos em portas diferentes: caminho por pino.
+      }
+
+      unsigned long instante = micros();
+      uint8_t porta = *_registradorEntrada & _mascaraPorta; // Uma leitura para todos os canais.
+      uint8_t mudou = porta ^ _portaAnterior;                // Bits que trocaram de nível desde a passagem anterior.
+      _portaAnterior = porta;
+
+      if (mudou != 0) { // Sem bordas (caso mais comum), nenhum canal é visitado.
+        for (uint8_t i = 0; i < N; i++) {
+          if (mudou & _mascaraCanal[i]) {
+            this->registrarBorda(i, instante, porta & _mascaraCanal[i]); // Subida ou descida, com o instante comum da porta.
+          }
+        }
+      }
+      uint32_t atualizados = this->calcularRPM();
+
+      this->_custoAcumulado += micros() - instante;
+      this->_passagens++;
+      return atualizados;
+    }
+
+    bool portaValida() const { return _registradorEntrada != nullptr; } // Indica se a amostragem por porta está em uso.
+};
+
+#endif // grupoSensorOpticoPro_h
@@ -0,0 +1,115 @@
+/*
+ * historicoBits.h
+ *
+ * Descrição: Histórico de amostras binárias (HIGH/LOW) compactado em bits,
+ * usado pela detecção de movimento do sensorOpticoPro. Cada amostra ocupa um
+ * bit de um vetor de bytes com capacidade fixa (definida na compilação), e a
+ * quantidade de amostras em HIGH dentro da janela é mantida por contagem
+ * incremental: a cada amostra nova soma-se o bit que entra e subtrai-se o bit
+ * que sai da janela, em O(1) e sem divisões.
+ *
+ * Funcionamento:
+ *   - O vetor é circular e sempre guarda as últimas 'CapacidadeBits' amostras,
+ *     independentemente do tamanho da janela em uso. A janela (1 até a
+ *     capacidade) pode ser alterada em execução sem realocar memória.
+ *   - Ao alterar a janela, a contagem é refeita com popcount sobre as últimas
+ *     amostras (8 amostras por operação). Todos os índices passam pela máscara
+ *     da capacidade, então nenhuma janela acessa memória fora do vetor.
+ *   - A capacidade deve ser potência de 2 (máscara no lugar do operador %).
+ *
+ * Memória: CapacidadeBits / 8 bytes de amostras + 6 bytes de controle
+ * (1024 amostras = 134 bytes, contra 2 bytes por amostra em um vetor de int).
+ *
+ * Não depende do Arduino.h, podendo ser compilada e testada no Linux.
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef historicoBits_h // Guarda de inclusão.
+#define historicoBits_h
+
+#include <inttypes.h> // Tipos inteiros de tamanho fixo.
+
+template <uint16_t CapacidadeBits>
+class historicoBits
+{
+  static_assert(CapacidadeBits >= 8 && CapacidadeBits <= 32768 && (CapacidadeBits & (CapacidadeBits - 1)) == 0,
+                "A capacidade do historico deve ser potencia de 2 entre 8 e 32768 amostras.");
+
+  private:
+    static const uint16_t MASCARA = CapacidadeBits - 1; // Substitui o operador % no avanço dos índices.
+
+    uint8_t _bits[CapacidadeBits / 8]; // Amostras compactadas: bit (posição & 7) do byte (posição >> 3).
+    uint16_t _posicao = 0;             // Próxima posição de escrita (a amostra mais recente está em _posicao - 1).
+    uint16_t _janela = 1;              // Quantidade de amostras recentes consideradas na contagem.
+    uint16_t _contagem = 0;            // Amostras em HIGH dentro da janela.
+
+    bool lerBit(uint16_t posicao) const {
+      return (_bits[posicao >> 3] >> (posicao & 7)) & 1;
+    }
+
+    // Conta os bits em HIGH de 'quantidade' posições a partir de 'inicio', um byte (popcount) por vez.
+    uint16_t contarBits(uint16_t inicio, uint16_t quantidade) const {
+      uint16_t total = 0;
+      while (quantidade > 0) {
+        uint8_t deslocamento = inicio & 7;
+        uint8_t tomar = 8 - deslocamento; // Bits restantes neste byte.
+        if (tomar > quantidade) {
+          tomar = quantidade;
+        }
+        uint8_t mascara = (uint8_t)(((1u << tomar) - 1) << deslocamento);
+        total += __builtin_popcount(_bits[inicio >> 3] & mascara);
+        inicio = (inicio + tomar) & MASCARA;
+        quantidade -= tomar;
+      }
+      return total;
+    }
+
+  public:
+    historicoBits() {
+      zerar();
+    }
+
+    // Apaga todas as amostras (todas passam a LOW). A janela é mantida.
+    void zerar() {
+      for (uint16_t i = 0; i < CapacidadeBits / 8; i++) {
+        _bits[i] = 0;
+      }
+      _posicao = 0;
+      _contagem = 0;
+    }
+
+    // Insere uma amostra e atualiza a contagem da janela em O(1).
+    void inserir(bool nivel) {
+      uint16_t saindo = (_posicao - _janela) & MASCARA; // Amostra que deixa a janela (com a janela cheia, é a própria posição sobrescrita).
+      _contagem -= lerBit(saindo);
+
+      uint8_t bit = (uint8_t)(1 << (_posicao & 7));
+      if (nivel) {
+        _bits[_posicao >> 3] |= bit;
+        _contagem++;
+      } else {
+        _bits[_posicao >> 3] &= (uint8_t)~bit;
+      }
+      _posicao = (_posicao + 1) & MASCARA;
+    }
+
+    // Altera a janela mantendo as amostras mais recentes. Retorna false (sem alterar nada) se estiver fora de 1..CapacidadeBits.
+    bool redimensionar(uint16_t novaJanela) {
+      if (novaJanela == 0 || novaJanela > CapacidadeBits) {
+        return false;
+      }
+      _janela = novaJanela;
+      _contagem = contarBits((_posicao - _janela) & MASCARA, _janela);
+      return true;
+    }
+
+    uint16_t lerContagem() const { return _contagem; }             // Amostras em HIGH dentro da janela.
+    uint16_t lerJanela() const { return _janela; }                 // Tamanho da janela em uso.
+    static uint16_t capacidade() { return CapacidadeBits; }        // Maior janela possível.
+    static uint16_t bytesAmostras() { return CapacidadeBits / 8; } // Memória ocupada pelas amostras.
+};
+
+#endif // historicoBits_h
@@ -0,0 +1,112 @@
+/*
+ * janelaVolta.h
+ *
+ * Descrição: Janela deslizante de uma volta para o estimador de RPM síncrono
+ * com a volta. Guarda os instantes das últimas numRiscos bordas de subida em
+ * um vetor circular; a cada borda, o instante que sai da janela é exatamente
+ * o da mesma posição do disco uma volta antes, então a duração da volta é
+ * (instante novo - instante que sai): uma subtração por borda, O(1), sem
+ * somar a janela.
+ *
+ * Como a medição sempre cobre a volta inteira, a soma das larguras dos riscos
+ * é 360 graus qualquer que seja o espaçamento: o erro de geometria do disco
+ * (riscos desiguais, excentricidade) se cancela sem calibração. O custo é a
+ * latência: a medição é a velocidade média da última volta, e a primeira só
+ * sai depois de uma volta completa.
+ *
+ * Riscos perdidos (um intervalo que cobre k riscos) entram como k instantes
+ * igualmente espaçados no intervalo, para que cada posição do vetor continue
+ * correspondendo a um risco do disco.
+ *
+ * Memória: os instantes (4 bytes por risco no AVR) são reservados na arena
+ * (arenaMemoria.h) apenas enquanto o estimador de uma volta está em uso, no
+ * tamanho exato do disco; no objeto ficam o ponteiro e 3 bytes de controle.
+ * O maior disco é fixado na compilação (SENSOR_OPTICO_MAX_RISCOS_VOLTA, até
+ * 255, o limite do numRiscos de 8 bits), e a arena tem pelo menos a janela
+ * dele.
+ *
+ * Não depende do Arduino.h, podendo ser compilada e testada no Linux.
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef janelaVolta_h // Guarda de inclusão.
+#define janelaVolta_h
+
+#include <inttypes.h>     // Tipos inteiros de tamanho fixo.
+#include "arenaMemoria.h" // Memória dos instantes, reservada apenas enquanto a janela está configurada.
+
+class janelaVolta
+{
+  private:
+    unsigned long* _instantes = nullptr; // Instantes (micros) das últimas numRiscos bordas (circular, na arena).
+    uint8_t _numRiscos = 0;              // Riscos do disco (tamanho útil da janela).
+    uint8_t _posicao = 0;                // Posição do instante mais antigo (o próximo a sair).
+    uint8_t _preenchidos = 0;            // Instantes na janela (até numRiscos).
+
+    // Insere um instante; retorna a duração da volta (0 enquanto a janela não tiver uma volta completa).
+    unsigned long inserir(unsigned long instante) {
+      unsigned long saindo = _instantes[_posicao];
+      _instantes[_posicao] = instante;
+      if (++_posicao >= _numRiscos) {
+        _posicao = 0;
+      }
+      if (_preenchidos < _numRiscos) {
+        _preenchidos++;
+        return 0;
+      }
+      return instante - saindo;
+    }
+
+  public:
+    // Reserva na arena os instantes de 'numRiscos' riscos (devolvendo os anteriores) e esvazia a janela.
+    // Retorna false, com a janela desligada, se a arena não tiver espaço.
+    bool configurar(uint8_t numRiscos, arenaMemoria& arena) {
+      liberar(arena);
+      _instantes = static_cast<unsigned long*>(arena.reservar(numRiscos * sizeof(unsigned long)));
+      if (_instantes == nullptr) {
+        return false;
+      }
+      _numRiscos = numRiscos;
+      zerar();
+      return true;
+    }
+
+    // Devolve os instantes à arena e desliga a janela (registrar() passa a retornar 0).
+    void liberar(arenaMemoria& arena) {
+      if (_instantes != nullptr) {
+        arena.liberar(_instantes);
+        _instantes = nullptr;
+      }
+      _numRiscos = 0;
+    }
+
+    void zerar() {
+      _posicao = 0;
+      _preenchidos = 0;
+    }
+
+    // Registra a borda de subida em 'instante' que encerrou um intervalo de 'riscos' riscos.
+    // Retorna a duração (micros) da última volta, ou 0 enquanto não houver uma volta completa.
+    unsigned long registrar(unsigned long instante, uint8_t riscos) {
+      if (_numRiscos == 0) {
+        return 0;
+      }
+      if (riscos > 1 && _preenchidos > 0) { // Riscos perdidos: instantes intermediários interpolados.
+        unsigned long anterior = _instantes[(_posicao == 0 ? _numRiscos : _posicao) - 1];
+        unsigned long parte = (instante - anterior) / riscos;
+        for (uint8_t r = 1; r < riscos; r++) {
+          inserir(anterior + parte * r);
+        }
+      }
+      return inserir(instante);
+    }
+
+    bool completa() const { return _numRiscos != 0 && _preenchidos >= _numRiscos; } // Já há uma volta na janela.
+    uint8_t lerNumRiscos() const { return _numRiscos; }
+    uint16_t bytes() const { return _numRiscos * sizeof(unsigned long); } // Memória ocupada na arena.
+};
+
+#endif // janelaVolta_h
@@ -0,0 +1,22 @@
+/*
+ * saidaAssincrona.cpp
+ *
+ * Descrição: Instância da saída assíncrona ligada à Serial.
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#include "saidaAssincrona.h" // Inclui o cabeçalho desta biblioteca.
+
+// Escreve na Serial apenas o que a fila calculou que cabe no buffer de transmissão (não bloqueia).
+static void escreverSerial(const uint8_t* dados, uint8_t tamanho) {
+  Serial.write(dados, tamanho);
+}
+
+static int espacoSerial() {
+  return Serial.availableForWrite();
+}
+
+saidaAssincrona saidaSerial(escreverSerial, espacoSerial);
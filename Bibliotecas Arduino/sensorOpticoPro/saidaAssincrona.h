@@ -0,0 +1,75 @@
+/*
+ * saidaAssincrona.h
+ *
+ * Descrição: Saída de texto e telemetria pela Serial sem bloquear a medição.
+ * saidaSerial é um Print (print, println e F() como na Serial) que escreve na
+ * filaSaida em vez de escrever direto na Serial; a transmissão acontece em
+ * saidaSerial.atender(), chamado a cada passagem do loop().
+ *
+ * Utilização:
+ *   saidaSerial.println(F("Resposta de um comando")); // Prioridade sobre a telemetria; nunca descartada.
+ *
+ *   saidaSerial.iniciarMensagem();                     // Telemetria: descartável, nunca bloqueia.
+ *   saidaSerial.print(F("RPM: "));
+ *   saidaSerial.println(rpm);
+ *   saidaSerial.concluirMensagem();
+ *
+ *   void loop() {
+ *     saidaSerial.atender(); // Transmite apenas o que cabe no buffer da Serial.
+ *     ...
+ *   }
+ *
+ * Tudo o que for escrito direto na Serial continua funcionando, mas pode cair
+ * no meio de uma mensagem da fila.
+ *
+ * Dependências:
+ *   - Arduino.h
+ *   - filaSaida.h (fila com prioridades e políticas de descarte)
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef saidaAssincrona_h // Guarda de inclusão.
+#define saidaAssincrona_h
+
+#include "Arduino.h"   // Print e Serial.
+#include "filaSaida.h" // Fila com prioridades (respostas antes da telemetria).
+
+// Capacidades da fila (podem ser redefinidas antes de incluir este cabeçalho).
+#ifndef SAIDA_CAPACIDADE_RESPOSTAS
+#define SAIDA_CAPACIDADE_RESPOSTAS 96   // Bytes de respostas guardados antes de o comando esperar pela Serial.
+#endif
+#ifndef SAIDA_CAPACIDADE_TELEMETRIA
+#define SAIDA_CAPACIDADE_TELEMETRIA 194 // Bytes de telemetria: dois quadros binários de 96 bytes (e o byte de tamanho de cada) ou ~14 linhas "RPM: ".
+#endif
+
+typedef filaSaida<SAIDA_CAPACIDADE_RESPOSTAS, SAIDA_CAPACIDADE_TELEMETRIA> filaSaidaSerial;
+
+class saidaAssincrona : public Print
+{
+  private:
+    filaSaidaSerial _fila;
+
+  public:
+    saidaAssincrona(EscritaSaida escrita, EspacoSaida espaco) : _fila(escrita, espaco) {}
+
+    size_t write(uint8_t valor) { // Base de print() e println().
+      _fila.escrever(valor);
+      return 1;
+    }
+    using Print::write;
+
+    void iniciarMensagem() { _fila.iniciarMensagem(); }   // Os próximos bytes formam uma mensagem de telemetria.
+    void concluirMensagem() { _fila.concluirMensagem(); } // A mensagem entra inteira na fila (ou é descartada inteira).
+    void enviarMensagem(const uint8_t* dados, uint8_t tamanho) { _fila.enviarMensagem(dados, tamanho); } // Quadro pronto como telemetria.
+    bool tentarEnviarMensagem(const uint8_t* dados, uint8_t tamanho) { return _fila.tentarEnviarMensagem(dados, tamanho); } // Só se couber, sem descartes.
+    void atender() { _fila.atender(); } // Transmite sem bloquear; chamar a cada passagem do loop().
+    void esvaziar() { _fila.esvaziar(); } // Transmite tudo, esperando a Serial.
+    filaSaidaSerial& lerFila() { return _fila; } // Política e contadores.
+};
+
+extern saidaAssincrona saidaSerial; // Saída única da Serial, compartilhada pelas bibliotecas e pelo sketch.
+
+#endif // saidaAssincrona_h
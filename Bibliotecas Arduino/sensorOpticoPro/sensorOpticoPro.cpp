@@ -46,26 +46,41 @@
  ******************************************************************************/
 
 sensorOpticoPro::sensorOpticoPro(uint8_t pinoSensor) 
-	: _pinoSensor(pinoSensor), _estadoAnterior(LOW), _tempoAlto(0)
+	: _pinoSensor(pinoSensor)
 {
 	// Configura o pino como entrada
         pinMode(_pinoSensor, INPUT);
 }
+
+sensorOpticoPro::~sensorOpticoPro()
+{
+	_janelaVolta.liberar(_arena);
+}
 		
 void sensorOpticoPro::configurarParametrosSensorOptico(uint8_t config_numRiscos, uint16_t config_rpmInicial) 
 {
 	///* Apenas para Depuração... */ Serial.println("Configurando os parametros (Número de Pulsos e RPM)...");
 
+    if (_geometriaFixa) {
+        saidaSerial.println(F("Número de riscos e RPM máximo fixados na compilação (sensorOpticoProFixo)."));
+        return;
+    }
     if (config_numRiscos <= 0) {
-        Serial.println("Número de riscos inválido.");
+        saidaSerial.println("Número de riscos inválido.");
         return;
     }
     if (config_rpmInicial < 0) {
-        Serial.println("O RPM não pode receber um Valor Negativo!");
+        saidaSerial.println("O RPM não pode receber um Valor Negativo!");
         return;
     }
     _numRiscos = config_numRiscos;
     _rpmMaximo = config_rpmInicial;
+    atualizarFatoresDisco();
+    _estado.indiceRisco = 0; // O índice do risco anterior pode não existir no disco novo.
+    _geometria.desativar();  // A tabela da geometria pertence ao disco anterior.
+    configurarJanelaVolta(); // A janela de uma volta muda de tamanho com o disco.
+    anunciarTelemetria();    // O receptor converte o risco em ângulo com o novo número de riscos.
+    _rpmPendente = true;     // A conversão da medição para RPM depende do número de riscos.
 
 	///* Apenas para Depuração... */ Serial.println("Parametros do Sensor Óptico configurados com sucesso.\n");
 
@@ -80,11 +95,19 @@ void sensorOpticoPro::configurarParametrosSensorOptico(uint8_t config_numRiscos,
  * Funções de Leitura de Valores
  ******************************************************************************/
 
-unsigned long sensorOpticoPro::lerInstanteInicial() 
+uint64_t sensorOpticoPro::lerInstanteInicial() 
 {
     return _instanteInicial;
 }
 
+void sensorOpticoPro::configurarBaseTempo(FonteTempo fonte) {
+    _baseTempo.configurarFonte(fonte);
+}
+
+baseTempo& sensorOpticoPro::lerBaseTempo() {
+    return _baseTempo;
+}
+
 uint16_t sensorOpticoPro::lerRpmDesejado() const {
     return _rpmMaximo;
 }
@@ -93,12 +116,153 @@ uint8_t sensorOpticoPro::lerNumRiscos() const {
     return _numRiscos;
 }
 
+uint8_t sensorOpticoPro::lerPinoSensor() const {
+    return _pinoSensor;
+}
+
+// As divisões por _numRiscos das leituras são feitas uma única vez por disco: as leituras usam os fatores resultantes.
+// Na sensorOpticoProFixo o disco é o do template e os fatores são calculados no construtor.
+void sensorOpticoPro::atualizarFatoresDisco() {
+    _fatorRpm = 60000000.0 / _numRiscos;
+    _grausPorRisco = 360.0 / _numRiscos;
+    _anguloBinarioPorRiscoQ16 = (uint32_t)((4294967296ULL + _numRiscos - 1) / _numRiscos); // Com 1 risco o índice é sempre 0.
+    _anguloPorRiscoQ32 = 0xFFFFFFFFUL / _numRiscos; // Volta completa = 2^32 (extrapolação do ângulo).
+}
+
+// O RPM é mantido em ponto fixo (M bordas em T micros). A divisão em float só acontece aqui, uma vez por medição nova.
 float sensorOpticoPro::lerRpmAtual() const {
+    if (_rpmPendente) {
+        _rpmPendente = false;
+        _rpmAtual = (_estado.periodoMedido == 0) ? 0.0 : (_fatorRpm * _estado.bordasMedidas) / (float)_estado.periodoMedido;
+    }
     return _rpmAtual;
 }
 
 float sensorOpticoPro::lerAnguloAtual() const {
-    return _anguloAtual;
+    return _estado.indiceRisco * _grausPorRisco;
+}
+
+float sensorOpticoPro::lerVelocidadeAngular() const {
+    // ω (rad/s) = (RPM * 2π) / 60
+    return (lerRpmAtual() * 2 * PI) / 60.0;
+}
+
+// Milésimos de RPM: 60e9 * M / (numRiscos * T). Numerador e divisor são calculados em 64 bits (apenas na leitura):
+// numRiscos * T passa de 32 bits em velocidades baixas (36 riscos e uma volta de mais de 2 minutos no estimador por volta).
+uint32_t sensorOpticoPro::lerRpmMili() const {
+    if (_estado.periodoMedido == 0) {
+        return 0;
+    }
+    return (uint32_t)((60000000000ULL * _estado.bordasMedidas) / ((uint64_t)_numRiscos * _estado.periodoMedido));
+}
+
+// Milirradianos por segundo: 2π * 1e9 * M / (numRiscos * T), com o divisor em 64 bits como em lerRpmMili().
+uint32_t sensorOpticoPro::lerVelocidadeAngularMiliRad() const {
+    if (_estado.periodoMedido == 0) {
+        return 0;
+    }
+    return (uint32_t)((6283185307ULL * _estado.bordasMedidas) / ((uint64_t)_numRiscos * _estado.periodoMedido));
+}
+
+// Ângulo binário: o índice do risco escalado para 16 bits, de modo que o estouro natural do uint16_t equivale a dar a volta.
+// Multiplicação e deslocamento no lugar da divisão; o fator arredondado para cima dá o mesmo resultado que (índice << 16) / numRiscos.
+uint16_t sensorOpticoPro::lerAnguloBinario() const {
+    return (uint16_t)(((uint32_t)_estado.indiceRisco * _anguloBinarioPorRiscoQ16) >> 16);
+}
+
+uint8_t sensorOpticoPro::lerIndiceRisco() const {
+    return _estado.indiceRisco;
+}
+
+float sensorOpticoPro::lerRpmRastreado() const {
+	return _rastreamentoAtivo ? _rastreamento.lerRpm(_numRiscos) : 0.0;
+}
+
+float sensorOpticoPro::lerAceleracaoRpm() const {
+	return _rastreamentoAtivo ? _rastreamento.lerAceleracaoRpm(_numRiscos) : 0.0;
+}
+
+// Filtro de rastreamento: os ganhos são recalculados apenas ao mudar o ruído de processo; cada borda custa ~10 operações em float.
+void sensorOpticoPro::ativarFiltroRastreamento(bool ativar) {
+	if (ativar && !_rastreamentoAtivo) {
+		_rastreamento.zerar(); // Recomeça a partir da próxima borda.
+	}
+	_rastreamentoAtivo = ativar;
+}
+
+bool sensorOpticoPro::novoRuidoProcesso(float ruido) {
+	if (!_rastreamento.configurarRuido(ruido)) {
+		saidaSerial.println(F("O ruído de processo deve ser maior que zero."));
+		return false;
+	}
+	return true;
+}
+
+const filtroRastreamento& sensorOpticoPro::lerFiltroRastreamento() const {
+	return _rastreamento;
+}
+
+// Coeficientes da extrapolação, recalculados na primeira leitura após uma borda nova (três divisões de 32 bits):
+//  - inverso do último intervalo (Q31), para obter a fração do risco percorrida sem dividir a cada leitura;
+//  - coeficiente de aceleração c (Q16). Com velocidade variando linearmente entre os pontos médios dos dois últimos
+//    intervalos (dt1 e dt2), a fração percorrida x = tau / dt2 corresponde a phi = x + c * (x + x^2) riscos, com
+//    c = (dt1 - dt2) * dt2 / (dt1 * (dt1 + dt2)), limitado a +-1/4 (variação de até ~50% entre riscos).
+void sensorOpticoPro::atualizarExtrapolacao() const {
+	_extrapolacaoPendente = false;
+	unsigned long dt2 = _estado.intervaloRisco;
+	unsigned long dt1 = _estado.intervaloRiscoAnterior;
+	if (dt2 == 0 || dt2 > 0x7FFFFFFFUL) {
+		_inversoIntervaloQ31 = 0; // Sem intervalo medido: sem extrapolação.
+		return;
+	}
+	_inversoIntervaloQ31 = 0x80000000UL / dt2;
+	if (dt1 == 0) {
+		_coefAceleracaoQ16 = 0; // Apenas um intervalo: velocidade constante.
+		return;
+	}
+
+	while (dt1 > 0xFFFF || dt2 > 0xFFFF) { // Mantém os produtos abaixo em 32 bits (a razão não muda).
+		dt1 >>= 1;
+		dt2 >>= 1;
+	}
+	long diferenca = (long)dt1 - (long)dt2;
+	if (dt1 == 0 || dt2 == 0 || labs(diferenca) * 4 >= (long)dt1) {
+		_coefAceleracaoQ16 = (diferenca > 0) ? 16384 : -16384;
+		return;
+	}
+	long razao = (diferenca << 16) / (long)dt1; // (dt1 - dt2) / dt1 em Q16, |razao| < 16384.
+	_coefAceleracaoQ16 = (int16_t)(razao * (long)dt2 / (long)(dt1 + dt2));
+}
+
+// Ângulo binário (65536 = uma volta) extrapolado para 'instante' a partir da última borda, da velocidade e da aceleração.
+// Custo constante e sem ponto flutuante: cinco multiplicações de 32 bits e deslocamentos (os coeficientes são
+// recalculados uma vez por borda). O ângulo não passa do próximo risco enquanto a borda dele não chegar.
+uint16_t sensorOpticoPro::lerAnguloEm(unsigned long instante) const {
+	if (_extrapolacaoPendente) {
+		atualizarExtrapolacao();
+	}
+	uint32_t angulo = (uint32_t)_estado.indiceRisco * _anguloPorRiscoQ32; // Ângulo da última borda (Q32).
+	unsigned long tau = instante - _estado.instanteUltimaSubida;
+	if (_inversoIntervaloQ31 == 0 || tau > 0x7FFFFFFFUL) { // Sem medição, ou instante anterior à última borda.
+		return (uint16_t)(angulo >> 16);
+	}
+
+	// Fração do risco x = tau / dt2 (Q16), limitada a dois intervalos para o produto caber em 32 bits.
+	unsigned long limite = 2 * _estado.intervaloRisco - 1;
+	uint32_t x = (uint32_t)(((tau < limite) ? tau : limite) * _inversoIntervaloQ31 >> 15);
+	uint32_t meioX = x >> 1;
+	long termo = (long)((x + ((meioX * meioX) >> 14)) >> 2); // (x + x^2) / 4, em Q16.
+	long fracao = (long)x + ((_coefAceleracaoQ16 * termo) >> 14);
+	if (fracao < 0) {
+		fracao = 0;
+	} else if (fracao > 0xFFFF) {
+		fracao = 0xFFFF; // Borda atrasada (desaceleração ou parada): espera no fim do risco.
+	}
+
+	// angulo += fracao * anguloPorRisco, em duas partes de 16 bits (a soma dá a volta naturalmente em 2^32).
+	uint32_t f = (uint32_t)fracao;
+	angulo += f * (_anguloPorRiscoQ32 >> 16) + ((f * (_anguloPorRiscoQ32 & 0xFFFF)) >> 16);
+	return (uint16_t)(angulo >> 16);
 }
 
 
@@ -108,12 +272,17 @@ void sensorOpticoPro::novoRpmMaximo(uint16_t novoRPM)
 {
 	/*
 	if (novoRPM < 0 || novoRPM > 65535) {
-        Serial.print("Erro: O valor para 'rpmDesejado' deve estar entre 1 e 1500.");
-        Serial.print(" Valor fornecido: ");
-        Serial.println(novoRPM);
+        saidaSerial.print("Erro: O valor para 'rpmDesejado' deve estar entre 1 e 1500.");
+        saidaSerial.print(" Valor fornecido: ");
+        saidaSerial.println(novoRPM);
         return; // Saída antecipada da função em caso de erro
     } /* */
 
+    if (_geometriaFixa) {
+        saidaSerial.println(F("RPM máximo fixado na compilação (sensorOpticoProFixo)."));
+        return;
+    }
+
     _rpmMaximo = novoRPM;
     _limiarCalculado = false; // Calcular o Limiar novamente.. (função calcularLimiarTempo)
 	calcularTempoMinimoEntrePulsacoes();
@@ -124,13 +293,24 @@ void sensorOpticoPro::novoNumRiscos(uint8_t novoNumRiscos)
 {
 	/*
 	if (novoNumRiscos < 1 || novoNumRiscos > 255) {
-        Serial.print("Erro: O valor para 'numRiscos' deve estar entre 1 e 255.");
-        Serial.print(" Valor fornecido: ");
-        Serial.println(novoNumRiscos);
+        saidaSerial.print("Erro: O valor para 'numRiscos' deve estar entre 1 e 255.");
+        saidaSerial.print(" Valor fornecido: ");
+        saidaSerial.println(novoNumRiscos);
         return; // Saída antecipada da função em caso de erro
     } /* */
 
+    if (_geometriaFixa) {
+        saidaSerial.println(F("Número de riscos fixado na compilação (sensorOpticoProFixo)."));
+        return;
+    }
+
     _numRiscos = novoNumRiscos;
+    atualizarFatoresDisco();
+    _estado.indiceRisco = 0; // O índice do risco anterior pode não existir no disco novo.
+    _geometria.desativar();  // A tabela da geometria pertence ao disco anterior.
+    configurarJanelaVolta(); // A janela de uma volta muda de tamanho com o disco.
+    anunciarTelemetria();    // O receptor converte o risco em ângulo com o novo número de riscos.
+    _rpmPendente = true;     // A conversão da medição para RPM depende do número de riscos.
 	calcularTempoMinimoEntrePulsacoes();
 }
 
@@ -139,9 +319,9 @@ void sensorOpticoPro::novoFatorAjusteLimiar(float novoFator)
 {
 	/*
 	if (novoFator <= 0.0) {
-        Serial.print("Erro: O valor para 'fatorAjusteLimiar' deve ser maior que 0.0.");
-        Serial.print(" Valor fornecido: ");
-        Serial.println(novoFator);
+        saidaSerial.print("Erro: O valor para 'fatorAjusteLimiar' deve ser maior que 0.0.");
+        saidaSerial.print(" Valor fornecido: ");
+        saidaSerial.println(novoFator);
         return; // Saída antecipada da função em caso de erro
     } /* */
 
@@ -152,30 +332,149 @@ void sensorOpticoPro::novoFatorAjusteLimiar(float novoFator)
 // Um valor maior aumenta a precisão, mas pode diminuir o desempenho.
 void sensorOpticoPro::novoNumAmostrasLimiar(uint16_t novoNumAmostrasLimiar) 
 {
-	/*
-	if (novoNumAmostrasLimiar < 0 || novoNumAmostrasLimiar > 65535) {
-        Serial.print("Erro: O valor ideal para 'numAmostrasLimiar' deve estar entre 1 e 100, números maiores podera causar atraso no calculo.");
-        Serial.print(" Valor fornecido: ");
-        Serial.println(novoNumAmostrasLimiar);
+	// Validação mantida: o desvio padrão exige pelo menos 2 tempos de cada nível.
+	if (novoNumAmostrasLimiar < 2) {
+        saidaSerial.print(F("Erro: O valor para 'numAmostrasLimiar' deve ser maior ou igual a 2."));
+        saidaSerial.print(F(" Valor fornecido: "));
+        saidaSerial.println(novoNumAmostrasLimiar);
         return; // Saída antecipada da função em caso de erro
-    } /* */
+    }
 
     _NUM_AMOSTRAS_calcLimiar = novoNumAmostrasLimiar;
 }
 
+uint16_t sensorOpticoPro::lerNumAmostrasLimiar() const {
+    return _NUM_AMOSTRAS_calcLimiar;
+}
+
+unsigned long sensorOpticoPro::lerLimiarPulsacoes() const {
+    return _limiarPulsacoes;
+}
+
+// O limiar calibrado vale para a velocidade da calibração. Limitado a 1/4 do período no RPM máximo, o filtro de nível
+// continua aceitando os pulsos reais até o RPM máximo com ciclo de trabalho entre 25% e 75%.
+unsigned long sensorOpticoPro::lerLimiarNivel() const {
+    if (!_limiarCalculado) {
+        return 0;
+    }
+    unsigned long limite = _tempoMinimoEntrePulsacoes / 4;
+    return (_limiarPulsacoes < limite) ? _limiarPulsacoes : limite;
+}
+
+unsigned long sensorOpticoPro::lerNiveisCurtos() const {
+    return _estado.niveisCurtos;
+}
+
+bool sensorOpticoPro::limiarCalibrado() const {
+    return _limiarCalculado;
+}
+
+void sensorOpticoPro::recalibrarLimiar() {
+    _limiarCalculado = false;
+    calcularLimiarIdeal();
+}
+
+float sensorOpticoPro::lerErroRelativoLimiar() const {
+    return _erroRelativoLimiar;
+}
+
+const estatisticaWelford& sensorOpticoPro::lerCalibracaoTempoAlto() const {
+    return _calibracaoAlto;
+}
+
+const estatisticaWelford& sensorOpticoPro::lerCalibracaoTempoBaixo() const {
+    return _calibracaoBaixo;
+}
+
 // Define o número de amostras utilizadas para o Calculo de Detecção de Movimento.
-// Um valor maior aumenta a precisão, mas pode diminuir o desempenho.
+// Um valor maior torna a detecção mais estável, com o mesmo custo por amostra (a janela é um histórico em bits de tamanho fixo).
 void sensorOpticoPro::novoNumAmostrasDetecMov(uint16_t novoNumAmostrasDetecMov) 
 {
-	/*
-	if (novoNumAmostrasDetecMov < 0 || novoNumAmostrasDetecMov > 65535) {
-        Serial.print("Erro: O valor ideal para 'numAmostrasDetecMov' deve estar entre 1 e 100, números maiores podera causar atraso no calculo.");
-        Serial.print(" Valor fornecido: ");
-        Serial.println(novoNumAmostrasDetecMov);
+	// Validação mantida: a janela não pode ultrapassar o histórico alocado na compilação.
+	if (!_historicoDetecMov.redimensionar(novoNumAmostrasDetecMov)) {
+        saidaSerial.print(F("Erro: O valor para 'numAmostrasDetecMov' deve estar entre 1 e "));
+        saidaSerial.print(_historicoDetecMov.capacidade());
+        saidaSerial.print(F(". Valor fornecido: "));
+        saidaSerial.println(novoNumAmostrasDetecMov);
         return; // Saída antecipada da função em caso de erro
-    } /* */
+    }
+
+    _inversoJanelaDetecMov = 1.0 / novoNumAmostrasDetecMov;
+}
+
+uint16_t sensorOpticoPro::lerNumAmostrasDetecMov() const {
+    return _historicoDetecMov.lerJanela();
+}
+
+// Seleciona o estimador de RPM. A janela M/T é reiniciada para não misturar bordas dos dois estimadores.
+void sensorOpticoPro::novoEstimadorRPM(EstimadorRPM novoEstimador)
+{
+    if (novoEstimador > ESTIMADOR_VOLTA) {
+        saidaSerial.println(F("Estimador de RPM inválido (0: período, 1: M/T, 2: volta)."));
+        return;
+    }
+    _estimadorRPM = novoEstimador;
+    _estado.bordasJanela = 0;
+    _estado.janelaIniciada = false;
+    configurarJanelaVolta();
+    anunciarTelemetria();
+}
 
-    _NUM_AMOSTRAS_detecMov = novoNumAmostrasDetecMov;
+// A janela de uma volta só ocupa a arena com o estimador de uma volta, no tamanho exato do disco.
+// Um disco acima de SENSOR_OPTICO_MAX_RISCOS_VOLTA, ou sem espaço na arena (janelas de outros sensores, captura em uso),
+// volta ao M/T. Até o limite, a janela sempre cabe na arena vazia.
+void sensorOpticoPro::configurarJanelaVolta()
+{
+    if (_estimadorRPM != ESTIMADOR_VOLTA) {
+        _janelaVolta.liberar(_arena);
+        return;
+    }
+    if (_numRiscos > SENSOR_OPTICO_MAX_RISCOS_VOLTA) {
+        _janelaVolta.liberar(_arena);
+        saidaSerial.print(F("Estimador de uma volta: disco de "));
+        saidaSerial.print(_numRiscos);
+        saidaSerial.print(F(" riscos acima de "));
+        saidaSerial.print((uint16_t)SENSOR_OPTICO_MAX_RISCOS_VOLTA);
+        saidaSerial.println(F(" (SENSOR_OPTICO_MAX_RISCOS_VOLTA). Usando o M/T."));
+        _estimadorRPM = ESTIMADOR_MT;
+    } else if (!_janelaVolta.configurar(_numRiscos, _arena)) {
+        saidaSerial.print(F("Estimador de uma volta: sem espaço na arena para "));
+        saidaSerial.print(_numRiscos);
+        saidaSerial.print(F(" riscos (livre: "));
+        saidaSerial.print(_arena.capacidade() - _arena.emUso());
+        saidaSerial.println(F(" bytes, SENSOR_OPTICO_TAMANHO_ARENA). Usando o M/T."));
+        _estimadorRPM = ESTIMADOR_MT;
+    }
+}
+
+// O quadro de configuração leva o número de riscos e o estimador: sem ele o receptor não converte o risco em ângulo.
+void sensorOpticoPro::anunciarTelemetria()
+{
+    if (_modoTelemetria == TELEMETRIA_BINARIA) {
+        _telemetria.configurar(_telemetria.lerSaida(), _numRiscos, _estimadorRPM);
+    }
+}
+
+// Define a taxa alvo de atualização do RPM no estimador M/T.
+// A janela mínima é 1/taxa: abaixo de uma borda por janela o estimador mede o período de uma única borda,
+// acima ele conta várias bordas, mantendo a resolução relativa próxima de (resolução do micros()) / (duração da janela).
+void sensorOpticoPro::novaTaxaAtualizacaoRPM(uint16_t novaTaxaHz)
+{
+	if (novaTaxaHz < 1 || novaTaxaHz > 1000) {
+        saidaSerial.println(F("Erro: A taxa de atualização do RPM deve estar entre 1 e 1000 Hz."));
+        return; // Saída antecipada da função em caso de erro
+    }
+
+    _taxaAtualizacaoRPM = novaTaxaHz;
+    _duracaoJanelaRPM = 1000000UL / novaTaxaHz;
+}
+
+EstimadorRPM sensorOpticoPro::lerEstimadorRPM() const {
+    return _estimadorRPM;
+}
+
+uint16_t sensorOpticoPro::lerTaxaAtualizacaoRPM() const {
+    return _taxaAtualizacaoRPM;
 }
 
 // A função transforma um valor numérico que representa um estado digital (alto ou baixo) em uma string descritiva.
@@ -189,7 +488,7 @@ String estadoLogicoParaTexto(int state) {
 
 void sensorOpticoPro::iniciar()
 {
-	/* Apenas para Depuração... */ Serial.println("Comunicação com o Sensor Óptico inicializada...");
+	/* Apenas para Depuração... */ saidaSerial.println("Comunicação com o Sensor Óptico inicializada...");
 	
  	// **Inicialização das variáveis:**
     // Nesta função, as variáveis globais são inicializadas com seus valores padrão.
@@ -198,23 +497,35 @@ void sensorOpticoPro::iniciar()
     // Isso significa que qualquer alteração feita em uma variável global dentro do `loop()` ou em outra função será mantida. 
 
 	// Reset das Variaveis - Os valores Utilizados são Valores Padrões
-	configurarParametrosSensorOptico(36, 1000); //Configura novo Número de Riscos do Disco e Rpm Solicitado caso seja nescessario...
-	_instanteInicial = millis(); // Serve para marcar o instante exato em que o programa começa a ser executado.
-    _instanteRpmInicial = millis(); // Inicializa _instanteRpmInicial
+	if (!_geometriaFixa) { // Na versão com geometria fixa (sensorOpticoProFixo) os valores vêm dos parâmetros do template.
+		configurarParametrosSensorOptico(36, 1000); //Configura novo Número de Riscos do Disco e Rpm Solicitado caso seja nescessario...
+	}
+	_instanteInicial = _baseTempo.lerMicros(); // Serve para marcar o instante exato em que o programa começa a ser executado (64 bits: não dá a volta).
+    _instanteRpmInicial = _instanteInicial; // Inicializa _instanteRpmInicial
     _velocidadeAngular = 0.0;       // Inicializa _velocidadeAngular
+    _rpmPendente = false;           // Nenhuma medição pendente de conversão
 	_limiarPulsacoes = 0; 
 	_fatorAjusteLimiar = 1.0; 
-	_tempoMinimoEntrePulsacoes = 0; 
-	_anguloAtual = 0.0; 
 	_rpmAtual = 0; 
 	_rpmAtualTemporario = _rpmMaximo; 
-	_NUM_AMOSTRAS_calcLimiar = 100;
-	_NUM_AMOSTRAS_detecMov = 100;
-	_estadoAnterior = -1; // Armazena o tempo alto anterior
-	_tempoAlto = 0;; // Armazena o tempo alto 
-	_tempoBaixo = 0;; // Armazena o tempo baixo 
-	_tempoAnterior = 0; // Declara _tempoAnterior
+	novoNumAmostrasLimiar(100);
+	_ajusteAtivo = false; // Ajuste da distância desligado até ser solicitado.
+	_analisadorAjuste.zerar();
 	_limiarPulsacoes = 0;
+	_limiarCalculado = false; // A calibração do limiar recomeça na próxima chamada de calcularRPM().
+	_calibrandoLimiar = false;
+	_estimadorRPM = ESTIMADOR_MT; // Estimador M/T a 50 Hz: resolução constante de 1 a mais de 10000 RPM.
+	_taxaAtualizacaoRPM = 50;
+	_duracaoJanelaRPM = 1000000UL / _taxaAtualizacaoRPM;
+	_estado = EstadoMedicao(); // Zera todo o estado de medição desta instância.
+	_geometria.desativar(); // A contagem dos riscos recomeça: a tabela da geometria perde a referência.
+	configurarJanelaVolta();
+	anunciarTelemetria(); // As diferenças da telemetria binária recomeçam junto com a medição.
+	_rastreamento.zerar();
+	novaCadeiaFiltro(_cadeiaFiltro);
+	_historicoDetecMov.zerar(); // Histórico da Detecção de Movimento vazio (todas as amostras em LOW).
+	novoNumAmostrasDetecMov(100);
+	_estado.estadoAnteriorRPM = digitalRead(_pinoSensor); // Evita uma borda falsa na primeira leitura.
 
 	///* Apenas para Depuração... */ Serial.println("Comunicação com o Sensor Óptico estabilizada...");
 }
@@ -231,6 +542,52 @@ bool sensorOpticoPro::statusConexaoSensorOptico() {
   return (status & STATUS_BIT_OK) == STATUS_BIT_OK;
 }
 
+// Relatório da memória ocupada por um sensor. Todos os vetores têm capacidade definida na compilação: os permanentes
+// ficam no objeto e os dos modos opcionais na arena, então o objeto e a arena são exatamente a RAM estática usada.
+void sensorOpticoPro::exibirRelatorioMemoria() const {
+  saidaSerial.print(F("RAM por sensor (bytes): "));
+  saidaSerial.println(sizeof(sensorOpticoPro));
+  saidaSerial.print(F("  Estado de medição: "));
+  saidaSerial.println(sizeof(_estado));
+  saidaSerial.print(F("  Fila de bordas: "));
+  saidaSerial.println(sizeof(_filaBordas));
+  saidaSerial.print(F("  Histórico da detecção de movimento ("));
+  saidaSerial.print(_historicoDetecMov.capacidade());
+  saidaSerial.print(F(" amostras): "));
+  saidaSerial.println(sizeof(_historicoDetecMov));
+  saidaSerial.print(F("  Calibração do limiar (sem vetor de amostras): "));
+  saidaSerial.println(sizeof(_calibracaoAlto) + sizeof(_calibracaoBaixo));
+  saidaSerial.print(F("  Ajuste da distância (histogramas): "));
+  saidaSerial.println(sizeof(_analisadorAjuste));
+  saidaSerial.print(F("  Geometria do disco ("));
+  saidaSerial.print(_geometria.capacidade());
+  saidaSerial.print(F(" riscos): "));
+  saidaSerial.println(sizeof(_geometria));
+  saidaSerial.print(F("  Cadeias de filtros (rápida, suave, robusta): "));
+  saidaSerial.println(sizeof(_cadeiaRapida) + sizeof(_cadeiaSuave) + sizeof(_cadeiaRobusta));
+  saidaSerial.print(F("  Janela de uma volta (instantes na arena: "));
+  saidaSerial.print(_janelaVolta.bytes());
+  saidaSerial.print(F(" bytes): "));
+  saidaSerial.println(sizeof(_janelaVolta));
+  saidaSerial.print(F("  Telemetria binária (quadro e contadores): "));
+  saidaSerial.println(sizeof(_telemetria));
+  saidaSerial.print(F("  Demais campos: "));
+  saidaSerial.println(sizeof(sensorOpticoPro) - sizeof(_estado) - sizeof(_filaBordas) - sizeof(_historicoDetecMov) - sizeof(_calibracaoAlto) - sizeof(_calibracaoBaixo) - sizeof(_analisadorAjuste) - sizeof(_geometria)
+                 - sizeof(_cadeiaRapida) - sizeof(_cadeiaSuave) - sizeof(_cadeiaRobusta) - sizeof(_janelaVolta) - sizeof(_telemetria));
+  saidaSerial.print(F("Compartilhado entre sensores (tabela de interrupções e arena): "));
+  saidaSerial.println(sizeof(_instanciasInterrupcao) + sizeof(_arena));
+  saidaSerial.print(F("  Arena: "));
+  saidaSerial.print(_arena.emUso());
+  saidaSerial.print(F(" de "));
+  saidaSerial.print(_arena.capacidade());
+  saidaSerial.print(F(" bytes em uso (maior uso: "));
+  saidaSerial.print(_arena.usoMaximo());
+  saidaSerial.print(F(", reservas recusadas: "));
+  saidaSerial.print(_arena.recusas());
+  saidaSerial.println(F(")"));
+  saidaSerial.println(F("Heap: 0"));
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // Métodos Privados (significa que eles só podem ser acessados internamente dentro da própria classe, e não de fora.)
@@ -279,7 +636,7 @@ uint8_t sensorOpticoPro::lerDadosDeRegistro(uint8_t indiceRegistro)
 	return dados;
 }
 
-void sensorOpticoPro::calcularVelocidadeAngular(float rpmAtual) {
+float sensorOpticoPro::calcularVelocidadeAngular(float rpmAtual) {
 	// A velocidade angular (ω) é a taxa de variação do ângulo em função do tempo. 
 	// Ela está relacionada ao RPM (rotações por minuto) pela seguinte fórmula:
 	// ω (rad/s) = (RPM * 2π) / 60
@@ -303,16 +660,15 @@ void sensorOpticoPro::calcularTempoMinimoEntrePulsacoes() {
 
 	*/
 
-	// Calculando o tempo em milissegundos entre cada pulso Utilizado o RPM Atual.
-	// Pode tambem ser usado o RPM desejado, porem pode não refletir a realidade se o RPM atual estiver significativamente diferente do RPM desejado, especialmente durante a fase de ajuste.
-	float tempoPorPulso = 60000.0 / (_rpmMaximo * _numRiscos);
-	//A constante 60000.0 na fórmula representa o número de milissegundos em um minuto. (Não deve ser Alterada, ela representa a conversão de minutos para milissegundos)
-	
-	// Adicionando uma margem de segurança e arredondando para cima
-	_tempoMinimoEntrePulsacoes = ceil(tempoPorPulso * 1.2); // Ajuste o fator de segurança conforme necessário
+	// Calculando o tempo em microssegundos entre cada pulso no RPM máximo (aritmética inteira, sem ceil()).
+	// Nenhum pulso válido chega antes disso, então este é o limite usado pelo filtro de glitches
+	// enquanto ainda não há períodos medidos suficientes para a mediana.
+	_tempoMinimoEntrePulsacoes = 60000000UL / ((unsigned long)_rpmMaximo * _numRiscos);
+	//A constante 60000000 na fórmula representa o número de microssegundos em um minuto.
 
 	//Obs: A variavel _tempoMinimoEntrePulsacoes representa o tempo mínimo esperado entre dois pulsos consecutivos, 
-	//	   calculado com base no RPM máximo esperado e no número de riscos do disco. 
+	//	   calculado com base no RPM máximo esperado e no número de riscos do disco. Depois que o filtro de glitches
+	//	   tem a mediana dos períodos, o limite passa a acompanhar a velocidade real (ver bordaEhGlitch).
 	//	   Ele serve como uma espécie de "filtro de histerese temporal", evitando leituras espúrias causadas por ruído ou vibração.
 
 	///* Apenas para Depuração... */ Serial.println("Calculo de Tempo Minimo Finalizado...");
@@ -330,37 +686,69 @@ unsigned long calcularLimiarTempo() {
 	return limiarTempo;
 } /* */
 
-//Calcula o limiar ideal para detectar pulsos, utilizando um filtro de média móvel e desvio padrão.
+//Inicia a calibração do limiar ideal para detectar pulsos, utilizando a média e o desvio padrão dos tempos em alto e em baixo.
 void sensorOpticoPro::calcularLimiarIdeal() { 
     /*
-    Esta função calcula o limiar ideal para detecção de pulsos,
-    usando a média e o desvio padrão de um conjunto de amostras
-    do valor *bruto* do sensor.
+    Esta função não bloqueia: ela apenas zera os acumuladores e ativa a calibração.
+    A cada transição, processarBorda() entrega a duração do nível que terminou para
+    acumularCalibracaoLimiar(), que atualiza média e variância em uma única passagem
+    (Welford, sem vetor de amostras) e aceita o limiar somente quando as médias convergirem.
+    Até lá, o limiar anterior continua valendo.
     */
-/*
-    // Coletar dados *brutos* do sensor (HIGH/LOW)
-    for (int i = 0; i < _NUM_AMOSTRAS_calcLimiar; i++) {
-        _amostras_calcLimiar[i] = digitalRead(_pinoSensor); // Lê diretamente o pino
-        //delayMicroseconds(50); // Adiciona um pequeno delay para espaçar as leituras (opcional)
-    }
-
-    // Calcular estatísticas dos dados coletados
-    double media = calcularMedia(_amostras_calcLimiar, _NUM_AMOSTRAS_calcLimiar);
-    double desvioPadrao = calcularDesvioPadrao(_amostras_calcLimiar, media, _NUM_AMOSTRAS_calcLimiar);
+	_calibracaoAlto.zerar();
+	_calibracaoBaixo.zerar();
+	_erroRelativoLimiar = 1.0;
+	_calibrandoLimiar = true;
+
+        saidaSerial.iniciarMensagem(); // Chamada também de dentro da medição (recalibração automática): não pode bloquear.
+        saidaSerial.println(F("Calibração do Limiar iniciada...")); // Imprime no Serial Monitor o início da calibração.
+        saidaSerial.concluirMensagem();
+}
 
-    // Calcular o limiar com base nas estatísticas e no fator de ajuste
-    _limiarPulsacoes = static_cast<uint8_t>(round(media + _fatorAjusteLimiar * desvioPadrao)); // Arredonda o valor para o inteiro mais próximo
+// Acumula a duração de um nível (alto ou baixo) e verifica a convergência da calibração do limiar.
+void sensorOpticoPro::acumularCalibracaoLimiar(bool nivelAlto, unsigned long duracao) {
+	estatisticaWelford& estatistica = nivelAlto ? _calibracaoAlto : _calibracaoBaixo;
+	if (!estatistica.adicionar((float)duracao)) {
+		calcularLimiarIdeal(); // Contador saturado sem convergir (velocidade variando): recomeça a calibração.
+		return;
+	}
 
-	//Obs: A variavel _limiarPulsacoes representa um limiar de amplitude para o sinal do sensor. 
-	//     Ele é calculado com base na média e no desvio padrão das leituras brutas do sensor e serve para 
-	//     distinguir entre um sinal de pulso válido e ruído.
-*/
+	// A convergência só é verificada depois do número mínimo de tempos de cada nível.
+	if (_calibracaoAlto.amostras() < _NUM_AMOSTRAS_calcLimiar || _calibracaoBaixo.amostras() < _NUM_AMOSTRAS_calcLimiar) {
+		return;
+	}
 
-	/* ***** Verificar essa Função Futuramente ***** */
-	_limiarPulsacoes = 1;
+	// Confiança: o pior erro relativo das duas médias.
+	float erroAlto = _calibracaoAlto.erroRelativo();
+	float erroBaixo = _calibracaoBaixo.erroRelativo();
+	_erroRelativoLimiar = (erroAlto > erroBaixo) ? erroAlto : erroBaixo;
+	if (_erroRelativoLimiar > SENSOR_OPTICO_ERRO_CONVERGENCIA_LIMIAR) {
+		return; // Ainda não convergiu: o limiar anterior continua valendo.
+	}
 
-        Serial.print(F("Limiar Calculado: ")); // Imprime no Serial Monitor a mensagem "Limiar Calculado: ".
-        Serial.println(_limiarPulsacoes); // Imprime o valor do limiar calculado.
+	// Calcular o limiar com base nas estatísticas e no fator de ajuste: a menor duração ainda compatível com os dois níveis.
+	float margem = 3.0 * _fatorAjusteLimiar;
+	float limiarAlto = _calibracaoAlto.media() - margem * _calibracaoAlto.desvioPadrao();
+	float limiarBaixo = _calibracaoBaixo.media() - margem * _calibracaoBaixo.desvioPadrao();
+	float limiar = (limiarAlto < limiarBaixo) ? limiarAlto : limiarBaixo;
+	_limiarPulsacoes = (limiar > 0.0) ? (unsigned long)limiar : 0;
+	_limiarCalculado = true;
+	_calibrandoLimiar = false;
+
+	//Obs: A variavel _limiarPulsacoes representa a menor duração (micros) de um nível alto ou baixo de um pulso válido.
+	//     Ela é calculada com base na média e no desvio padrão dos tempos medidos em cada nível e serve para 
+	//     distinguir entre um pulso válido e ruído.
+
+        saidaSerial.iniciarMensagem(); // Calibração concluída dentro da medição: mensagem da fila, sem bloquear.
+        saidaSerial.print(F("Limiar Calculado (micros): ")); // Imprime no Serial Monitor a mensagem "Limiar Calculado: ".
+        saidaSerial.print(_limiarPulsacoes); // Imprime o valor do limiar calculado.
+        saidaSerial.print(F(" | Erro relativo da média (%): "));
+        saidaSerial.print(_erroRelativoLimiar * 100.0, 3);
+        saidaSerial.print(F(" | Amostras (alto/baixo): "));
+        saidaSerial.print(_calibracaoAlto.amostras());
+        saidaSerial.print('/');
+        saidaSerial.println(_calibracaoBaixo.amostras());
+        saidaSerial.concluirMensagem();
 }
 
 		/************************************** Funções Auxiliares - calcularLimiarIdeal **************************************/
@@ -403,75 +791,20 @@ void sensorOpticoPro::calcularLimiarIdeal() {
 			// // Apenas para Depuração...   Serial.println(valorPulsoFiltrado);
 		} /* */
 
-		// Funções auxiliares para calcular média e desvio padrão
-		double sensorOpticoPro::calcularMedia(const uint16_t* dadosPulsos, int tamanho_calcMedia) {
-			if (tamanho_calcMedia == 0) {
-				return 0.0; // Retorna 0 se o vetor estiver vazio
-			}
-
-			// Calcula a soma de todos os elementos do vetor `dadosPulsos` de forma manual.
-			// A soma dos valores de pulso é calculada manualmente, iterando sobre o vetor 
-			// `dadosPulsos`. Essa abordagem é utilizada para evitar a dependência da biblioteca 
-			// `<numeric>`, que não está disponível no ambiente Arduino.
-			unsigned long soma_calcMedia = 0.0; // Usando unsigned long para a soma para evitar possíveis overflows com valores muito grandes
-			for (int i = 0; i < tamanho_calcMedia; i++) {
-				soma_calcMedia += dadosPulsos[i];
-			}
-
-
-			// Calculando a média
-			double media = soma_calcMedia / tamanho_calcMedia;
-
-			return media;
-
-			///* Apenas para Depuração... */ Serial.print("A média é: ");
-			///* Apenas para Depuração... */ Serial.println(media);
-		}
-
-		double sensorOpticoPro::calcularDesvioPadrao(const uint16_t* dadosPulsos, double media, int tamanho) {
-			if (tamanho <= 1) {
-				return 0.0; // Se houver apenas um dado ou nenhum, o desvio padrão é zero
-			}
-
-			// Calculando a soma dos quadrados das diferenças em relação à média
-			double somaQuadradosDiferencas = 0.0;
-			for (int i = 0; i < tamanho; i++) {
-				double diferenca = dadosPulsos[i] - media;
-				somaQuadradosDiferencas += pow(diferenca, 2); // Usando pow()
-			}
-
-			// Calculando a variância (média dos quadrados das diferenças)
-			double variancia = somaQuadradosDiferencas / tamanho;
-
-			// Calculando o desvio padrão (raiz quadrada da variância)
-			double desvioPadrao = sqrt(variancia); // Usando a função sqrt da biblioteca math.h
-
-			return desvioPadrao;
-
-			///* Apenas para Depuração... */ Serial.print("O Desvio Padrão é: ");
-			///* Apenas para Depuração... */ Serial.println(desvioPadrao);
-		}
 		/************************************** Fim das Funções Auxiliares - calcularLimiarIdeal **************************************/
 
 // Detecta movimento utilizando as transições de estado, qualquer transição para LOW ou HIGH indica movimento.
 Movimento sensorOpticoPro::detectarMovimento(bool estadoSensor) {
     Movimento movimento; // Retorna uma estrutura Movimento.
-    static int indice_detecMov = 0; // Índice para acessar o vetor de amostras circularmente
-    static float soma_detecMov = 0; // Soma das últimas amostras
 
-    int valorSensor = estadoSensor ? 1 : 0; // Converte o valor booleano para um valor numérico para facilitar o filtro (HIGH 1 e LOW 0)
+    // Insere a amostra no histórico em bits: a contagem de amostras em HIGH na janela é atualizada em O(1).
+    _historicoDetecMov.inserir(estadoSensor);
 
-    // Atualiza a soma e o índice do vetor de amostras
-    soma_detecMov -= _amostras_detecMov[indice_detecMov]; // Remove a amostra mais antiga da soma
-    soma_detecMov += valorSensor; // Adiciona a nova amostra à soma
-    _amostras_detecMov[indice_detecMov] = valorSensor; // Atualiza o valor da amostra no vetor
-    indice_detecMov = (indice_detecMov + 1) % _NUM_AMOSTRAS_detecMov; // Incrementa o índice e faz o rollover para o início do vetor
+    // Calcula a média móvel (multiplicação pelo inverso da janela, sem divisão)
+    movimento.valorFiltrado = _historicoDetecMov.lerContagem() * _inversoJanelaDetecMov; // Média das últimas amostras
 
-    // Calcula a média móvel
-    movimento.valorFiltrado = soma_detecMov / _NUM_AMOSTRAS_detecMov; // Calcula a média das últimas amostras
-
-    const float LIMIAR = 0.5; // Ajuste o limiar conforme necessário
-    movimento.movimentoDetectado = movimento.valorFiltrado > LIMIAR; // Define se houve movimento baseado em um limiar no valor filtrado
+    // Limiar de 0.5 comparado em inteiros: mais da metade das amostras da janela em HIGH.
+    movimento.movimentoDetectado = 2UL * _historicoDetecMov.lerContagem() > _historicoDetecMov.lerJanela(); // Define se houve movimento baseado em um limiar no valor filtrado
 
 	return movimento; // Retorna as informações sobre o movimento detectado.
 }
@@ -480,16 +813,15 @@ Movimento sensorOpticoPro::detectarMovimento(bool estadoSensor) {
 // Aumenta gradualmente o RPM desejado para permitir que o sensor se adapte às novas condições e para evitar picos de corrente no motor.
 void sensorOpticoPro::iniciarSensorOptico() {
 
-    Serial.println("Função iniciar Sensor Optico iniciada!"); 
+    saidaSerial.println("Função iniciar Sensor Optico iniciada!"); 
 
     // Leitura inicial para obter uma estimativa do RPM e limiar
     for (int i = 0; i < 10; i++) { //Inicia um loop que será executado 10 vezes (O objetivo deste loop é coletar dados iniciais do sensor para calcular valores como RPM e limiar.).
-		Serial.println("Obtendo Estimativa!"); 
-	    lerValorPulso(); // Realiza uma leitura do sensor e armazenar os dados.
-        calcularRPM(); // Calcula o RPM com base nos dados coletados.
+		saidaSerial.println("Obtendo Estimativa!"); 
+        calcularRPM(); // Lê as bordas pendentes e calcula o RPM com base nelas.
     }
 
-	Serial.println("Estimativa Obitida!"); 
+	saidaSerial.println("Estimativa Obitida!"); 
     // Ajuste gradual do RPM desejado
 	int rpmInicial = _rpmMaximo;
     for (int i = 0; i < 10; i++) { // Inicia um novo loop para ajustar gradualmente o RPM desejado.
@@ -497,7 +829,7 @@ void sensorOpticoPro::iniciarSensorOptico() {
         _rpmAtualTemporario = novoRpm;
 		
         // Verificar se o motor atingiu a velocidade desejada
-        if (_rpmAtual >= _rpmMaximo * 0.95) {
+        if (lerRpmAtual() >= _rpmMaximo * 0.95) {
             break; // Sai do loop se o motor estiver próximo da velocidade desejada
         }
 	}
@@ -522,278 +854,990 @@ enum Estado { //Define os possíveis estados da máquina de estados
 };
 
 
-/* ************************************ Calculo do RPM Com Filtro ************************************
+/* ************************************ Calculo do RPM ************************************
+ * A filtragem não é mais fixa no código: o intervalo entre bordas passa pela cadeia de filtros selecionada
+ * em novaCadeiaFiltro() (cadeiaFiltros.h), composta na compilação e escolhida em tempo de execução.
+ */
 float sensorOpticoPro::calcularRPM() {
-    // Variáveis estáticas mantêm seus valores entre as chamadas da função.
-    static unsigned long tempoUltimoPulsoValido = 0; // Armazena o tempo (em microssegundos) do último pulso válido detectado.
-    static float rpmAtual = 0; // Armazena o valor atual do RPM calculado.
-    static bool estadoAnteriorBruto = LOW; // Armazena o estado *bruto* (HIGH ou LOW) do sensor na iteração anterior.
-    static bool pulsoDetectado = false; // Flag para implementar o anti-rebote. Indica se um pulso já foi detectado na iteração atual.
+	if (atualizarMedicao()) {
+		publicarMedicao(lerRpmAtual()); // Texto (padrão), quadros binários ou nada, conforme configurarTelemetria().
+	}
+	verificarParada(_baseTempo.lerMicros()); // Sem bordas, a leitura decai e vai a zero no tempo limite.
 
-    unsigned long tempoAtual = micros(); // Obtém o tempo atual em microssegundos.
-    bool estadoBrutoAtual = digitalRead(_pinoSensor); // Lê o estado *bruto* atual do pino do sensor.
+	// Retorna o valor atual do RPM calculado (convertido para float somente se houve medição nova).
+	// Durante o decaimento o filtro de rastreamento não tem medição nova: vale o limite de 1 risco / tempo sem bordas.
+	return (_rastreamentoAtivo && !_estado.decaindo) ? lerRpmRastreado() : lerRpmAtual();
+}
 
-    // Verifica se o limiar ainda não foi calculado.
-    if (!_limiarCalculado) {
-        calcularLimiarIdeal(); // Chama a função para calcular o limiar ideal.
-        _limiarCalculado = true; // Define a flag _limiarCalculado como true para evitar recalcular o limiar.
-    }
+// Publica a medição nova. O texto formata o float e envia ~13 bytes pela Serial a cada medição; a telemetria binária
+// acrescenta ao quadro em montagem o instante da borda, o RPM em centésimos e o risco, em geral em 1 byte (variações
+// pequenas, RPM previsto pelo intervalo, risco seguinte ao anterior), e só chama a saída quando o quadro enche. O RPM chega já convertido (calcularRPM() o converte de qualquer forma para retornar).
+void sensorOpticoPro::publicarMedicao(float rpm) {
+	if (_modoTelemetria == TELEMETRIA_BINARIA) {
+		_telemetria.registrarAmostra(_estado.instanteUltimaSubida, (int32_t)(rpm * 100.0 + 0.5), _estado.indiceRisco);
+	} else if (_modoTelemetria == TELEMETRIA_TEXTO) {
+		saidaSerial.iniciarMensagem(); // Telemetria: descartada pela fila se a Serial não acompanhar.
+		saidaSerial.print("RPM: ");
+		saidaSerial.println(rpm);
+		saidaSerial.concluirMensagem();
+	}
+}
+
+void sensorOpticoPro::configurarTelemetria(TelemetriaRPM modo, SaidaTelemetria saida) {
+	if (modo > TELEMETRIA_BINARIA) {
+		saidaSerial.println(F("Telemetria inválida (0: desligada, 1: texto, 2: binária)."));
+		return;
+	}
+	_telemetria.descarregar(); // Amostras da configuração anterior saem pela saída anterior.
+	_modoTelemetria = modo;
+	if (modo == TELEMETRIA_BINARIA) {
+		_telemetria.configurar(saida, _numRiscos, _estimadorRPM);
+	}
+}
+
+TelemetriaRPM sensorOpticoPro::lerModoTelemetria() const {
+	return _modoTelemetria;
+}
+
+void sensorOpticoPro::descarregarTelemetria() {
+	_telemetria.descarregar();
+}
 
-    bool estadoFiltradoAtual = estadoBrutoAtual >= _limiarPulsacoes; // Aplica o limiar.
+const telemetriaBinaria<SENSOR_OPTICO_TAMANHO_QUADRO_TELEMETRIA>& sensorOpticoPro::lerTelemetria() const {
+	return _telemetria;
+}
 
-    // DETECÇÃO DE BORDA (USANDO O ESTADO *BRUTO* ANTERIOR)
-    // Verifica se houve uma *mudança* no sinal *bruto* (tanto de LOW para HIGH quanto de HIGH para LOW).
-    if (estadoBrutoAtual != estadoAnteriorBruto) { // Mudança aqui! Verifica se o estado mudou
-        // Verifica se o sinal *filtrado* também corresponde à mudança e se um pulso já foi detectado nesta iteração.
-        if (estadoFiltradoAtual != (estadoAnteriorBruto >= _limiarPulsacoes) && !pulsoDetectado) { // Mudança aqui! Verifica se o estado filtrado corresponde a mudança bruta.
-            pulsoDetectado = true; // Define a flag pulsoDetectado como true para evitar recontagens durante o mesmo pulso.
+void sensorOpticoPro::escreverTelemetriaSerial(const uint8_t* quadro, uint8_t tamanho) {
+	saidaSerial.enviarMensagem(quadro, tamanho); // Um quadro por mensagem: descartado inteiro, nunca pela metade.
+}
 
-            unsigned long tempoDecorrido = tempoAtual - tempoUltimoPulsoValido; // Calcula o tempo decorrido desde o último pulso válido.
+void sensorOpticoPro::associarCaptura(capturaBordasSensor* captura) {
+	_captura = captura;
+}
 
-            // FILTRO DE TEMPO MÍNIMO
-            if (tempoDecorrido >= _tempoMinimoEntrePulsacoes * 1000) { // Converte milissegundos para microssegundos.
-                tempoUltimoPulsoValido = tempoAtual; // Atualiza o tempo do último pulso válido.
+capturaBordasSensor* sensorOpticoPro::lerCaptura() const {
+	return _captura;
+}
 
-                if (tempoDecorrido > 0) { // Evita divisão por zero.
-                    float tempoDecorridoSegundos = (float)tempoDecorrido / 1000000.0; // Converte para segundos.
-                    rpmAtual = 60.0 / ((float)_numRiscos * tempoDecorridoSegundos); // Calcula o RPM.
+// A captura não pode ter lacunas: o quadro só entra na fila se couber, senão espera na própria captura.
+bool sensorOpticoPro::enviarCapturaSerial(const uint8_t* quadro, uint8_t tamanho) {
+	return saidaSerial.tentarEnviarMensagem(quadro, tamanho);
+}
 
-                    calcularVelocidadeAngular(rpmAtual); // Calcula a Velocidade Angular
+// Parada do disco: a medição só muda nas bordas de subida, então sem elas a última leitura valeria para sempre.
+// Enquanto a borda seguinte não chega, o disco percorreu menos de um risco desde a última borda: a velocidade é no
+// máximo 1 risco / tempo decorrido. Depois de 1,25 período sem bordas (a folga de 25% evita quedas na leitura pelo
+// espaçamento irregular dos riscos), a leitura passa a decair com esse limite, contínua com a medição; no tempo limite
+// vai a zero e gera o evento de parada. A parada física nunca acontece antes da última borda, então o pior caso entre
+// a parada e a leitura zero é o tempo limite mais o intervalo entre as chamadas.
+// O tempo sem bordas é medido em 64 bits: a parada é detectada mesmo que as chamadas fiquem mais de meia volta do micros() sem acontecer.
+bool sensorOpticoPro::verificarParada(uint64_t instante) {
+	if (!_estado.girando || instante < _estado.instanteUltimaSubidaEstendido) {
+		return false; // Parado, ou instante anterior à última borda (borda processada depois da leitura do relógio).
+	}
+	if (_estado.transicaoPendente && _estado.nivelPendente == HIGH) {
+		// Já há uma borda de subida, esperando o filtro de nível: o intervalo não é falta de bordas e a medição guardada volta.
+		if (!_estado.decaindo) {
+			return false;
+		}
+		_estado.decaindo = false;
+		registrarMedicao(_estado.bordasSemDecaimento, _estado.periodoSemDecaimento);
+		return true;
+	}
+	if (instante - _estado.instanteUltimaSubidaEstendido >= _tempoLimiteParada) {
+		registrarParada();
+		if (_modoTelemetria == TELEMETRIA_BINARIA) {
+			_telemetria.registrarEvento((uint32_t)instante, EVENTO_PARADA);
+		}
+		if (_captura != nullptr) {
+			_captura->descarregar(); // As últimas bordas antes da parada não esperam o quadro encher.
+		}
+		return true;
+	}
+	unsigned long decorrido = (unsigned long)(instante - _estado.instanteUltimaSubidaEstendido); // Menor que o tempo limite: cabe em 32 bits.
+
+	uint16_t bordas = _estado.decaindo ? _estado.bordasSemDecaimento : _estado.bordasMedidas;
+	unsigned long periodo = _estado.decaindo ? _estado.periodoSemDecaimento : _estado.periodoMedido;
+	if (bordas == 0) {
+		return false; // Ainda sem medição.
+	}
+	unsigned long folga = periodo / bordas / 4;
+	if (decorrido <= periodo / bordas + folga) {
+		return false;
+	}
+	if (!_estado.decaindo) {
+		_estado.bordasSemDecaimento = bordas; // A medição volta se a próxima borda não fechar uma nova (janela M/T aberta).
+		_estado.periodoSemDecaimento = periodo;
+		_estado.decaindo = true;
+	}
+	registrarMedicao(1, decorrido - folga);
+	return true;
+}
 
-                    unsigned long tempoDecorridoAngulo = tempoAtual - _tempoAnteriorAngulo; //Calcula o tempo decorrido para calcular o angulo com base no tempo
-                    _tempoAnteriorAngulo = tempoAtual;//Atualiza o tempo anterior
+// Zera a leitura e as referências de velocidade: a primeira borda depois da parada não é comparada com a velocidade antiga.
+void sensorOpticoPro::registrarParada() {
+	_estado.girando = false;
+	_estado.decaindo = false;
+	_estado.fragmentoPendente = false; // A borda suspeita antes da parada não tem mais com o que ser comparada.
+	_estado.eventosMovimento |= EVENTO_PARADA;
+	_estado.janelaIniciada = false;   // A primeira borda abre uma nova janela M/T.
+	_estado.intervalosValidos = 0;    // A mediana do filtro de glitches e da correção de pulsos recomeça.
+	_estado.indiceIntervalo = 0;
+	_estado.intervaloRisco = 0;       // Sem extrapolação do ângulo.
+	_estado.intervaloRiscoAnterior = 0;
+	_extrapolacaoPendente = true;
+	_rastreamento.zerar();
+	_janelaVolta.zerar();
+	novaCadeiaFiltro(_cadeiaFiltro);
+	registrarMedicao(0, 0);
+}
 
-                    float incrementoAngulo = _velocidadeAngular * (tempoDecorridoAngulo / 1000000.0); // Calcula o incremento do ângulo com base na velocidade angular.
-                    _anguloAtual += incrementoAngulo;//Soma o incremento ao angulo atual
-                    _anguloAtual = fmod(_anguloAtual, 2 * PI); // Mantém o ângulo entre 0 e 2PI
+void sensorOpticoPro::novoTempoParada(uint16_t milissegundos) {
+	if (milissegundos == 0) {
+		saidaSerial.println(F("O tempo limite de parada deve ser maior que zero."));
+		return;
+	}
+	_tempoLimiteParada = milissegundos * 1000UL;
+}
 
-                    float anguloGrausCalculado = _anguloAtual * (180.0 / PI); // Converte para graus
+uint16_t sensorOpticoPro::lerTempoParada() const {
+	return (uint16_t)(_tempoLimiteParada / 1000UL);
+}
 
-                    Serial.print("RPM: "); Serial.println(rpmAtual);
-                    Serial.print("Angulo Calculado: "); Serial.println(anguloGrausCalculado);
-                }
-            }
-        }
-    } else {
-        pulsoDetectado = false; // Reseta a flag pulsoDetectado quando o sinal *bruto* não mudou.
-    }
+bool sensorOpticoPro::girando() const {
+	return _estado.girando;
+}
 
-    estadoAnteriorBruto = estadoBrutoAtual; // Atualiza o estado *bruto* anterior.
+uint8_t sensorOpticoPro::lerEventosMovimento() {
+	uint8_t eventos = _estado.eventosMovimento;
+	_estado.eventosMovimento = EVENTO_NENHUM;
+	return eventos;
+}
 
-    return rpmAtual; // Retorna o valor atual do RPM calculado.
-} /* */
+// Consome as bordas pendentes (fila da interrupção ou leitura do pino) e retorna true se houve medição nova.
+bool sensorOpticoPro::atualizarMedicao() {
+	// Verifica se o limiar ideal já foi calculado. Se não, inicia a calibração (concluída ao longo das próximas bordas).
+	if (!_limiarCalculado && !_calibrandoLimiar) {
+		// Chama a função para Calcular o Limiar Ideal.
+		calcularLimiarIdeal(); 
+	}
 
+	// Indica se alguma borda desta chamada gerou um novo valor de RPM (para imprimir uma única vez).
+	bool rpmAtualizado = false;
+	// Lido antes de esvaziar a fila: toda borda anterior a este instante já está na fila, então a transição pendente
+	// que passar do limiar em 'agora' não pode mais ser desfeita por uma borda ainda não processada.
+	unsigned long agora = (unsigned long)_baseTempo.lerMicros();
+
+	if (_capturaPorInterrupcao) {
+		// As bordas foram capturadas pela interrupção: esvazia a fila em lotes, na ordem em que ocorreram.
+		// Assim nenhuma borda é perdida, mesmo que o loop() tenha demorado (Serial, comandos, etc.).
+		RegistroBorda lote[SENSOR_OPTICO_TAMANHO_LOTE];
+		uint8_t quantidade;
+		while ((quantidade = _filaBordas.retirarLote(lote, SENSOR_OPTICO_TAMANHO_LOTE)) > 0) {
+			for (uint8_t i = 0; i < quantidade; i++) {
+				rpmAtualizado |= processarBorda(lote[i].instante, lote[i].nivel);
+			}
+		}
+	} else {
+		// Varredura: lê o pino uma vez por chamada. Bordas que ocorrerem enquanto o loop está ocupado são perdidas.
+		bool estadoAtual_Sensor = digitalRead(_pinoSensor); // Lê o estado atual do pino do sensor (HIGH ou LOW).
 
-/* ************************************ Calculo do RPM sem Filtro ************************************/
-float sensorOpticoPro::calcularRPM() {
-    // Obtém o tempo atual em microssegundos.
-    unsigned long tempoAtual = micros();
+		// Só existe borda quando o nível mudou desde a última chamada (a transição pendente já é o último nível recebido).
+		uint8_t nivelRecebido = _estado.transicaoPendente ? _estado.nivelPendente : _estado.estadoAnteriorRPM;
+		if (estadoAtual_Sensor != nivelRecebido) {
+			rpmAtualizado = processarBorda(agora, estadoAtual_Sensor);
+		}
+	}
 
-    // Variável para armazenar o tempo decorrido entre dois pulsos consecutivos.
-    unsigned long tempoDecorrido = 0;
+	if (_estado.transicaoPendente) {
+		rpmAtualizado |= confirmarTransicaoPendente(agora); // Sem borda nova: o nível pendente já pode ter durado o limiar.
+	}
 
-    // Variável estática para armazenar o tempo do último pulso detectado em microssegundos.
-    // "static" significa que a variável mantém seu valor entre as chamadas da função.
-    static unsigned long tempoUltimoPulso = 0;
-	
-    // Variável estática para armazenar o valor atual do RPM.
-    // "static" garante que o valor seja mantido entre as chamadas da função.
-    static float rpmAtual = 0;
+	if (_captura != nullptr) {
+		_captura->atender(); // Quadros prontos da captura de bordas seguem para a fila de saída.
+	}
+
+	return rpmAtualizado;
+}
 
-    // Lê o estado atual do pino do sensor (HIGH ou LOW).
-    bool estadoAtual_Sensor = digitalRead(_pinoSensor);
+// Processa uma borda do sinal (vinda da varredura ou da fila de interrupção) e recalcula o RPM nas bordas de subida.
+// Filtro de nível: com o limiar calibrado, cada transição fica pendente até o novo nível durar o limiar. Se a transição
+// seguinte chegar antes, o nível era um pulso espúrio (glitch no nível baixo ou falha no nível alto) e as duas transições
+// são descartadas juntas, em qualquer posição do período. A transição aceita entra com o seu próprio instante.
+// Um glitch logo depois de uma borda real anula a borda real com a primeira metade do glitch; quando a segunda metade
+// também chega antes do limiar, o menor dos dois níveis curtos é o glitch e a borda real é restaurada.
+bool sensorOpticoPro::processarBorda(unsigned long instante, uint8_t nivel) {
+	// A captura registra exatamente as bordas que a medição recebe, antes de qualquer filtro.
+	if (_captura != nullptr) {
+		_captura->registrar(instante, nivel);
+	}
 
-    // Variável estática para armazenar o estado anterior do pino do sensor.
-    // Usada para detectar a transição de LOW para HIGH (subida do pulso).
-    static bool estadoAnterior_Sensor = LOW;
+	bool rpmAtualizado = false;
+	unsigned long limiar = lerLimiarNivel();
+	if (_estado.transicaoPendente) {
+		if (nivel == _estado.nivelPendente) {
+			return false; // Mesmo nível da transição pendente: nenhuma transição nova.
+		}
+		if (instante - _estado.instanteTransicaoPendente < limiar) {
+			_estado.transicaoPendente = false; // O nível pendente não durou o limiar: volta ao nível anterior.
+			_estado.transicaoAnulada = true;
+			_estado.instanteTransicaoAnulada = _estado.instanteTransicaoPendente;
+			_estado.instanteAnulacao = instante;
+			_estado.niveisCurtos++;
+			return false;
+		}
+		rpmAtualizado = confirmarTransicaoPendente(instante);
+	}
 
-	// Verifica se o limiar ideal já foi calculado. Se não, calcula e imprime.
-	if (!_limiarCalculado) {
-		// Chama a função para Calcular o Limiar Ideal.
-		calcularLimiarIdeal(); 
-        // Imprime o valor do limiar calculado no Serial Monitor.
-		Serial.print(F("Limiar Calculado: "));
-		Serial.println(_limiarPulsacoes);
-		// Marca o limiar como calculado para evitar recalcular a cada chamada da função.
-		_limiarCalculado = true;
+	if (limiar == 0) {
+		return processarTransicao(instante, nivel) || rpmAtualizado;
 	}
-	
-    // Verifica se houve uma transição de LOW para HIGH no sinal do sensor.
-    // Isso indica a detecção de um novo pulso.
-    if (estadoAtual_Sensor == HIGH && estadoAnterior_Sensor == LOW) {
-        // Calcula o tempo decorrido desde o último pulso.
-        tempoDecorrido = tempoAtual - tempoUltimoPulso;
-
-        // Atualiza o tempo do último pulso para o tempo atual.
-        tempoUltimoPulso = tempoAtual;
-
-        // Verifica se o tempo decorrido é maior que zero para evitar divisão por zero.
-        if (tempoDecorrido > 0) {
-            // Imprime o tempo decorrido em microssegundos para fins de debug.
-            // Apenas para Depuração... Serial.print("Tempo Decorrido (micros): ");
-            // Apenas para Depuração... Serial.println(tempoDecorrido);
-
-            // Cálculo do RPM com prevenção de overflow e melhor precisão:
-            // Usamos ponto flutuante desde o início para evitar perdas de precisão
-            // e convertemos _numRiscos para float para evitar overflow na multiplicação
-
-            // Converte o tempo decorrido de microssegundos para segundos.
-            float tempoDecorridoSegundos = (float)tempoDecorrido / 1000000.0;
-
-            // Calcula o RPM:
-            // 60 segundos/minuto / (número de riscos * tempo entre pulsos em segundos)
-            // A conversão de _numRiscos para float garante que a multiplicação seja feita em ponto flutuante,
-            // evitando possível overflow se _numRiscos e tempoDecorridoSegundos fossem inteiros.
-            rpmAtual = 60.0 / ((float)_numRiscos * tempoDecorridoSegundos);
-
-            // Imprime o valor do RPM calculado para fins de debug.
-            Serial.print("RPM: ");
-            Serial.println(rpmAtual);
-        }
+	if (nivel == _estado.estadoAnteriorRPM) {
+		return rpmAtualizado;
+	}
+	unsigned long inicio = instante;
+	if (_estado.transicaoAnulada) {
+		_estado.transicaoAnulada = false;
+		unsigned long primeiro = _estado.instanteAnulacao - _estado.instanteTransicaoAnulada; // Nível desfeito.
+		unsigned long segundo = instante - _estado.instanteAnulacao;                         // Nível que o desfez.
+		if (segundo < limiar && primeiro >= segundo) {
+			inicio = _estado.instanteTransicaoAnulada; // O glitch era o segundo nível: a transição anulada era a real.
+		}
+	}
+	_estado.transicaoPendente = true;
+	_estado.instanteTransicaoPendente = inicio;
+	_estado.nivelPendente = nivel;
+	return rpmAtualizado;
+}
+
+// Aplica a transição pendente quando o nível dela já durou o limiar em 'agora'.
+bool sensorOpticoPro::confirmarTransicaoPendente(unsigned long agora) {
+	if (agora - _estado.instanteTransicaoPendente < lerLimiarNivel()) {
+		return false;
+	}
+	_estado.transicaoPendente = false;
+	_estado.transicaoAnulada = false;
+	return processarTransicao(_estado.instanteTransicaoPendente, _estado.nivelPendente);
+}
+
+// Transição aceita pelo filtro de nível: calibração, ajuste e, na subida, riscos, ângulo e RPM.
+bool sensorOpticoPro::processarTransicao(unsigned long instante, uint8_t nivel) {
+	// Atualiza o estado anterior para a próxima detecção de borda.
+	bool subida = (nivel == HIGH && _estado.estadoAnteriorRPM == LOW);
+	bool transicao = (nivel != _estado.estadoAnteriorRPM);
+	_estado.estadoAnteriorRPM = nivel;
+
+	// Duração do nível que terminou (alto na descida, baixo na subida): calibração do limiar e ajuste da distância.
+	// Parado não há borda anterior de referência (o nível pode ter durado mais que uma volta do micros()).
+	if (transicao) {
+		if (_estado.girando) {
+			unsigned long duracao = instante - _estado.instanteUltimaBorda;
+			if (_calibrandoLimiar && duracao >= _tempoMinimoEntrePulsacoes / 4) { // Mais curto não é nível válido até o RPM máximo: glitches fora da estatística.
+				acumularCalibracaoLimiar(!subida, duracao);
+			}
+			if (_ajusteAtivo) {
+				_analisadorAjuste.registrar(!subida, duracao);
+			}
+			if (_marcaIndice == MARCA_RISCO_LARGO && !subida) {
+				verificarMarcaLarga(duracao);
+			}
+		}
+		_estado.instanteUltimaBorda = instante;
+	}
+
+	// Apenas a transição de LOW para HIGH indica um novo pulso.
+	if (!subida) {
+		return false;
+	}
+	return processarCandidataSubida(instante);
+}
+
+// Pulsos extras: uma borda espúria divide o período em dois fragmentos. Antes da fração do filtro de glitches ela é
+// rejeitada na hora (bordaEhGlitch). Entre a fração e SENSOR_OPTICO_FRACAO_FRAGMENTO % do período previsto, a borda fica
+// pendente e é decidida pela borda seguinte: se o intervalo desde a última borda aceita ficar mais perto de um múltiplo
+// do período do que o primeiro fragmento, e os dois fragmentos forem desiguais, a borda do meio era espúria e os dois
+// formam um único intervalo. Fragmentos a até 1/8 um do outro são o período novo de uma aceleração; uma borda já
+// rejeitada no intervalo indica um degrau de velocidade (a borda adiantada é a segunda do período novo): nos dois casos
+// a borda pendente é aceita com o seu próprio instante. Sem isso, a borda espúria seria aceita e a real seguinte
+// rejeitada como glitch. Só as bordas adiantadas esperam uma borda; as demais são aceitas na hora.
+bool sensorOpticoPro::processarCandidataSubida(unsigned long instante) {
+	// A borda da partida não tem borda anterior para comparar (instanteUltimaSubida é de antes da parada, ou zero).
+	if (!_estado.girando) {
+		return processarSubida(instante);
+	}
+
+	bool rpmAtualizado = false;
+	if (_estado.fragmentoPendente) {
+		_estado.fragmentoPendente = false;
+		unsigned long periodoPrevisto = lerPeriodoMediano();
+		unsigned long primeiro = _estado.instanteFragmento - _estado.instanteUltimaSubida;
+		unsigned long segundo = instante - _estado.instanteFragmento;
+		unsigned long unido = instante - _estado.instanteUltimaSubida;
+		bool regulares = ((primeiro > segundo) ? primeiro - segundo : segundo - primeiro) * 8 <= primeiro;
+		if (!regulares && multiploPeriodo(unido, periodoPrevisto) != 0
+		    && restoMultiplo(unido, periodoPrevisto) < restoMultiplo(primeiro, periodoPrevisto)) {
+			// A borda do meio era espúria: o intervalo unido substitui o do fragmento na mediana.
+			uint8_t ultimo = (_estado.indiceIntervalo + SENSOR_OPTICO_INTERVALOS_MEDIANA - 1) % SENSOR_OPTICO_INTERVALOS_MEDIANA;
+			_estado.intervalosCandidatos[ultimo] = unido;
+			_estado.bordasRejeitadas++;
+			return processarSubida(instante);
+		}
+		rpmAtualizado = processarSubida(_estado.instanteFragmento);
+	}
+
+	// Bordas que chegam cedo demais em relação aos últimos períodos são ruído: não contam risco nem tempo.
+	if (bordaEhGlitch(instante)) {
+		_estado.glitchNoIntervalo = true;
+		return rpmAtualizado;
+	}
+
+	unsigned long periodoPrevisto = lerPeriodoMediano();
+	unsigned long decorrido = instante - _estado.instanteUltimaSubida;
+	if (_correcaoPulsos && !_estado.glitchNoIntervalo && periodoPrevisto != 0
+	    && decorrido * 100 < periodoPrevisto * SENSOR_OPTICO_FRACAO_FRAGMENTO) {
+		_estado.fragmentoPendente = true;
+		_estado.instanteFragmento = instante;
+		return rpmAtualizado;
+	}
+	return processarSubida(instante) || rpmAtualizado;
+}
+
+// Borda de subida aceita: avança os riscos e o ângulo e atualiza o estimador selecionado.
+bool sensorOpticoPro::processarSubida(unsigned long instante) {
+	// Calcula o tempo decorrido desde o último pulso e atualiza o instante do último pulso.
+	unsigned long tempoDecorrido = instante - _estado.instanteUltimaSubida;
+	_estado.instanteUltimaSubida = instante;
+	_estado.instanteUltimaSubidaEstendido = _baseTempo.estender(instante);
+	_estado.glitchNoIntervalo = false;
+
+	// Borda nova: termina o decaimento (a medição guardada volta a valer até a próxima) ou a parada.
+	if (_estado.decaindo) {
+		_estado.decaindo = false;
+		registrarMedicao(_estado.bordasSemDecaimento, _estado.periodoSemDecaimento);
+	}
+	bool partida = !_estado.girando; // O intervalo da partida inclui o tempo parado: avança o ângulo, mas não é medição.
+	if (partida) {
+		_estado.girando = true;
+		_estado.eventosMovimento |= EVENTO_PARTIDA;
+		if (_modoTelemetria == TELEMETRIA_BINARIA) {
+			_telemetria.registrarEvento(instante, EVENTO_PARTIDA);
+		}
+		if (_captura != nullptr) {
+			_captura->sinalizarPartida(); // Uma captura armada começa pela borda da partida.
+		}
+	}
+
+	// Quantos riscos passaram neste intervalo: 1, ou k quando os riscos intermediários não foram detectados.
+	uint8_t riscos = riscosNoIntervalo(tempoDecorrido);
+
+	// Marca de índice (risco ausente): o intervalo de dois riscos na posição da marca não é um pulso perdido.
+	bool marca = (_marcaIndice == MARCA_RISCO_AUSENTE && riscos == 2 && reconhecerMarcaIndice((_estado.indiceRisco + 2) % _numRiscos));
+	if (marca) {
+		_estado.pulsosPerdidos--;
+	} else if (!_correcaoPulsos) {
+		riscos = 1;
+	}
+
+	// Avança o ângulo (comparação no lugar de % ou fmod: o índice nunca acumula erro).
+	_estado.indiceRisco += riscos;
+	_estado.riscosPercorridos += riscos;
+	bool novaVolta = false; // O índice passou pelo risco 0 neste intervalo.
+	while (_estado.indiceRisco >= _numRiscos) {
+		_estado.indiceRisco -= _numRiscos;
+		novaVolta = true;
+	}
+	if (marca && reposicionarIndice()) {
+		novaVolta = true; // O risco seguinte à falha é o risco 0 (as voltas já foram recontadas).
+	} else if (novaVolta) {
+		_estado.voltas++;
+		if (_marcaIndice == MARCA_RISCO_AUSENTE && !marca) {
+			registrarFalhaMarcaIndice(); // Deu a volta sem passar pela marca.
+		}
+		_estado.aguardandoMarca = true; // Risco 0: a próxima descida deve ser a marca larga.
+	}
+
+	if (partida) {
+		_estado.intervaloRisco = 0; // Sem extrapolação do ângulo até o próximo intervalo.
+		_extrapolacaoPendente = true;
+		_estado.janelaIniciada = false; // Esta borda abre a janela M/T.
+		processarJanelaMT(instante, tempoDecorrido, riscos);
+		if (_estimadorRPM == ESTIMADOR_VOLTA) {
+			_janelaVolta.registrar(instante, riscos); // Primeiro instante da janela de uma volta.
+		}
+		return false;
+	}
+
+	// Geometria do disco: aprende a largura dos riscos ou corrige o intervalo para a largura nominal (uma multiplicação).
+	if (_geometria.aprendendo()) {
+		if (_geometria.registrar(instante, tempoDecorrido, _estado.indiceRisco, riscos, novaVolta)) {
+			concluirAprendizadoGeometria();
+		}
+	} else if (_geometria.ativa() && riscos == 1) {
+		tempoDecorrido = _geometria.corrigir(tempoDecorrido, _estado.indiceRisco);
+	}
+
+	// Duração dos dois últimos riscos, usada na extrapolação do ângulo entre bordas (os coeficientes só são calculados na leitura).
+	_estado.intervaloRiscoAnterior = _estado.intervaloRisco;
+	_estado.intervaloRisco = (riscos == 1) ? tempoDecorrido : tempoDecorrido / riscos;
+	_extrapolacaoPendente = true;
+	if (_rastreamentoAtivo) {
+		_rastreamento.registrar(tempoDecorrido, riscos);
+	}
+
+	if (_estimadorRPM == ESTIMADOR_MT) {
+		return processarJanelaMT(instante, tempoDecorrido, riscos);
+	}
+	if (_estimadorRPM == ESTIMADOR_VOLTA) {
+		return processarJanelaVolta(instante, riscos); // Instante sem a correção da geometria: a volta inteira já a cancela.
+	}
+
+	// Verifica se o tempo decorrido é maior que zero para evitar divisão por zero.
+	if (tempoDecorrido == 0) {
+		return false;
+	}
+
+	// Apenas para Depuração... Serial.print("Tempo Decorrido (micros): ");
+	// Apenas para Depuração... Serial.println(tempoDecorrido);
+
+	// Cadeia de filtros: o intervalo de um risco filtrado vira a medição (um risco no intervalo filtrado).
+	if (_cadeiaFiltro != FILTRO_NENHUM) {
+		registrarMedicao(1, filtrarIntervalo(_estado.intervaloRisco));
+		return true;
+	}
+
+	// Guarda a medição em ponto fixo: uma borda no tempo decorrido. O RPM:
+	// 60 segundos/minuto / (número de riscos * tempo entre pulsos em segundos)
+	// só é calculado quando lido (lerRpmAtual/lerRpmMili), evitando uma divisão por borda.
+	registrarMedicao(riscos, tempoDecorrido);
+	return true;
+}
+
+// Passa o intervalo pela cadeia selecionada. O switch escolhe a cadeia; dentro dela os estágios são expandidos em linha.
+unsigned long sensorOpticoPro::filtrarIntervalo(unsigned long intervalo) {
+	switch (_cadeiaFiltro) {
+		case FILTRO_RAPIDO:  return _cadeiaRapida.filtrar(intervalo);
+		case FILTRO_SUAVE:   return _cadeiaSuave.filtrar(intervalo);
+		case FILTRO_ROBUSTO: return _cadeiaRobusta.filtrar(intervalo);
+		default:             return intervalo;
+	}
+}
+
+void sensorOpticoPro::novaCadeiaFiltro(CadeiaFiltro novaCadeia) {
+	if (novaCadeia > FILTRO_ROBUSTO) {
+		saidaSerial.println(F("Cadeia de filtros inválida (0 a 3)."));
+		return;
+	}
+	_cadeiaFiltro = novaCadeia;
+	_cadeiaRapida.zerar(); // A cadeia escolhida recomeça sem amostras de quando estava inativa.
+	_cadeiaSuave.zerar();
+	_cadeiaRobusta.zerar();
+}
+
+CadeiaFiltro sensorOpticoPro::lerCadeiaFiltro() const {
+	return _cadeiaFiltro;
+}
+
+// Classificação do intervalo entre duas bordas aceitas, comparado com o período previsto (mediana dos últimos intervalos):
+//  - normal: ~ 1 período (ou sem previsão ainda, ou irregular demais para ser um múltiplo);
+//  - perdido: ~ k períodos (2 <= k <= SENSOR_OPTICO_MAX_RISCOS_PERDIDOS + 1, dentro de 25% de um período): k - 1 riscos não foram detectados;
+//  - extra: ~ período/k, já descartado antes pelo filtro de glitches ou unido ao fragmento seguinte (bordasRejeitadas).
+// Um intervalo irregular (parada, partida) não é múltiplo do período e continua sendo tratado como um risco. Perto da
+// parada os intervalos crescem depressa e um deles pode cair perto de k períodos da mediana: só há riscos perdidos se o
+// intervalo candidato anterior também for um múltiplo do período (velocidade estável).
+uint8_t sensorOpticoPro::riscosNoIntervalo(unsigned long tempoDecorrido) {
+	unsigned long periodoPrevisto = lerPeriodoMediano();
+	uint8_t k = multiploPeriodo(tempoDecorrido, periodoPrevisto);
+	uint8_t anterior = (_estado.indiceIntervalo + SENSOR_OPTICO_INTERVALOS_MEDIANA - 2) % SENSOR_OPTICO_INTERVALOS_MEDIANA;
+	if (k < 2 || multiploPeriodo(_estado.intervalosCandidatos[anterior], periodoPrevisto) == 0) {
+		_estado.pulsosNormais++;
+		return 1;
+	}
+	_estado.pulsosPerdidos += k - 1;
+	return k; // Com a correção desligada, processarBorda() conta apenas um risco.
+}
+
+// Múltiplo k (1 a SENSOR_OPTICO_MAX_RISCOS_PERDIDOS + 1) do período a até 1/4 de período do intervalo; 0 se não houver (ou sem período).
+uint8_t sensorOpticoPro::multiploPeriodo(unsigned long intervalo, unsigned long periodo) {
+	if (periodo == 0) {
+		return 0;
+	}
+	unsigned long k = (intervalo + periodo / 2) / periodo; // Múltiplo mais próximo do período.
+	if (k < 1 || k > SENSOR_OPTICO_MAX_RISCOS_PERDIDOS + 1) {
+		return 0;
+	}
+	return (restoMultiplo(intervalo, periodo) * 4 > periodo) ? 0 : (uint8_t)k;
+}
+
+unsigned long sensorOpticoPro::restoMultiplo(unsigned long intervalo, unsigned long periodo) {
+	unsigned long k = (intervalo + periodo / 2) / periodo;
+	unsigned long multiplo = (k < 1 ? 1 : k) * periodo;
+	return (intervalo > multiplo) ? intervalo - multiplo : multiplo - intervalo;
+}
+
+// Marca de índice: um risco ausente (intervalo de dois riscos) ou um risco mais largo (nível alto 50% maior) em uma posição do disco.
+// A primeira marca reposiciona a contagem no risco 0 (candidata); a marca seguinte, exatamente uma volta depois, confirma o índice.
+// Com o índice sincronizado, a marca fora do risco 0 é tratada como pulso perdido (risco ausente) ou volta a ser candidata (risco largo),
+// e duas voltas seguidas sem a marca desfazem a sincronização. A posição contada passa a ser absoluta: o ângulo é limitado
+// apenas pela resolução de um risco e não acumula erro.
+// 'posicao' é o risco que a contagem atual atribuiria à marca. Retorna true se a marca deve reposicionar a contagem.
+bool sensorOpticoPro::reconhecerMarcaIndice(uint8_t posicao) {
+	_estado.aguardandoMarca = false;
+	if (posicao == 0 && (_estado.indiceSincronizado || _estado.marcaCandidata)) {
+		_estado.indiceSincronizado = true; // Marca na posição esperada: confirma (ou mantém) o índice.
+		_estado.marcasIndice++;
+		_estado.falhasConsecutivasIndice = 0;
+		return true;
+	}
+	if (_estado.indiceSincronizado && _marcaIndice == MARCA_RISCO_AUSENTE) {
+		return false; // Fora da posição da marca: é um pulso perdido comum.
+	}
+	_estado.indiceSincronizado = false; // Primeira marca (ou contagem errada): nova candidata.
+	_estado.marcaCandidata = true;
+	return true;
+}
+
+// Leva a contagem ao risco 0 na marca. Retorna true se o índice mudou (a volta recomeça).
+// As voltas são recontadas a partir dos riscos percorridos, sabendo que a marca é uma passagem pelo risco 0: somar uma
+// volta contaria duas vezes a passagem de uma contagem adiantada (que já deu a volta), e a volta de uma candidata falsa
+// (pulso perdido na aquisição). O erro de uma candidata falsa dura até a próxima marca, que reconta as voltas.
+bool sensorOpticoPro::reposicionarIndice() {
+	if (_estado.indiceRisco == 0) {
+		return false;
+	}
+	_estado.indiceRisco = 0;
+	unsigned long depoisDaPrimeira = _estado.riscosPercorridos - 1; // A primeira borda é a referência, não uma passagem.
+	_estado.voltas = (depoisDaPrimeira + _numRiscos - 1) / _numRiscos;
+	if (_geometria.ativa() || _geometria.aprendendo()) {
+		_geometria.desativar(); // A tabela foi aprendida com outra referência de risco 0.
+		saidaSerial.iniciarMensagem(); // Reposicionamento dentro da medição.
+		saidaSerial.println(F("Geometria desativada: a marca de índice reposicionou a contagem dos riscos."));
+		saidaSerial.concluirMensagem();
+	}
+	return true;
+}
+
+// Uma volta completa sem a marca: após duas seguidas, o índice deixa de ser confiável.
+void sensorOpticoPro::registrarFalhaMarcaIndice() {
+	if (!_estado.indiceSincronizado) {
+		return;
+	}
+	_estado.falhasIndice++;
+	if (++_estado.falhasConsecutivasIndice >= 2) {
+		_estado.indiceSincronizado = false;
+		_estado.marcaCandidata = false;
+	}
+}
+
+// Risco largo: chamada em cada descida com a duração do nível alto que terminou. A marca é o risco da última subida.
+void sensorOpticoPro::verificarMarcaLarga(unsigned long duracaoAlto) {
+	unsigned long referencia = _estado.duracaoAltoReferencia;
+	if (referencia != 0 && duracaoAlto * 100 > referencia * SENSOR_OPTICO_FATOR_MARCA_LARGA) {
+		if (reconhecerMarcaIndice(_estado.indiceRisco)) {
+			reposicionarIndice();
+		}
+		return; // A referência continua sendo a dos riscos comuns.
+	}
+	// Média móvel exponencial (1/8) dos níveis altos comuns: um glitch curto quase não altera a referência.
+	_estado.duracaoAltoReferencia = (referencia == 0) ? duracaoAlto : referencia - (referencia >> 3) + (duracaoAlto >> 3);
+	if (_estado.aguardandoMarca) { // Risco 0 sem a marca.
+		_estado.aguardandoMarca = false;
+		registrarFalhaMarcaIndice();
+	}
+}
+
+void sensorOpticoPro::novaMarcaIndice(MarcaIndice novaMarca) {
+	_marcaIndice = novaMarca;
+	_estado.indiceSincronizado = false;
+	_estado.marcaCandidata = false;
+	_estado.aguardandoMarca = false;
+	_estado.falhasConsecutivasIndice = 0;
+	_estado.duracaoAltoReferencia = 0;
+}
+
+MarcaIndice sensorOpticoPro::lerMarcaIndice() const {
+	return _marcaIndice;
+}
+
+bool sensorOpticoPro::indiceSincronizado() const {
+	return _estado.indiceSincronizado;
+}
+
+unsigned long sensorOpticoPro::lerVoltas() const {
+	return _estado.voltas;
+}
+
+unsigned long sensorOpticoPro::lerMarcasIndice() const {
+	return _estado.marcasIndice;
+}
+
+unsigned long sensorOpticoPro::lerFalhasIndice() const {
+	return _estado.falhasIndice;
+}
+
+void sensorOpticoPro::ativarCorrecaoPulsos(bool ativar) {
+	_correcaoPulsos = ativar;
+}
+
+bool sensorOpticoPro::lerCorrecaoPulsos() const {
+	return _correcaoPulsos;
+}
+
+unsigned long sensorOpticoPro::lerPulsosNormais() const {
+	return _estado.pulsosNormais;
+}
+
+unsigned long sensorOpticoPro::lerPulsosPerdidos() const {
+	return _estado.pulsosPerdidos;
+}
+
+unsigned long sensorOpticoPro::lerPulsosExtras() const {
+	return _estado.bordasRejeitadas;
+}
+
+// Aprendizado da geometria: soma os intervalos por risco durante 'voltas' voltas e, ao final, passa a corrigir cada intervalo.
+// O disco deve girar em velocidade constante; a tabela é recusada se a duração das voltas variar mais que 2%.
+bool sensorOpticoPro::aprenderGeometria(uint16_t voltas) {
+	if (!_geometria.iniciarAprendizado(_numRiscos, voltas)) {
+		saidaSerial.print(F("Geometria: o disco deve ter até "));
+		saidaSerial.print(_geometria.capacidade());
+		saidaSerial.println(F(" riscos e o aprendizado pelo menos uma volta."));
+		return false;
+	}
+	saidaSerial.print(F("Geometria: aprendendo durante "));
+	saidaSerial.print(voltas);
+	saidaSerial.println(F(" voltas (mantenha a velocidade constante)..."));
+	return true;
+}
+
+void sensorOpticoPro::concluirAprendizadoGeometria() {
+	saidaSerial.iniciarMensagem(); // Chamada dentro da medição, na última borda do aprendizado.
+	if (_geometria.concluirAprendizado()) {
+		saidaSerial.print(F("Geometria aprendida em "));
+		saidaSerial.print(_geometria.lerVoltasAprendidas());
+		saidaSerial.println(F(" voltas e aplicada."));
+	} else {
+		saidaSerial.print(F("Geometria recusada: variação da velocidade (milésimos) = "));
+		saidaSerial.println(_geometria.lerVariacaoVelocidadeMilesimos());
+	}
+	saidaSerial.concluirMensagem();
+}
+
+void sensorOpticoPro::desativarGeometria() {
+	_geometria.desativar();
+}
+
+const geometriaDisco<SENSOR_OPTICO_MAX_RISCOS_GEOMETRIA>& sensorOpticoPro::lerGeometria() const {
+	return _geometria;
+}
+
+// Publica uma medição em ponto fixo (M bordas em T micros) e marca o RPM em float como desatualizado.
+void sensorOpticoPro::registrarMedicao(uint16_t bordas, unsigned long periodo) {
+	_estado.bordasMedidas = bordas;
+	_estado.periodoMedido = periodo;
+	_rpmPendente = true;
+}
+
+// Filtro de glitches adaptativo (em microssegundos).
+// Cada borda de subida candidata (aceita ou rejeitada) tem o intervalo medido a partir da última borda aceita,
+// e a mediana dos últimos intervalos é o período de referência. Um glitch isolado gera um único intervalo curto,
+// que não altera a mediana de 5; uma aceleração real encurta todos os intervalos, inclusive os das bordas
+// rejeitadas, então a referência acompanha a velocidade sem travar.
+// A borda é rejeitada se chegar antes de _fracaoFiltroGlitch % da mediana desde a última borda aceita.
+bool sensorOpticoPro::bordaEhGlitch(unsigned long instante) {
+	unsigned long decorridoAceito = instante - _estado.instanteUltimaSubida;
+	_estado.intervalosCandidatos[_estado.indiceIntervalo] = decorridoAceito;
+	if (++_estado.indiceIntervalo >= SENSOR_OPTICO_INTERVALOS_MEDIANA) {
+		_estado.indiceIntervalo = 0;
+	}
+	if (_estado.intervalosValidos < SENSOR_OPTICO_INTERVALOS_MEDIANA) {
+		_estado.intervalosValidos++;
+	}
+
+	if (_fracaoFiltroGlitch == 0) {
+		return false; // Filtro desativado.
+	}
+
+	// Sem a mediana, o limite é o período no RPM máximo configurado.
+	unsigned long periodoMediano = lerPeriodoMediano();
+	bool glitch = (periodoMediano == 0)
+	            ? (decorridoAceito < _tempoMinimoEntrePulsacoes)
+	            : (decorridoAceito < periodoMediano && decorridoAceito * 100 < periodoMediano * _fracaoFiltroGlitch); // A 1ª comparação evita estouro em paradas longas.
+
+	if (glitch) {
+		_estado.bordasRejeitadas++;
+	}
+	return glitch;
+}
+
+// Mediana dos intervalos candidatos por ordenação por inserção de uma cópia (5 elementos: no máximo 10 comparações).
+unsigned long sensorOpticoPro::lerPeriodoMediano() const {
+	if (_estado.intervalosValidos < SENSOR_OPTICO_INTERVALOS_MEDIANA) {
+		return 0;
+	}
+	unsigned long ordenados[SENSOR_OPTICO_INTERVALOS_MEDIANA];
+	for (uint8_t i = 0; i < SENSOR_OPTICO_INTERVALOS_MEDIANA; i++) {
+		unsigned long valor = _estado.intervalosCandidatos[i];
+		uint8_t j = i;
+		while (j > 0 && ordenados[j - 1] > valor) {
+			ordenados[j] = ordenados[j - 1];
+			j--;
+		}
+		ordenados[j] = valor;
+	}
+	return ordenados[SENSOR_OPTICO_INTERVALOS_MEDIANA / 2];
+}
+
+// Define a porcentagem da mediana dos períodos abaixo da qual uma borda é considerada glitch.
+void sensorOpticoPro::novaFracaoFiltroGlitch(uint8_t novaFracao)
+{
+	if (novaFracao > 95) {
+        saidaSerial.println(F("Erro: A fração do filtro de glitches deve estar entre 0 (desativado) e 95%."));
+        return; // Saída antecipada da função em caso de erro
     }
-	
-    // Atualiza o estado anterior do sensor para o estado atual para a próxima iteração.
-    estadoAnterior_Sensor = estadoAtual_Sensor;
 
-    // Retorna o valor atual do RPM calculado.
-    return rpmAtual;
+    _fracaoFiltroGlitch = novaFracao;
+}
+
+uint8_t sensorOpticoPro::lerFracaoFiltroGlitch() const {
+    return _fracaoFiltroGlitch;
+}
+
+unsigned long sensorOpticoPro::lerBordasRejeitadas() const {
+    return _estado.bordasRejeitadas;
+}
+
+// Estimador M/T: a janela começa e termina sempre em uma borda de subida, então o tempo medido
+// corresponde a um número inteiro de períodos (M bordas em T microssegundos, sem fração perdida).
+//  - Baixa velocidade: o período de uma borda é maior que a janela, M = 1 e o estimador mede o período.
+//  - Alta velocidade: a janela contém muitas bordas, M cresce e o erro de 1 tick do micros() se dilui em T.
+// A troca entre os dois regimes é contínua, pois a fórmula é a mesma: RPM = 60 * M / (numRiscos * T).
+// Com a geometria do disco ativa, T é a soma dos intervalos corrigidos (sem ela, a soma é igual à duração da janela).
+bool sensorOpticoPro::processarJanelaMT(unsigned long instante, unsigned long tempoDecorrido, uint8_t riscos) {
+	if (!_estado.janelaIniciada) {
+		// Primeira borda: apenas abre a janela, ainda não há período medido.
+		_estado.instanteInicioJanela = instante;
+		_estado.bordasJanela = 0;
+		_estado.tempoJanelaCorrigido = 0;
+		_estado.janelaIniciada = true;
+		return false;
+	}
+
+	_estado.bordasJanela += riscos; // Riscos perdidos reconstituídos contam na janela: M continua correspondendo a T.
+	_estado.tempoJanelaCorrigido += tempoDecorrido;
+	unsigned long duracaoJanela = instante - _estado.instanteInicioJanela;
+	if (duracaoJanela < _duracaoJanelaRPM || _estado.tempoJanelaCorrigido == 0) {
+		return false; // Janela ainda aberta: continua contando bordas.
+	}
+
+	registrarMedicao(_estado.bordasJanela, _estado.tempoJanelaCorrigido); // RPM = 60 * M / (numRiscos * T), convertido apenas na leitura.
+
+	// A borda que fecha esta janela abre a próxima.
+	_estado.instanteInicioJanela = instante;
+	_estado.bordasJanela = 0;
+	_estado.tempoJanelaCorrigido = 0;
+	return true;
+}
+
+// Estimador de uma volta: a janela termina sempre na borda atual e começa na mesma posição do disco uma volta antes,
+// então M = numRiscos e T é a duração da volta. O espaçamento irregular dos riscos se cancela (a soma das larguras é a
+// volta inteira) e a medição é atualizada a cada borda, com uma subtração. A primeira medição sai após uma volta completa.
+bool sensorOpticoPro::processarJanelaVolta(unsigned long instante, uint8_t riscos) {
+	unsigned long duracaoVolta = _janelaVolta.registrar(instante, riscos);
+	if (duracaoVolta == 0) {
+		return false; // Menos de uma volta na janela.
+	}
+	registrarMedicao(_numRiscos, duracaoVolta); // RPM = 60 * numRiscos / (numRiscos * T) = 60 / T.
+	return true;
 }
 /* ******************************************************************************************************* */
 
-// Declaração da função para ajustar a distancia ideal entre Sensor Óptico e Disco Decodificador.
+/******************************************************************************
+ * Captura de Bordas por Interrupção
+ ******************************************************************************/
+
+// Instância atendida por cada interrupção externa (attachInterrupt() só aceita funções sem parâmetros).
+sensorOpticoPro* sensorOpticoPro::_instanciasInterrupcao[SENSOR_OPTICO_MAX_INTERRUPCOES] = { nullptr, nullptr };
+
+// Arena dos modos opcionais: um único bloco de RAM fixo, dividido em execução entre os sensores e a captura.
+arenaMemoriaFixa<SENSOR_OPTICO_TAMANHO_ARENA> sensorOpticoPro::_arena;
+
+arenaMemoria& sensorOpticoPro::lerArena() {
+	return _arena;
+}
+
+// Rotinas de interrupção: carimbam o instante e o nível do pino e publicam a borda na fila da instância.
+void sensorOpticoPro::tratarInterrupcao0() {
+	sensorOpticoPro* sensor = _instanciasInterrupcao[0];
+	if (sensor != nullptr) {
+		sensor->registrarBorda(sensor->_baseTempo.lerContador(), digitalRead(sensor->_pinoSensor));
+	}
+}
+
+void sensorOpticoPro::tratarInterrupcao1() {
+	sensorOpticoPro* sensor = _instanciasInterrupcao[1];
+	if (sensor != nullptr) {
+		sensor->registrarBorda(sensor->_baseTempo.lerContador(), digitalRead(sensor->_pinoSensor));
+	}
+}
+
+// Associa o pino do sensor à sua interrupção externa e passa a consumir as bordas pela fila.
+bool sensorOpticoPro::ativarCapturaPorInterrupcao() {
+	if (_capturaPorInterrupcao) {
+		return true; // Já está ativa.
+	}
+
+	int numeroInterrupcao = digitalPinToInterrupt(_pinoSensor);
+	if (numeroInterrupcao < 0 || numeroInterrupcao >= SENSOR_OPTICO_MAX_INTERRUPCOES
+	    || _instanciasInterrupcao[numeroInterrupcao] != nullptr) {
+		saidaSerial.println(F("Pino do sensor sem interrupção externa disponível."));
+		return false;
+	}
+
+	_filaBordas.esvaziar();
+	_estado.estadoAnteriorRPM = digitalRead(_pinoSensor); // Sincroniza o nível de referência antes da primeira borda.
+	_estado.transicaoPendente = false;
+	_estado.transicaoAnulada = false;
+	_numeroInterrupcao = numeroInterrupcao;
+	_instanciasInterrupcao[numeroInterrupcao] = this;
+	_capturaPorInterrupcao = true;
+	attachInterrupt(numeroInterrupcao, numeroInterrupcao == 0 ? tratarInterrupcao0 : tratarInterrupcao1, CHANGE);
+	return true;
+}
+
+// Libera a interrupção externa e volta para a detecção por varredura.
+void sensorOpticoPro::desativarCapturaPorInterrupcao() {
+	if (!_capturaPorInterrupcao) {
+		return;
+	}
+	if (_numeroInterrupcao >= 0) { // Na captura externa não há interrupção associada.
+		detachInterrupt(_numeroInterrupcao);
+		_instanciasInterrupcao[_numeroInterrupcao] = nullptr;
+	}
+	_numeroInterrupcao = -1;
+	_capturaPorInterrupcao = false;
+	_estado.estadoAnteriorRPM = digitalRead(_pinoSensor);
+	_estado.transicaoPendente = false;
+	_estado.transicaoAnulada = false;
+}
+
+// Captura externa: o calcularRPM() esvazia a fila como na captura por interrupção, mas quem chama registrarBorda()
+// é o grupoSensorOpticoPro, que lê vários pinos (ou uma porta inteira) de uma vez com um único carimbo de tempo.
+void sensorOpticoPro::ativarCapturaExterna() {
+	if (_capturaPorInterrupcao) {
+		return; // Já recebe as bordas pela fila (interrupção ou produtor externo).
+	}
+	_filaBordas.esvaziar();
+	_estado.estadoAnteriorRPM = digitalRead(_pinoSensor); // Sincroniza o nível de referência antes da primeira borda.
+	_estado.transicaoPendente = false;
+	_estado.transicaoAnulada = false;
+	_capturaPorInterrupcao = true;
+}
+
+// Produtor da fila. Também pode ser chamado diretamente por uma fonte de bordas simulada (testes no Linux).
+bool sensorOpticoPro::registrarBorda(unsigned long instante, uint8_t nivel) {
+	RegistroBorda borda;
+	borda.instante = instante;
+	borda.nivel = nivel;
+	return _filaBordas.inserir(borda);
+}
+
+uint16_t sensorOpticoPro::lerBordasPerdidas() const {
+	return _filaBordas.lerTransbordos();
+}
+
+uint8_t sensorOpticoPro::lerOcupacaoMaximaFila() const {
+	return _filaBordas.lerOcupacaoMaxima();
+}
+
+void sensorOpticoPro::zerarContadoresCaptura() {
+	_filaBordas.zerarContadores();
+}
+
+// Ajuste da distancia ideal entre Sensor Óptico e Disco Decodificador (chamado a cada loop() enquanto o ajuste estiver ativo).
+// Não bloqueia: as bordas são consumidas como no calcularRPM() e cada tempo em alto/baixo é registrado pelo
+// analisadorCicloTrabalho em O(1). O relatório é publicado apenas na taxa configurada (novaTaxaPublicacaoAjuste).
 void sensorOpticoPro::ajustarDistanciaSensorOptico() {
-	_estadoAtual = digitalRead(_pinoSensor); // Lê o estado atual do sensor.
-
-	const unsigned long tempoLimite = 1000000; // Define o tempo limite para o ajuste (1 segundos - corrigido para melhor performance).
-	static unsigned long tempoInicioAjuste = 0; // Variáveis estáticas para controlar o tempo e o estado do ajuste.
-	static bool ajusteIniciado = false;
-
-    // Define o número de amostras para calcular a média dos tempos alto e baixo.
-	const int NUM_AMOSTRAS = 100; 
-	// Variáveis estáticas para armazenar a soma dos tempos alto e baixo e a contagem de amostras.
-	static unsigned long somaTemposAlto = 0; // Soma dos tempos em que o sensor está em nível HIGH.
-	static unsigned long somaTemposBaixo = 0; // Soma dos tempos em que o sensor está em nível LOW.
-	static int contagem = 0;              // Contagem total de amostras coletadas.
-	// Índice e buffer para armazenar as recomendações de ajuste (0: Afasta, 1: Aproxima).
-	static int indiceBuffer = 0;
-	static int bufferAjuste[NUM_AMOSTRAS];
-
-	// Se o ajuste ainda não foi iniciado, inicializa as variáveis e o buffer.
-	if (!ajusteIniciado) {
-		// Registra o tempo atual como o tempo de início do ajuste.
-		tempoInicioAjuste = micros();
-		// Marca o ajuste como iniciado.
-		ajusteIniciado = true;
-		// Reinicializa o índice do buffer.
-		indiceBuffer = 0;
-		// Reinicializa as somas dos tempos.
-		somaTemposAlto = 0;
-		somaTemposBaixo = 0;
-		// Reinicializa a contagem de amostras.
-		contagem = 0;
-		// Inicializa o buffer de ajuste com -1 para indicar que não há dados válidos ainda.
-		for (int i = 0; i < NUM_AMOSTRAS; i++) {
-		bufferAjuste[i] = -1;
-		}
+	uint64_t agora = _baseTempo.lerMicros();
+
+	// Primeira chamada: começa uma janela nova.
+	if (!_ajusteAtivo) {
+		_ajusteAtivo = true;
+		_analisadorAjuste.zerar();
+		_instanteUltimaPublicacaoAjuste = agora;
 	}
 
-	// Verifica se o tempo limite para o ajuste foi atingido (timeout de 1 segundo).
-	if (micros() - tempoInicioAjuste >= tempoLimite) {
-		// Se nenhum tempo alto ou baixo foi medido (sensor sempre no mesmo estado), exibe a mensagem de distância severa.
-		if (_tempoAlto == 0 && _tempoBaixo == 0) {
-		Serial.println(distanciaSevera); 
-		} else if ((long)_tempoAlto > (long)_tempoBaixo) { 
-			// Se o tempo HIGH for maior que o tempo LOW, o sensor está muito próximo.
-			distanciaSevera = "Sensor Severamente Próximo... Afaste!";
-		} else {
-			// Se o tempo LOW for maior que o tempo HIGH, o sensor está muito longe.
-			distanciaSevera = "Sensor Severamente Longe... Aproxime!";
-		}
-    	// Reseta as variáveis para a próxima vez que a função for chamada (reinicia o processo de ajuste).
-		ajusteIniciado = false; //Reseta o ajuste para a proxima vez que for chamado
-		_tempoAnterior = -1;
-		_tempoAlto = 0;
-		_tempoBaixo = 0;
-		return; // Sai da função após o timeout.
-	}
-
-	// Verifica se houve uma mudança no estado do sensor (transição HIGH para LOW ou LOW para HIGH).
-	if (_estadoAtual != _estadoAnterior) {
-		// Obtém o tempo atual em microssegundos.
-		unsigned long tempoAtual = micros();
-		unsigned long tempoDecorrido;
-
-    	// Se houver um tempo anterior registrado (não é a primeira leitura).
-		if (_tempoAnterior != -1) {
-			// Calcula o tempo decorrido desde a última mudança de estado.
-			tempoDecorrido = tempoAtual - _tempoAnterior;
-
-			// Reinicializa os tempos alto e baixo para a nova medição.
-			_tempoAlto = 0;
-			_tempoBaixo = 0;
-
-		// Determina se o tempo decorrido é um tempo alto (sensor HIGH) ou baixo (sensor LOW).
-		if (_estadoAnterior == 1) {
-			
-			_tempoBaixo = tempoDecorrido;
+	// Consome as bordas pendentes (fila ou varredura); os tempos chegam ao analisador por processarBorda().
+	atualizarMedicao();
+
+	if (agora - _instanteUltimaPublicacaoAjuste < _intervaloPublicacaoAjuste) {
+		return;
+	}
+	_instanteUltimaPublicacaoAjuste = agora;
+
+	// O relatório é uma mensagem de telemetria: se a Serial não acompanhar, a fila descarta relatórios em vez de bloquear o ajuste.
+	saidaSerial.iniciarMensagem();
+
+	// Sem nenhum tempo completo na janela, o sinal ficou parado em um nível: distância severa (ou disco parado).
+	if (_analisadorAjuste.lerContagemAlto() == 0 || _analisadorAjuste.lerContagemBaixo() == 0) {
+		if (digitalRead(_pinoSensor) == HIGH) {
+			saidaSerial.println(F("Sensor Severamente Próximo... Afaste! (ou disco parado)"));
 		} else {
-			_tempoAlto = tempoDecorrido;
+			saidaSerial.println(F("Sensor Severamente Longe... Aproxime! (ou disco parado)"));
 		}
+		saidaSerial.concluirMensagem();
+		_analisadorAjuste.zerar();
+		return;
+	}
 
-		// Acumula os tempos alto e baixo e incrementa a contagem de amostras.
-		somaTemposAlto += _tempoAlto;
-		somaTemposBaixo += _tempoBaixo;
-		contagem++;
-
-		// Armazena a recomendação de ajuste no buffer: 0 para Afastar, 1 para Aproximar.
-		bufferAjuste[indiceBuffer] = (_tempoAlto < _tempoBaixo) ? 0 : 1; // 0: Afasta, 1: Aproxima
-		// Atualiza o índice do buffer usando o operador módulo (%) para circular entre as posições do buffer.
-		indiceBuffer = (indiceBuffer + 1) % NUM_AMOSTRAS;
-
-		// Se o buffer estiver cheio (coletou NUM_AMOSTRAS amostras), calcula as médias e exibe a recomendação.
-		if (indiceBuffer == 0 && ajusteIniciado) {
-			unsigned long mediaTempoAlto = 0;
-			unsigned long mediaTempoBaixo = 0;
-			long mediaDiferenca = 0;
-
-			// Calcula as médias dos tempos alto e baixo.
-			if (contagem > 0) {
-				mediaTempoAlto = somaTemposAlto / contagem;
-				mediaTempoBaixo = somaTemposBaixo / contagem;
-				mediaDiferenca = (long)mediaTempoAlto - (long)mediaTempoBaixo;
-			}
+	// Define a tolerância (em décimos de porcentagem) para considerar a distância como aceitável.
+	const uint16_t TOLERANCIA_CICLO = 50; // 50% +- 5%
+	uint16_t ciclo = _analisadorAjuste.lerCicloTrabalhoDecimos();
 
-			// Define a tolerância para considerar a distância como aceitável (diferença entre os tempos dentro dessa tolerância).
-			const long TOLERANCIA_PERFEITA = 1000;
+	// Exibe a recomendação: mais tempo em alto que em baixo indica o sensor próximo demais (mesmo critério da distância severa).
+	if (ciclo + TOLERANCIA_CICLO >= 500 && ciclo <= 500 + TOLERANCIA_CICLO) {
+		saidaSerial.print(F("Recomendação: Distância aceitável! "));
+	} else if (ciclo > 500) {
+		saidaSerial.print(F("Recomendação: Afaste! "));
+	} else {
+		saidaSerial.print(F("Recomendação: Aproxime! "));
+	}
 
-			// Exibe a recomendação com base na diferença entre os tempos médios.
-			if (abs(mediaDiferenca) <= TOLERANCIA_PERFEITA) {
-				Serial.print(F("Recomendação: Distância aceitável! "));
-			} else if (mediaTempoAlto < mediaTempoBaixo) {
-				Serial.print(F("Recomendação: Afaste! "));
-			} else {
-				Serial.print(F("Recomendação: Aproxime! "));
-			}
+	// Imprime o ciclo de trabalho, os tempos médios e a pontuação para acompanhamento.
+	saidaSerial.print(F("Ciclo de Trabalho: "));
+	saidaSerial.print(ciclo / 10);
+	saidaSerial.print('.');
+	saidaSerial.print(ciclo % 10);
+	saidaSerial.print(F(" %, Tempo Alto Médio: "));
+	saidaSerial.print(_analisadorAjuste.lerMediaAlto());
+	saidaSerial.print(F(" us, Tempo Baixo Médio: "));
+	saidaSerial.print(_analisadorAjuste.lerMediaBaixo());
+	saidaSerial.print(F(" us, Pontuação: "));
+	saidaSerial.print(_analisadorAjuste.lerPontuacaoDistancia());
+	saidaSerial.println(F("/100"));
+	saidaSerial.concluirMensagem();
+
+	// Começa a próxima janela de publicação.
+	_analisadorAjuste.zerar();
+}
+
+void sensorOpticoPro::pararAjusteDistanciaSensorOptico() {
+	_ajusteAtivo = false;
+}
 
-			// Imprime os tempos médios e a diferença no Serial Monitor para depuração e acompanhamento.
-			Serial.print(F("Tempo Alto Médio: "));
-			Serial.print(mediaTempoAlto);
-			Serial.print(F(" us, "));
-			Serial.print(F("Tempo Baixo Médio: "));
-			Serial.print(mediaTempoBaixo);
-			Serial.print(F(" us, "));
-			Serial.print(F("Diferença Média: "));
-			Serial.print(mediaDiferenca);
-			Serial.println(F(" us"));
-
-			// Reseta as variáveis de soma e contagem para a próxima medição/ajuste.
-			somaTemposAlto = 0;
-			somaTemposBaixo = 0;
-			contagem = 0;
-      }
+// Define quantos relatórios do ajuste são publicados por segundo (1 a 50 Hz).
+void sensorOpticoPro::novaTaxaPublicacaoAjuste(uint8_t novaTaxaHz) {
+	if (novaTaxaHz == 0 || novaTaxaHz > 50) {
+        saidaSerial.println(F("Erro: A taxa de publicação do ajuste deve estar entre 1 e 50 Hz."));
+        return; // Saída antecipada da função em caso de erro
     }
-	// Atualiza o tempo e o estado anterior para a próxima iteração.
-    _tempoAnterior = tempoAtual;
-    _estadoAnterior = _estadoAtual;
-  }
+
+	_intervaloPublicacaoAjuste = 1000000UL / novaTaxaHz;
+}
+
+uint8_t sensorOpticoPro::lerTaxaPublicacaoAjuste() const {
+	return (uint8_t)(1000000UL / _intervaloPublicacaoAjuste);
+}
+
+const analisadorCicloTrabalho& sensorOpticoPro::lerAnalisadorAjuste() const {
+	return _analisadorAjuste;
 }
@@ -23,6 +23,16 @@
  *   - Arduino.h
  *   - inttypes.h
  *   - math.h
+ *   - bufferBordas.h (fila de bordas para a captura por interrupção)
+ *   - historicoBits.h (histórico compactado da detecção de movimento)
+ *   - estatisticaWelford.h (média e variância em uma passagem para a calibração do limiar)
+ *   - analisadorCicloTrabalho.h (histogramas dos tempos em alto e em baixo para o ajuste da distância)
+ *   - janelaVolta.h (instantes da última volta para o estimador síncrono com a volta)
+ *   - arenaMemoria.h (memória compartilhada pelos vetores que só existem em alguns modos)
+ *   - baseTempo.h (micros() estendido para 64 bits, com fonte injetável para testes)
+ *   - telemetriaBinaria.h (quadros binários COBS com as medições, enviados por uma saída configurável)
+ *   - saidaAssincrona.h (fila de saída da Serial: a medição nunca espera pela transmissão)
+ *   - capturaBordas.h (registro das bordas brutas em quadros compactos para análise fora da placa)
  *
  * Autor: Tiago Carvalho Pontes
  * Data: 12/12/2024
@@ -33,12 +43,105 @@
 #ifndef sensorOpticoPro_h // Define um guarda de inclusão para evitar inclusões múltiplas do cabeçalho. Se 'sensorOpticoPro_h' não estiver definido, ele será definido agora.
 #define sensorOpticoPro_h // Define o identificador 'sensorOpticoPro_h'.
 
+#include "bufferBordas.h" // Fila circular SPSC usada pela captura de bordas por interrupção.
+#include "historicoBits.h" // Histórico de amostras em bits usado por detectarMovimento().
+#include "estatisticaWelford.h" // Média e variância incrementais usadas na calibração do limiar.
+#include "analisadorCicloTrabalho.h" // Ciclo de trabalho e pontuação da distância usados por ajustarDistanciaSensorOptico().
+#include "geometriaDisco.h" // Tabela de correção do espaçamento dos riscos do disco.
+#include "filtroRastreamento.h" // Filtro de rastreamento (velocidade e aceleração) alimentado pelas bordas.
+#include "janelaVolta.h" // Instantes das bordas da última volta (estimador síncrono com a volta).
+#include "arenaMemoria.h" // Arena de tamanho fixo para os vetores que só existem em alguns modos (janela de uma volta).
+#include "baseTempo.h" // Base de tempo de 64 bits com fonte injetável (micros() ou relógio simulado).
+#include "cadeiaFiltros.h" // Estágios de filtro compostos na compilação (mediana, média exponencial, média móvel, limitador).
+#include "telemetriaBinaria.h" // Quadros binários (COBS, CRC) com as medições, substituindo o texto "RPM: ".
+#include "saidaAssincrona.h" // Fila de saída com prioridades: respostas antes da telemetria, telemetria descartável.
+#include "capturaBordas.h" // Bordas brutas (intervalo em varint e nível) em quadros COBS para análise fora da placa.
 
 
 // Definição das constantes para statusConexaoSensorOptico() ------ Apenas para Depuração;
 #define STATUS_REGISTER 0x00 // Endereço do registrador de status do sensor. Precisa ser definido corretamente para o seu sensor.
 #define STATUS_BIT_OK 0x01  // Bit que indica status OK no registrador de status. Precisa ser definido corretamente para o seu sensor
 
+// Definição das constantes da captura de bordas por interrupção (podem ser redefinidas antes de incluir este cabeçalho).
+#ifndef SENSOR_OPTICO_CAPACIDADE_FILA
+#define SENSOR_OPTICO_CAPACIDADE_FILA 32 // Bordas armazenadas entre duas chamadas de calcularRPM() (potência de 2, máximo 128).
+#endif
+#define SENSOR_OPTICO_TAMANHO_LOTE 8      // Bordas retiradas da fila por vez ao esvaziá-la em calcularRPM().
+#define SENSOR_OPTICO_MAX_INTERRUPCOES 2  // Interrupções externas atendidas (INT0 e INT1 no Arduino Uno).
+#define SENSOR_OPTICO_INTERVALOS_MEDIANA 5 // Intervalos candidatos usados na mediana do filtro de glitches (ímpar).
+#define SENSOR_OPTICO_MAX_RISCOS_PERDIDOS 3 // Maior número de riscos seguidos que a correção de pulsos perdidos reconhece em um intervalo.
+#define SENSOR_OPTICO_FRACAO_FRAGMENTO 95 // Borda de subida antes desta porcentagem do período previsto: pode ser espúria e espera a borda seguinte.
+#define SENSOR_OPTICO_TEMPO_PARADA 500 // Tempo limite padrão (ms) sem bordas de subida até o disco ser considerado parado.
+#define SENSOR_OPTICO_FATOR_MARCA_LARGA 150 // Marca de índice por risco largo: nível alto acima desta porcentagem da média dos níveis altos.
+#ifndef SENSOR_OPTICO_MAX_AMOSTRAS_DETEC_MOV
+#define SENSOR_OPTICO_MAX_AMOSTRAS_DETEC_MOV 1024 // Maior janela da detecção de movimento (potência de 2; ocupa 1 bit por amostra).
+#endif
+#ifndef SENSOR_OPTICO_MAX_RISCOS_GEOMETRIA
+#define SENSOR_OPTICO_MAX_RISCOS_GEOMETRIA 36 // Maior disco aceito pela calibração da geometria (6 bytes de RAM por risco).
+#endif
+#ifndef SENSOR_OPTICO_MAX_RISCOS_VOLTA
+#define SENSOR_OPTICO_MAX_RISCOS_VOLTA 64 // Maior disco do estimador de uma volta (até 255, o limite do numRiscos); um disco maior usa o M/T.
+#endif
+#ifndef SENSOR_OPTICO_TAMANHO_ARENA
+#define SENSOR_OPTICO_TAMANHO_ARENA (SENSOR_OPTICO_MAX_RISCOS_VOLTA * sizeof(unsigned long)) // Arena compartilhada pelos sensores: a janela de uma volta do maior disco (256 bytes no Uno; 1020 com 255 riscos).
+#endif
+static_assert(SENSOR_OPTICO_MAX_RISCOS_VOLTA >= 1 && SENSOR_OPTICO_MAX_RISCOS_VOLTA <= 255,
+              "SENSOR_OPTICO_MAX_RISCOS_VOLTA deve ficar entre 1 e 255 (numRiscos de 8 bits).");
+static_assert(SENSOR_OPTICO_TAMANHO_ARENA >= SENSOR_OPTICO_MAX_RISCOS_VOLTA * sizeof(unsigned long),
+              "A arena deve comportar a janela de uma volta de SENSOR_OPTICO_MAX_RISCOS_VOLTA riscos.");
+#ifndef SENSOR_OPTICO_TAMANHO_QUADRO_TELEMETRIA
+#define SENSOR_OPTICO_TAMANHO_QUADRO_TELEMETRIA 96 // Bytes do quadro da telemetria binária (35 a 255): ~78 amostras por quadro com 96 (cabeçalho e rodapé de ~18 bytes).
+#endif
+#ifndef SENSOR_OPTICO_TAMANHO_QUADRO_CAPTURA
+#define SENSOR_OPTICO_TAMANHO_QUADRO_CAPTURA 64 // Bytes de cada quadro da captura de bordas (32 a 254): ~40 bordas por quadro a 20 mil bordas/s.
+#endif
+#ifndef SENSOR_OPTICO_QUADROS_CAPTURA
+#define SENSOR_OPTICO_QUADROS_CAPTURA 4 // Quadros da captura guardados enquanto a Serial não os aceita (absorvem as rajadas).
+#endif
+#define SENSOR_OPTICO_ERRO_CONVERGENCIA_LIMIAR 0.01 // Calibração do limiar: erro relativo da média (alto e baixo) abaixo do qual o limiar é aceito.
+
+typedef capturaBordas<SENSOR_OPTICO_TAMANHO_QUADRO_CAPTURA, SENSOR_OPTICO_QUADROS_CAPTURA> capturaBordasSensor;
+
+// Estimadores de RPM disponíveis em calcularRPM().
+enum EstimadorRPM : uint8_t {
+  ESTIMADOR_PERIODO = 0, // RPM a partir do intervalo entre duas bordas de subida consecutivas (um valor por borda).
+  ESTIMADOR_MT = 1,      // Método M/T: conta as bordas dentro de uma janela e mede o tempo exato entre a primeira e a última.
+  ESTIMADOR_VOLTA = 2    // Última volta completa, atualizada a cada borda: cancela o erro de geometria do disco, com uma volta de atraso.
+};
+static_assert(ESTIMADOR_MT == TELEMETRIA_ESTIMADOR_MT, "A telemetria binária reconhece o M/T pelo valor do estimador.");
+
+// Cadeias de filtros do intervalo entre bordas (estimador por período), compostas na compilação e escolhidas em execução.
+enum CadeiaFiltro : uint8_t {
+  FILTRO_NENHUM = 0,  // Intervalo sem filtro.
+  FILTRO_RAPIDO = 1,  // Mediana de 3 + média exponencial (1/4): remove picos com pouco atraso.
+  FILTRO_SUAVE = 2,   // Mediana de 5 + média móvel de 8: menor ruído, mais atraso.
+  FILTRO_ROBUSTO = 3  // Mediana de 3 + limitador de taxa (12,5% por risco): segura degraus espúrios.
+};
+typedef cadeiaFiltros<unsigned long, filtroMediana<unsigned long, 3>, filtroMediaExponencial<unsigned long, 2> > cadeiaIntervaloRapida;
+typedef cadeiaFiltros<unsigned long, filtroMediana<unsigned long, 5>, filtroMediaMovel<unsigned long, 8> > cadeiaIntervaloSuave;
+typedef cadeiaFiltros<unsigned long, filtroMediana<unsigned long, 3>, filtroLimitadorTaxa<unsigned long, 3> > cadeiaIntervaloRobusta;
+
+// Saída das medições publicadas pelo calcularRPM().
+enum TelemetriaRPM : uint8_t {
+  TELEMETRIA_DESLIGADA = 0, // Nenhuma saída (a leitura continua disponível nos getters).
+  TELEMETRIA_TEXTO = 1,     // "RPM: 999.80" pela Serial a cada medição (compatível com o sistema web).
+  TELEMETRIA_BINARIA = 2    // Quadros binários de telemetriaBinaria.h pela saída configurada.
+};
+
+// Eventos de movimento (bits), acumulados até serem lidos por lerEventosMovimento().
+enum EventoMovimento : uint8_t {
+  EVENTO_NENHUM = 0,
+  EVENTO_PARADA = 1,  // Nenhuma borda durante o tempo limite: a leitura foi a zero.
+  EVENTO_PARTIDA = 2  // Primeira borda de subida depois de uma parada (ou do iniciar()).
+};
+
+// Marca de índice do disco (referência do risco 0 para o ângulo absoluto).
+enum MarcaIndice : uint8_t {
+  MARCA_NENHUMA = 0,       // Disco sem marca: o risco 0 é o risco onde a medição começou.
+  MARCA_RISCO_AUSENTE = 1, // Um risco faltando: o intervalo da falha vale dois riscos e o risco seguinte é o 0.
+  MARCA_RISCO_LARGO = 2    // Um risco mais largo: nível alto acima de SENSOR_OPTICO_FATOR_MARCA_LARGA % da média dos outros.
+};
+
   // Estrutura para armazenar informações sobre o movimento detectado.
   struct Movimento {
     bool movimentoDetectado;  // Indica se houve alguma transição de estado no sensor (o que pode indicar movimento).
@@ -50,6 +153,58 @@
   unsigned long tempoDescida;
   };
 
+  // Estado de medição de cada instância (antes eram variáveis 'static' locais, compartilhadas entre todos os sensores).
+  // Os campos estão ordenados do maior para o menor para não haver bytes de preenchimento entre eles.
+  struct EstadoMedicao {
+    // calcularRPM()
+    uint64_t instanteUltimaSubidaEstendido; // Instante (micros, 64 bits) da última borda de subida: tempo sem bordas sem limite de volta do contador.
+    unsigned long instanteUltimaSubida; // Instante (micros) da última borda de subida processada.
+    unsigned long instanteInicioJanela; // Instante (micros) da borda de subida que abriu a janela M/T atual.
+    unsigned long instanteUltimaBorda;  // Instante (micros) da última transição (subida ou descida), para medir os tempos em alto e em baixo.
+    unsigned long periodoMedido;        // Última medição em ponto fixo: T (micros) ocupados pelas bordas abaixo.
+    unsigned long intervalosCandidatos[SENSOR_OPTICO_INTERVALOS_MEDIANA]; // Últimos intervalos (aceitos ou não) medidos a partir da última borda aceita (filtro de glitches).
+    unsigned long bordasRejeitadas;     // Bordas de subida descartadas pelo filtro de glitches (pulsos extras: intervalo ~ período/k).
+    unsigned long pulsosNormais;        // Intervalos aceitos de um risco (~ período previsto).
+    unsigned long pulsosPerdidos;       // Riscos não detectados, reconstituídos em intervalos de ~ k vezes o período previsto.
+    unsigned long tempoJanelaCorrigido; // Soma dos intervalos da janela M/T corrigidos pela geometria do disco (T do estimador).
+    unsigned long intervaloRisco;       // Duração (micros) do último risco, já corrigida pela geometria do disco.
+    unsigned long intervaloRiscoAnterior; // Duração (micros) do risco anterior (estimativa da aceleração).
+    unsigned long voltas;               // Voltas completas (passagens pelo risco 0).
+    unsigned long riscosPercorridos;    // Riscos contados desde a primeira borda (inclusive): as voltas são recontadas na marca de índice.
+    unsigned long duracaoAltoReferencia; // Média (micros) dos níveis altos comuns, referência da marca de risco largo.
+    unsigned long marcasIndice;         // Marcas de índice reconhecidas na posição esperada.
+    unsigned long falhasIndice;         // Voltas em que a marca de índice não apareceu no risco 0.
+    unsigned long periodoSemDecaimento; // Medição (T) guardada enquanto a leitura decai por falta de bordas; volta na próxima borda.
+    unsigned long instanteTransicaoPendente; // Instante (micros) da transição que aguarda o nível durar o limiar calibrado.
+    unsigned long instanteTransicaoAnulada; // Instante da última transição desfeita pelo filtro de nível (pode ser restaurada).
+    unsigned long instanteAnulacao;     // Instante da transição que a desfez.
+    unsigned long niveisCurtos;         // Níveis mais curtos que o limiar calibrado, descartados com as suas duas transições.
+    unsigned long instanteFragmento;    // Borda de subida que chegou entre a fração do filtro de glitches e SENSOR_OPTICO_FRACAO_FRAGMENTO % do período.
+    // calcularRPM()
+    uint16_t bordasJanela;              // Bordas de subida contadas desde a abertura da janela M/T.
+    uint16_t bordasMedidas;             // Última medição em ponto fixo: M bordas em 'periodoMedido' (RPM = 60e6 * M / (numRiscos * T)).
+    uint16_t bordasSemDecaimento;       // Medição (M) guardada enquanto a leitura decai por falta de bordas.
+    // calcularRPM()
+    uint8_t indiceRisco;                // Ângulo em ponto fixo: risco atual (0 a numRiscos - 1), sem acumular erro de ponto flutuante.
+    uint8_t indiceIntervalo;            // Próxima posição de 'intervalosCandidatos' (circular).
+    uint8_t intervalosValidos;          // Quantidade de intervalos já armazenados (a mediana só é usada com a janela cheia).
+    uint8_t falhasConsecutivasIndice;   // Voltas seguidas sem a marca de índice (duas desfazem a sincronização).
+    uint8_t eventosMovimento;           // Eventos de parada e partida ainda não lidos (bits de EventoMovimento).
+    uint8_t nivelPendente;              // Nível da transição pendente.
+    // calcularRPM()
+    bool estadoAnteriorRPM;             // Último nível processado pelo calcularRPM() (detecção de borda).
+    bool janelaIniciada;                // Indica se já houve a borda de subida que abre a primeira janela M/T.
+    bool indiceSincronizado;            // A marca de índice foi confirmada: o risco 0 é absoluto.
+    bool marcaCandidata;                // Uma marca já reposicionou a contagem e aguarda confirmação na volta seguinte.
+    bool aguardandoMarca;               // O índice chegou ao risco 0 e a marca de risco largo ainda não foi verificada.
+    bool girando;                       // Houve borda de subida dentro do tempo limite de parada (a borda anterior é uma referência de tempo válida).
+    bool decaindo;                      // A leitura está limitada por 1 risco / tempo sem bordas (medição guardada em 'SemDecaimento').
+    bool transicaoPendente;             // Há uma transição aguardando a confirmação pelo limiar calibrado.
+    bool transicaoAnulada;              // A última transição desfeita ainda pode ser restaurada pela próxima.
+    bool fragmentoPendente;             // 'instanteFragmento' aguarda a próxima borda para ser aceito ou unido ao intervalo seguinte.
+    bool glitchNoIntervalo;             // Uma borda de subida foi rejeitada como glitch desde a última borda aceita.
+  };
+
 class sensorOpticoPro
 {
   private:
@@ -57,44 +212,77 @@ class sensorOpticoPro
 	//Configuração do Pinos
   uint8_t _pinoSensor; // Pino digital ao qual o sensor está conectado.
   //Cronometragem
-  unsigned long _instanteInicial; //Instante exato em que o programa começa a ser executado (usado para calcular tempos decorridos)..
-  unsigned long _instanteRpmInicial; // Instante da última medição de RPM, recebe o valor a cada inicio de função (usado para calcular a velocidade angular).
+  baseTempo _baseTempo = baseTempo(micros); // Relógio de todas as medições: micros() estendido para 64 bits (fonte trocável para testes).
+  uint64_t _instanteInicial; //Instante exato (micros, 64 bits) em que o programa começa a ser executado (usado para calcular tempos decorridos)..
+  uint64_t _instanteRpmInicial; // Instante (micros, 64 bits) da última medição de RPM, recebe o valor a cada inicio de função (usado para calcular a velocidade angular).
   //Parametros do Sensor
   uint16_t _rpmMaximo; // Valor de RPM solicitado recebido via serial do sistema da Balanceadora (configurado externamente).
-  float _rpmAtual; // RPM atual calculado pelo sensor
+  mutable float _rpmAtual = 0.0; // RPM atual convertido de '_estado' (M, T) apenas quando lido.
+  mutable bool _rpmPendente = false; // Indica que há uma medição nova ainda não convertida para float em _rpmAtual.
+  uint32_t _anguloPorRiscoQ32 = 0;           // Extrapolação do ângulo: ângulo de um risco (volta = 2^32), recalculado com o disco.
+  mutable uint32_t _inversoIntervaloQ31 = 0; // Extrapolação do ângulo: 2^31 / duração do último risco.
+  mutable int16_t _coefAceleracaoQ16 = 0;    // Extrapolação do ângulo: coeficiente de aceleração (Q16).
+  mutable bool _extrapolacaoPendente = false; // Há borda nova: os coeficientes da extrapolação serão recalculados na leitura.
   float _rpmAtualTemporario = _rpmMaximo; // Valor intermediário para ajuste gradual do RPM (evita mudanças bruscas).
   uint8_t _numRiscos; // Número total de Pulsos (riscos) no disco do sensor óptico. Utilizado no cálculo do RPM.
+  // Constantes de conversão do disco, recalculadas somente quando _numRiscos muda (atualizarFatoresDisco): as leituras multiplicam no lugar de dividir.
+  float _fatorRpm = 0.0;                  // 60e6 / numRiscos: RPM = _fatorRpm * M / T (T em micros).
+  float _grausPorRisco = 0.0;             // 360 / numRiscos.
+  uint32_t _anguloBinarioPorRiscoQ16 = 0; // Ângulo binário (65536 = volta) de um risco em Q16.16, arredondado para cima (exato até o risco 255).
+  bool _geometriaFixa = false; // true em sensorOpticoProFixo: número de riscos e RPM máximo não podem ser alterados em tempo de execução.
+  EstimadorRPM _estimadorRPM = ESTIMADOR_MT; // Estimador usado pelo calcularRPM().
+  uint16_t _taxaAtualizacaoRPM = 50; // Taxa alvo de atualização do RPM em Hz no estimador M/T.
+  unsigned long _duracaoJanelaRPM = 20000; // Duração mínima (micros) da janela M/T, derivada da taxa de atualização.
+  unsigned long _tempoLimiteParada = SENSOR_OPTICO_TEMPO_PARADA * 1000UL; // Tempo (micros) sem bordas de subida até a leitura ir a zero.
 
   //Calcular Velocidade Angular em Radianos por segundo e Posição Angular
+  // A medição fica em ponto fixo (M bordas em T micros e índice do risco atual); os valores em float são obtidos apenas na leitura.
   float _velocidadeAngular = 0.0; // Inicializa com zero radianos por segundo e armazenar as velocidades angulares calculadas.
-    unsigned long _tempoAnteriorAngulo = 0;
-    float _anguloAtual = 0.0; // Ângulo de rotação atual em graus.
   
   /********************************************************** Calcular RPM **********************************************************/
     // Limiar e Tempo
-    /*unsigned long*/uint8_t _limiarPulsacoes = 0; // Armazena o limiar calculado para detecção de pulsações.
+    unsigned long _limiarPulsacoes = 0; // Armazena o limiar calculado (micros): menor duração válida de um nível alto ou baixo.
                                         // Usado para evitar leituras espúrias.
                                         // Um valor mais alto aumenta a confiabilidade da detecção, mas pode atrasar a resposta.
     float _fatorAjusteLimiar = 1.0; // Ajuste do Limite de Pulsos - Aumenta a sensibilidade do sensor quando maior que 1.0 e diminui quando menor que 1.0. Utilizado para compensar variações na iluminação ambiente.
-      uint16_t _NUM_AMOSTRAS_calcLimiar = 100; // Número de amostras para cálculo do limiar ideal para o Calculo do RPM
-      int* _amostras_calcLimiar = new int[_NUM_AMOSTRAS_calcLimiar]; //É um array que armazena as últimas amostras das leituras do sensor (_NUM_AMOSTRAS_calcLimiar garantira o espaço nescessario na memoria).
-    uint16_t _NUM_AMOSTRAS_detecMov = 100; // Número de amostras do Filtro Movel para Detecção de Movimento
-      int* _amostras_detecMov = new int[_NUM_AMOSTRAS_detecMov]; //É um array que armazena as últimas amostras das leituras do sensor (_NUM_AMOSTRAS_detecMov garantira o espaço nescessario na memoria).
-    uint16_t _tempoMinimoEntrePulsacoes; // Define o intervalo de tempo mínimo (em milissegundos) entre duas detecções consecutivas de pulsos. Serve para filtrar ruídos e evitar a contagem dupla de pulsos.
+      uint16_t _NUM_AMOSTRAS_calcLimiar = 100; // Número mínimo de tempos em alto e em baixo antes de verificar a convergência da calibração do limiar.
+      estatisticaWelford _calibracaoAlto;  // Média e variância dos tempos em nível alto (calibração do limiar, sem vetor de amostras).
+      estatisticaWelford _calibracaoBaixo; // Média e variância dos tempos em nível baixo.
+      float _erroRelativoLimiar = 1.0; // Maior erro relativo da média (alto ou baixo) alcançado na calibração: a confiança do limiar.
+      bool _calibrandoLimiar = false;  // Indica se a calibração do limiar está acumulando tempos.
+    historicoBits<SENSOR_OPTICO_MAX_AMOSTRAS_DETEC_MOV> _historicoDetecMov; // Últimas amostras do sensor (1 bit cada) e contagem em HIGH da janela da Detecção de Movimento.
+      float _inversoJanelaDetecMov = 1.0; // 1 / janela da Detecção de Movimento, calculado ao alterar a janela (valorFiltrado sem divisão).
+    unsigned long _tempoMinimoEntrePulsacoes; // Define o intervalo de tempo mínimo (em microssegundos) entre duas detecções consecutivas de pulsos enquanto o filtro de glitches ainda não tem a mediana.
+    uint8_t _fracaoFiltroGlitch = 50; // Filtro de glitches: rejeita bordas que chegam antes desta porcentagem da mediana dos últimos períodos (0 desativa).
+    bool _correcaoPulsos = true; // Corrige a contagem de riscos e o ângulo quando um intervalo contém riscos não detectados.
+    CadeiaFiltro _cadeiaFiltro = FILTRO_NENHUM; // Cadeia de filtros aplicada ao intervalo no estimador por período.
+    cadeiaIntervaloRapida _cadeiaRapida;   // Estado de cada cadeia pré-montada (apenas a selecionada recebe amostras).
+    cadeiaIntervaloSuave _cadeiaSuave;
+    cadeiaIntervaloRobusta _cadeiaRobusta;
+    filtroRastreamento _rastreamento; // Estimativas de velocidade e aceleração a cada borda (opcional).
+    bool _rastreamentoAtivo = false;  // calcularRPM() retorna a velocidade do filtro de rastreamento.
+    MarcaIndice _marcaIndice = MARCA_NENHUMA; // Tipo de marca de índice do disco.
+    geometriaDisco<SENSOR_OPTICO_MAX_RISCOS_GEOMETRIA> _geometria; // Largura de cada risco do disco: corrige cada intervalo com uma multiplicação.
+    janelaVolta _janelaVolta; // Instantes das bordas da última volta (ESTIMADOR_VOLTA), reservados na arena só com esse estimador.
+    TelemetriaRPM _modoTelemetria = TELEMETRIA_TEXTO; // Saída das medições publicadas pelo calcularRPM().
+    telemetriaBinaria<SENSOR_OPTICO_TAMANHO_QUADRO_TELEMETRIA> _telemetria; // Quadro em montagem e contadores da telemetria binária.
+    capturaBordasSensor* _captura = nullptr; // Captura das bordas brutas associada (externa: a memória só existe quando usada).
     
     
 
       /**************************************************************************************************************************************
-      * _limiarPulsacoes: Define o número mínimo de pulsos detectados em um intervalo de tempo para considerar uma rotação completa. 
-      * Um valor mais alto aumenta a confiabilidade dadetecção, mas pode atrasar a resposta. Por exemplo, se o limiar for 5, o sensor 
-      * só considerará uma rotação completa se detectar pelo menos 5 pulsos dentro do intervalo definido por _tempoMinimoEntrePulsacoes.
+      * _limiarPulsacoes: Define a menor duração (em microssegundos) de um nível alto ou baixo que ainda é considerada parte de um pulso válido.
+      * É calibrado a partir da média e do desvio padrão dos tempos em alto e em baixo: menor(média - 3 * fatorAjusteLimiar * desvio).
+      * A calibração só aceita o limiar quando a média dos dois tempos converge (erro relativo abaixo de SENSOR_OPTICO_ERRO_CONVERGENCIA_LIMIAR).
+      * Depois disso, processarBorda() descarta todo nível mais curto que o limiar (limitado a 1/4 do período no RPM máximo, lerLimiarNivel()),
+      * com as suas duas transições: cada transição só é aplicada depois que o novo nível dura o limiar, o que atrasa a medição nesse tempo.
       *  - Fatores que Influenciam o Limiar Ideal:
       *  - Número de riscos no disco: Um disco com mais riscos geralmente permite uma detecção mais precisa, pois há mais transições entre os estados alto e baixo dos sinais.
       *  - Velocidade de rotação: Para altas velocidades, um limiar menor pode ser suficiente, pois haverá mais transições em um intervalo de tempo menor.
       *  - Ruído elétrico: Um ambiente com muito ruído elétrico pode exigir um limiar maior para filtrar as falsas detecções.
       *  - Estabilidade mecânica: Vibrações ou desalinhamentos no sistema podem causar flutuações no sinal, exigindo um ajuste no limiar.
       *
-      * _tempoMinimoEntrePulsacoes: Define o intervalo de tempo mínimo (em milissegundos) entre duas detecções consecutivas de pulsos.
+      * _tempoMinimoEntrePulsacoes: Define o intervalo de tempo mínimo (em microssegundos) entre duas detecções consecutivas de pulsos.
       * Essa variável serve para filtrar ruídos e evitar a contagem dupla de pulsos, garantindo uma contagem mais precisa. 
       * Um valor muito baixo pode levar a falsas detecções, enquanto um valor muito alto pode atrasar a resposta do sistema.
       * Ajuste esse valor de acordo com a velocidade de rotação esperada e o nível de ruído do ambiente.
@@ -104,57 +292,86 @@ class sensorOpticoPro
       * A precisão do cálculo do RPM depende diretamente da precisão desse valor.
       ***************************************************************************************************************************************/
   
-  //Estado do Sensor Óptico
-int _estadoAtual;                 // Armazena o estado atual do sensor (0 ou 1).
-int _estadoAnterior = -1;         // Armazena o estado anterior do sensor.
-                                  // Inicializar com -1 é crucial para o correto
-                                  // funcionamento da lógica de medição de tempo.
-                                  // Na primeira execução da função ajustarDistanciaSensorOptico(),
-                                  // _estadoAnterior não possui um valor válido (0 ou 1). Se fosse
-                                  // inicializado com 0 ou 1, a primeira leitura sempre resultaria
-                                  // em uma "mudança de estado" falsa, levando a um cálculo
-                                  // incorreto do primeiro tempo medido. O valor -1 garante que
-                                  // a primeira comparação _estadoAtual != _estadoAnterior seja
-                                  // sempre verdadeira, mas impede o calculo do tempo decorrido
-                                  // na primeira execução.
-unsigned long _tempoAlto = 0; // Armazena o tempo decorrido no estado ALTO na iteração ANTERIOR.
-                                  // Usado para calcular a diferença entre os tempos alto e baixo.
-                                  // Inicializado com 0 para evitar valores incorretos na primeira iteração.
-unsigned long _tempoBaixo = 0; // Armazena o tempo decorrido no estado BAIXO na iteração ANTERIOR.
-                                  // Usado para calcular a diferença entre os tempos alto e baixo.
-                                  // Inicializado com 0 para evitar valores incorretos na primeira iteração.
-unsigned long _tempoAnterior = 0; // Armazena o valor de micros() da última transição de estado.
-                                  // Usado para calcular o tempo decorrido em cada estado.
-                                  // Inicializado com 0 para evitar erros de calculo na primeira execução.
-String distanciaSevera = "";      // Armazena a distancia severa do sensor (se esta muito longe ou muito perto);
+  //Ajuste da Distância do Sensor Óptico
+analisadorCicloTrabalho _analisadorAjuste;      // Histogramas e somas dos tempos em alto e em baixo (alimentado por processarBorda()).
+uint64_t _instanteUltimaPublicacaoAjuste = 0; // Instante (micros, 64 bits) do último relatório do ajuste.
+unsigned long _intervaloPublicacaoAjuste = 500000; // Intervalo (micros) entre relatórios do ajuste (padrão 2 Hz).
+bool _ajusteAtivo = false;                      // Indica se o ajuste está acumulando tempos.
 
 //Calcular Limiar de acordo com RPM e Número de Riscos
 bool _limiarCalculado = false;      // Indica se o limiar de pulsações já foi calculado.
-unsigned long _limiarCalculadoValor;
+
+//Estado de Medição (por instância, permite vários sensores no mesmo loop)
+EstadoMedicao _estado = {};
+
+//Captura de Bordas por Interrupção
+bufferCircularSPSC<RegistroBorda, SENSOR_OPTICO_CAPACIDADE_FILA> _filaBordas; // Fila entre a interrupção (produtor) e calcularRPM() (consumidor).
+bool _capturaPorInterrupcao = false; // Indica se as bordas chegam pela fila (true) ou por digitalRead() no loop (false).
+int8_t _numeroInterrupcao = -1;      // Interrupção externa associada ao pino (-1 quando não está em uso).
+
+static sensorOpticoPro* _instanciasInterrupcao[SENSOR_OPTICO_MAX_INTERRUPCOES]; // Instância atendida por cada interrupção externa.
+static arenaMemoriaFixa<SENSOR_OPTICO_TAMANHO_ARENA> _arena; // Memória dos modos opcionais, compartilhada por todos os sensores.
+static void tratarInterrupcao0(); // Rotinas de interrupção: uma por interrupção externa, pois attachInterrupt() não recebe contexto.
+static void tratarInterrupcao1();
+
+bool atualizarMedicao(); // Consome as bordas pendentes (fila ou varredura). Retorna true se houve medição nova.
+bool processarTransicao(unsigned long instante, uint8_t nivel); // Transição já filtrada pelo limiar: calibração, ajuste, riscos e RPM.
+bool confirmarTransicaoPendente(unsigned long agora); // Aplica a transição pendente se o nível já durou o limiar em 'agora'.
+void registrarMedicao(uint16_t bordas, unsigned long periodo); // Publica uma medição em ponto fixo (M bordas em T micros).
+bool processarJanelaMT(unsigned long instante, unsigned long tempoDecorrido, uint8_t riscos); // Estimador M/T: conta os riscos da janela e fecha a janela na primeira borda após a duração mínima.
+bool processarJanelaVolta(unsigned long instante, uint8_t riscos); // Estimador de uma volta: duração da última volta a cada borda, em O(1).
+void anunciarTelemetria(); // Envia o quadro de configuração (disco e estimador) quando a telemetria binária está ativa.
+void atualizarFatoresDisco(); // Recalcula as constantes de conversão do disco após uma troca de _numRiscos.
+void configurarJanelaVolta(); // Reserva na arena a janela de uma volta no tamanho do disco, ou a devolve (volta ao M/T se o disco não couber).
+uint8_t riscosNoIntervalo(unsigned long tempoDecorrido); // Classifica o intervalo (normal ou com riscos perdidos) e retorna quantos riscos ele contém.
+static uint8_t multiploPeriodo(unsigned long intervalo, unsigned long periodo); // k se o intervalo estiver a até 1/4 de período de k períodos (0: nenhum).
+static unsigned long restoMultiplo(unsigned long intervalo, unsigned long periodo); // Distância (micros) do intervalo ao múltiplo (k >= 1) mais próximo do período.
+bool processarCandidataSubida(unsigned long instante); // Filtro de glitches e união de fragmentos antes de aceitar uma borda de subida.
+bool processarSubida(unsigned long instante); // Borda de subida aceita: riscos, ângulo, índice, geometria e estimadores.
+bool reconhecerMarcaIndice(uint8_t posicao); // Confirma ou propõe a marca de índice; retorna true se a contagem deve ir ao risco 0.
+bool reposicionarIndice(); // Leva a contagem ao risco 0 na marca de índice (retorna true se o índice mudou).
+void registrarFalhaMarcaIndice(); // Conta uma volta sem a marca de índice.
+void verificarMarcaLarga(unsigned long duracaoAlto); // Marca de risco largo: compara o nível alto que terminou com o anterior.
+unsigned long filtrarIntervalo(unsigned long intervalo); // Passa o intervalo de um risco pela cadeia de filtros selecionada.
+void atualizarExtrapolacao() const; // Recalcula os coeficientes de lerAnguloEm() após uma borda nova.
+void registrarParada(); // Zera a leitura e as referências de velocidade quando o tempo limite passa sem bordas.
+void concluirAprendizadoGeometria(); // Calcula a tabela da geometria ao fim do aprendizado e informa o resultado.
+bool bordaEhGlitch(unsigned long instante); // Filtro de glitches adaptativo: registra o intervalo candidato e indica se a borda de subida deve ser rejeitada.
 
   //Status do Sensor
   uint8_t lerDadosDeRegistro(uint8_t registro); // Lê dados de um registrador específico do sensor (para verificar status, por exemplo).
 
   //Calcular Tempo Minimo Entre Pulsos e Limiar Ideal atraves di RPM
-  void calcularLimiarIdeal(); // Calcula e ajusta o limiar de pulsos dinamicamente.
-    TemposPulso lerValorPulso(); // Declaração corrigida
-    double calcularMedia(const uint16_t* dadosPulsos, int tamanho); // Calcula a média de um conjunto de amostras.
-    double calcularDesvioPadrao(const uint16_t* dadosPulsos, double media, int tamanho); // Calcula o desvio padrão de um conjunto de amostras.
-    double calcularPotencia(double base, int expoente); // Calcula a potencia de um numero
+  void calcularLimiarIdeal(); // Inicia a calibração do limiar (não bloqueia: os tempos são acumulados em processarBorda()).
+    void acumularCalibracaoLimiar(bool nivelAlto, unsigned long duracao); // Acumula um tempo em alto ou em baixo e aceita o limiar quando convergir.
   void calcularTempoMinimoEntrePulsacoes(); // Calcula o tempo mínimo entre pulsos com base no RPM e número de riscos (Pulsos).
 
   
   public:
     sensorOpticoPro(uint8_t pinoSensor); // Construtor da classe: inicializa o sensor com o pino especificado.
+    ~sensorOpticoPro(); // Devolve à arena a memória reservada pelo sensor.
 
     void iniciar(void);// Inicializa o sensor e seus parâmetros.
     
     bool statusConexaoSensorOptico(); // Verifica o Status da Conexão com o Sensor
-    unsigned long lerInstanteInicial(); // Getter para acessar o instante inicial do Processo.
+    void exibirRelatorioMemoria() const; // Exibe a RAM estática ocupada por instância e a ocupação da arena (nenhum vetor é alocado no heap).
+    static arenaMemoria& lerArena(); // Arena compartilhada pelos sensores (a captura de bordas também reserva nela).
+    uint64_t lerInstanteInicial(); // Getter para acessar o instante inicial do Processo (micros, 64 bits).
+    void configurarBaseTempo(FonteTempo fonte); // Troca a fonte do relógio (micros() por padrão; lerRelogioSimulado nos testes). Chamar antes do iniciar().
+    baseTempo& lerBaseTempo(); // Relógio de 64 bits usado pelas medições.
     uint16_t lerRpmDesejado() const; // Getter para acessar o valor do RPM Desejado.
     uint8_t lerNumRiscos() const; // Getter para acessar o valor da quantidade de Riscos do Disco.
-    float lerRpmAtual() const; // Getter para acessar o valor do RPM Atual.
-    float lerAnguloAtual() const; // Getter para acessar o valor do Angulo Atual.
+    uint8_t lerPinoSensor() const; // Getter para acessar o pino digital do Sensor.
+    float lerRpmAtual() const; // Getter para acessar o valor do RPM Atual (convertido da medição em ponto fixo na leitura).
+    float lerAnguloAtual() const; // Getter para acessar o valor do Angulo Atual em graus (na última borda de subida).
+    float lerVelocidadeAngular() const; // Getter para acessar a velocidade angular em radianos por segundo.
+    uint32_t lerRpmMili() const; // RPM atual em milésimos de RPM (inteiro, sem ponto flutuante).
+    uint32_t lerVelocidadeAngularMiliRad() const; // Velocidade angular em milirradianos por segundo (inteiro).
+    uint16_t lerAnguloBinario() const; // Ângulo atual em unidades binárias: 65536 equivale a uma volta completa.
+    uint8_t lerIndiceRisco() const; // Índice do risco da última borda de subida (0 a numRiscos - 1).
+    float lerRpmRastreado() const; // RPM estimado pelo filtro de rastreamento (0 com o filtro desligado).
+    float lerAceleracaoRpm() const; // Aceleração em RPM/s estimada pelo filtro de rastreamento (0 com o filtro desligado).
+    uint16_t lerAnguloEm(unsigned long instante) const; // Ângulo binário extrapolado para o instante (micros) com velocidade e aceleração, entre as bordas.
 
     /******************** Calibração e configuraçãos ********************/
       void configurarParametrosSensorOptico(uint8_t config_numRiscos, uint16_t config_rpmInicial); // Inicializa o sensor com o RPM e o número de riscos desejados.
@@ -164,18 +381,86 @@ unsigned long _limiarCalculadoValor;
       void novoNumRiscos(uint8_t novoNumRiscos); // Configura um novo número de riscos no disco. Como é um valor de 8 bits, o máximo de Riscos é 255.
       void novoFatorAjusteLimiar(float novoFator); // Configura um novo fator de ajuste para o limiar de pulsos. Usado para calibrar o sensor em diferentes condições de iluminação ou ruído.
       void novoNumAmostrasLimiar(uint16_t novoNumAmostrasLimiar); // Configura o número de amostras usadas para o cálculo do limiar.
+      uint16_t lerNumAmostrasLimiar() const; // Getter para o número de amostras do cálculo do limiar.
+      unsigned long lerLimiarPulsacoes() const; // Getter para o limiar calibrado (micros).
+      unsigned long lerLimiarNivel() const; // Menor duração (micros) de um nível aceita pelo filtro de nível (0: filtro inativo).
+      unsigned long lerNiveisCurtos() const; // Getter para o número de níveis descartados pelo filtro de nível.
+      bool limiarCalibrado() const; // Indica se a calibração do limiar convergiu.
+      void recalibrarLimiar(); // Reinicia a calibração do limiar (o limiar atual vale até a nova convergência).
+      float lerErroRelativoLimiar() const; // Erro relativo da média alcançado pela calibração (confiança do limiar).
+      const estatisticaWelford& lerCalibracaoTempoAlto() const; // Média e desvio dos tempos em nível alto.
+      const estatisticaWelford& lerCalibracaoTempoBaixo() const; // Média e desvio dos tempos em nível baixo.
       void novoNumAmostrasDetecMov(uint16_t novoNumAmostrasDetecMov); // Configura o número de amostras usadas para a detecção de movimento.
+      uint16_t lerNumAmostrasDetecMov() const; // Getter para o número de amostras da detecção de movimento.
+      void novoEstimadorRPM(EstimadorRPM novoEstimador); // Seleciona o estimador de RPM (período, M/T ou volta) e reinicia a janela de medição.
+      void novaTaxaAtualizacaoRPM(uint16_t novaTaxaHz); // Configura a taxa alvo de atualização do RPM (Hz) do estimador M/T.
+      void novaFracaoFiltroGlitch(uint8_t novaFracao); // Configura a porcentagem da mediana dos períodos abaixo da qual uma borda é rejeitada (0 desativa o filtro).
+      uint8_t lerFracaoFiltroGlitch() const; // Getter para a porcentagem do filtro de glitches.
+      unsigned long lerBordasRejeitadas() const; // Getter para o número de bordas rejeitadas pelo filtro de glitches.
+      unsigned long lerPeriodoMediano() const; // Mediana (micros) dos últimos intervalos entre bordas de subida (0 enquanto a janela não estiver cheia).
+      void ativarCorrecaoPulsos(bool ativar); // Liga ou desliga a correção de riscos perdidos (a classificação e os contadores continuam).
+      bool lerCorrecaoPulsos() const; // Getter para o estado da correção de riscos perdidos.
+      unsigned long lerPulsosNormais() const; // Intervalos classificados como normais (um risco).
+      unsigned long lerPulsosPerdidos() const; // Riscos não detectados e reconstituídos pela correção.
+      unsigned long lerPulsosExtras() const; // Bordas extras (intervalo ~ período/k) descartadas pelo filtro de glitches ou unidas ao intervalo seguinte.
+      void novaCadeiaFiltro(CadeiaFiltro novaCadeia); // Seleciona a cadeia de filtros do intervalo (estimador por período).
+      CadeiaFiltro lerCadeiaFiltro() const; // Getter para a cadeia de filtros em uso.
+      void ativarFiltroRastreamento(bool ativar); // Liga ou desliga o filtro de rastreamento (ligado, calcularRPM() retorna a velocidade filtrada).
+      bool novoRuidoProcesso(float ruido); // Ruído de processo do filtro de rastreamento (maior: segue mudanças mais rápido, com mais ruído).
+      const filtroRastreamento& lerFiltroRastreamento() const; // Estado e ganhos do filtro de rastreamento.
+      void novoTempoParada(uint16_t milissegundos); // Tempo sem bordas até o disco ser considerado parado (abaixo de 60000 / (numRiscos * tempo) RPM).
+      uint16_t lerTempoParada() const; // Getter para o tempo limite de parada (ms).
+      bool girando() const; // Indica se houve borda de subida dentro do tempo limite de parada.
+      uint8_t lerEventosMovimento(); // Retorna os eventos de parada e partida ocorridos desde a última leitura (bits de EventoMovimento) e os apaga.
+      void novaMarcaIndice(MarcaIndice novaMarca); // Seleciona a marca de índice do disco (a sincronização recomeça).
+      MarcaIndice lerMarcaIndice() const; // Getter para a marca de índice em uso.
+      bool indiceSincronizado() const; // Indica se o ângulo (lerAnguloAtual, lerAnguloBinario) é absoluto, medido a partir da marca de índice.
+      unsigned long lerVoltas() const; // Contador de voltas (passagens pelo risco 0).
+      unsigned long lerMarcasIndice() const; // Marcas de índice reconhecidas.
+      unsigned long lerFalhasIndice() const; // Voltas em que a marca de índice não apareceu.
+      bool aprenderGeometria(uint16_t voltas); // Aprende a largura de cada risco durante 'voltas' voltas em velocidade constante (não bloqueia).
+      void desativarGeometria(); // Volta a considerar todos os riscos com a largura nominal.
+      const geometriaDisco<SENSOR_OPTICO_MAX_RISCOS_GEOMETRIA>& lerGeometria() const; // Tabela de correção e estado do aprendizado.
+      EstimadorRPM lerEstimadorRPM() const; // Getter para o estimador de RPM em uso.
+      uint16_t lerTaxaAtualizacaoRPM() const; // Getter para a taxa alvo de atualização do RPM (Hz).
 
     // Contagem dos Pulsos e Calculo do RPM
     void iniciarSensorOptico(); // Inicializa o sensor óptico e prepara o sistema para a leitura dos pulsos. Realiza configurações iniciais e calibrações, se necessário.
 
     Movimento detectarMovimento(bool estadoSensor);  // Detecta a ocorrência de movimento com base no estado do sensor. Retorna informações sobre a detecção.
+    bool verificarParada(uint64_t instante); // Decai a leitura e detecta a parada no instante (micros, 64 bits da base de tempo) sem bordas. Chamada pelo calcularRPM(); retorna true se a leitura mudou.
     float calcularRPM(); // Calcula o RPM com base nas leituras do sensor, utilizando o limiar e o tempo mínimo entre pulsos para filtragem de ruídos.
-    void ajustarDistanciaSensorOptico(); // Função para auxiliar no ajuste físico da distância entre o sensor e o disco. Envolve leituras e comparações para indicar a distância ideal.
+    void publicarMedicao(float rpm); // Envia a medição nova pela telemetria selecionada (chamada pelo calcularRPM() a cada medição).
+
+    // Telemetria
+    void configurarTelemetria(TelemetriaRPM modo, SaidaTelemetria saida = escreverTelemetriaSerial); // Seleciona a saída das medições (a binária começa com o quadro de configuração).
+    TelemetriaRPM lerModoTelemetria() const; // Getter para a saída das medições em uso.
+    void descarregarTelemetria(); // Envia as amostras binárias pendentes sem esperar o quadro encher.
+    const telemetriaBinaria<SENSOR_OPTICO_TAMANHO_QUADRO_TELEMETRIA>& lerTelemetria() const; // Contadores de bytes, amostras e quadros.
+    static void escreverTelemetriaSerial(const uint8_t* quadro, uint8_t tamanho); // Saída padrão: o quadro entra como mensagem de telemetria na saidaSerial.
+
+    // Captura das Bordas Brutas
+    void associarCaptura(capturaBordasSensor* captura); // Passa cada borda processada para a captura (nullptr desassocia). A captura é atendida pelo calcularRPM().
+    capturaBordasSensor* lerCaptura() const; // Getter para a captura associada.
+    static bool enviarCapturaSerial(const uint8_t* quadro, uint8_t tamanho); // Saída padrão da captura: entra na saidaSerial somente se couber (sem descartes).
+    void ajustarDistanciaSensorOptico(); // Função para auxiliar no ajuste físico da distância entre o sensor e o disco. Não bloqueia: acumula os tempos e publica o relatório na taxa configurada.
+    void pararAjusteDistanciaSensorOptico(); // Encerra o ajuste (os tempos deixam de ser acumulados).
+    void novaTaxaPublicacaoAjuste(uint8_t novaTaxaHz); // Configura quantos relatórios do ajuste são publicados por segundo.
+    uint8_t lerTaxaPublicacaoAjuste() const; // Getter para a taxa de publicação do ajuste (Hz).
+    const analisadorCicloTrabalho& lerAnalisadorAjuste() const; // Histogramas, ciclo de trabalho e pontuação da janela atual do ajuste.
+
+    // Captura de Bordas por Interrupção
+    bool ativarCapturaPorInterrupcao(); // Passa a capturar as bordas por interrupção (CHANGE). Retorna false se o pino não possuir interrupção externa livre.
+    void desativarCapturaPorInterrupcao(); // Volta a detectar as bordas por digitalRead() dentro do calcularRPM().
+    void ativarCapturaExterna(); // As bordas chegam pela fila, registradas por um produtor externo (grupoSensorOpticoPro), sem interrupção.
+    bool registrarBorda(unsigned long instante, uint8_t nivel); // Produtor da fila: chamado pela interrupção ou por uma fonte de bordas simulada. Retorna false em transbordo.
+    bool processarBorda(unsigned long instante, uint8_t nivel); // Consumidor: atualiza a medição a partir de uma borda (varredura, fila ou fonte simulada). Retorna true se houve medição nova.
+    uint16_t lerBordasPerdidas() const; // Getter para o número de bordas descartadas por fila cheia.
+    uint8_t lerOcupacaoMaximaFila() const; // Getter para a maior ocupação observada na fila de bordas.
+    void zerarContadoresCaptura(); // Zera os contadores de transbordo e de ocupação máxima da fila.
 
     // Calcular a velocidade angular
-    void  calcularVelocidadeAngular(float rpmAtual); // Calcula a velocidade angular com base nas variações do ângulo. 
-    // ---------- Lógica de cálculo ainda a ser implementada. ----------
+    float calcularVelocidadeAngular(float rpmAtual); // Converte um RPM em velocidade angular (rad/s) e a armazena em _velocidadeAngular.
 
 };
 
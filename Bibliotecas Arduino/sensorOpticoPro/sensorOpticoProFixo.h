@@ -0,0 +1,62 @@
+/*
+ * sensorOpticoProFixo.h
+ *
+ * Descrição: Variante do sensorOpticoPro para instalações com disco de
+ * geometria fixa (ex.: Disco Decodificador de 36 riscos). O número de riscos
+ * e o RPM máximo são parâmetros do template, de modo que as constantes de
+ * conversão (RPM, ângulo por risco e tempo mínimo entre pulsos) são
+ * calculadas na compilação. O construtor carrega os fatores do disco do
+ * sensorOpticoPro (atualizarFatoresDisco) uma única vez: os getters da base
+ * multiplicam por eles no lugar de dividir por _numRiscos, tanto chamados
+ * pela variante quanto por uma referência sensorOpticoPro&.
+ *
+ * API: herda de sensorOpticoPro, portanto mantém a mesma interface pública e
+ * pode ser passada para o gerenciadorComandos (sensorOpticoPro&). Os comandos
+ * que alteram o número de riscos ou o RPM máximo são recusados, pois esses
+ * valores fazem parte do tipo.
+ *
+ * Utilização:
+ *   sensorOpticoProFixo<36, 1000> sensorOptico(2); // no lugar de sensorOpticoPro sensorOptico(2);
+ *
+ * Dependências:
+ *   - sensorOpticoPro.h
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef sensorOpticoProFixo_h // Guarda de inclusão.
+#define sensorOpticoProFixo_h
+
+#include "sensorOpticoPro.h"
+
+template <uint8_t NumRiscos, uint16_t RpmMaximo>
+class sensorOpticoProFixo : public sensorOpticoPro
+{
+  static_assert(NumRiscos >= 1, "O disco deve ter pelo menos um risco.");
+  static_assert(RpmMaximo >= 1, "O RPM maximo deve ser maior que zero.");
+
+  public:
+    // Constantes da geometria do disco, calculadas na compilação.
+    static constexpr float FATOR_RPM = 60000000.0 / NumRiscos;                 // RPM = FATOR_RPM * M / T (T em micros).
+    static constexpr float GRAUS_POR_RISCO = 360.0 / NumRiscos;                // Ângulo de um risco em graus.
+    static constexpr uint32_t ANGULO_BINARIO_POR_RISCO_Q16 = (uint32_t)((4294967296ULL + NumRiscos - 1) / NumRiscos); // Ângulo binário (65536 = volta) por risco, em Q16.16 (arredondado para cima).
+    static constexpr unsigned long TEMPO_MINIMO_ENTRE_PULSACOES = 60000000UL / ((unsigned long)RpmMaximo * NumRiscos); // Intervalo (micros) entre riscos no RPM máximo.
+
+    sensorOpticoProFixo(uint8_t pinoSensor) : sensorOpticoPro(pinoSensor) {
+      _numRiscos = NumRiscos;
+      _rpmMaximo = RpmMaximo;
+      _tempoMinimoEntrePulsacoes = TEMPO_MINIMO_ENTRE_PULSACOES;
+      _geometriaFixa = true;
+      atualizarFatoresDisco(); // Fatores do disco do template, usados pelos getters do sensorOpticoPro (também por sensorOpticoPro&).
+    }
+};
+
+// Definições das constantes (necessárias em C++11 caso sejam usadas por referência).
+template <uint8_t NumRiscos, uint16_t RpmMaximo> constexpr float sensorOpticoProFixo<NumRiscos, RpmMaximo>::FATOR_RPM;
+template <uint8_t NumRiscos, uint16_t RpmMaximo> constexpr float sensorOpticoProFixo<NumRiscos, RpmMaximo>::GRAUS_POR_RISCO;
+template <uint8_t NumRiscos, uint16_t RpmMaximo> constexpr uint32_t sensorOpticoProFixo<NumRiscos, RpmMaximo>::ANGULO_BINARIO_POR_RISCO_Q16;
+template <uint8_t NumRiscos, uint16_t RpmMaximo> constexpr unsigned long sensorOpticoProFixo<NumRiscos, RpmMaximo>::TEMPO_MINIMO_ENTRE_PULSACOES;
+
+#endif // sensorOpticoProFixo_h
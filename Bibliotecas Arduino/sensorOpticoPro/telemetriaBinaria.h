@@ -0,0 +1,553 @@
+/*
+ * telemetriaBinaria.h
+ *
+ * Descrição: Telemetria binária compacta para as medições do sensorOpticoPro.
+ * Substitui o texto "RPM: 999.80\r\n" (13 bytes e a formatação do float a cada
+ * medição) por quadros binários que agrupam várias amostras, com os campos
+ * codificados por diferença em relação à amostra anterior e previstos. Há
+ * duas previsões, escolhidas pelo estimador do quadro de configuração:
+ *
+ *   Uma amostra por borda (período, volta: QUADRO_AMOSTRAS)
+ *   - o intervalo é previsto por risco: k riscos depois da amostra anterior
+ *     (k = 1, ou o múltiplo do intervalo quando há riscos perdidos), o
+ *     intervalo previsto é k x o último intervalo por risco;
+ *   - o risco é o k-ésimo seguinte ao da amostra anterior (só é enviado
+ *     quando não é: marca de índice);
+ *   - a variação do RPM é prevista pela variação do intervalo (no estimador
+ *     por período, RPM x intervalo é constante: dRPM ~ -RPM / intervalo x
+ *     dIntervalo); o codificador envia o resíduo da previsão ou a variação
+ *     direta (volta: RPM parado enquanto o intervalo varia), o que for
+ *     menor, com um bit indicando qual.
+ *
+ *   Uma amostra por janela (M/T: QUADRO_AMOSTRAS_JANELA)
+ *   - a janela tem os mesmos riscos da janela anterior (o risco avança esse
+ *     passo; só é enviado quando muda);
+ *   - o RPM é calculado da janela: 60e6 x passo / (numRiscos x intervalo),
+ *     o próprio M/T. Sem correção da geometria o resíduo é zero e a amostra
+ *     leva apenas a variação do intervalo.
+ *
+ * Na amostra curta (um único byte) cabem as variações entre -4 e 3 (por
+ * borda) ou a variação do intervalo entre -64 e 63 (por janela); senão, um
+ * byte de controle e as variações em zigzag. A codificação por borda usa
+ * apenas somas, deslocamentos, comparações e uma multiplicação pequena em
+ * inteiros (a inclinação da previsão é calculada uma vez por quadro; a
+ * divisão pelo número de riscos só nas amostras longas); a por janela faz
+ * uma divisão de 64 bits por amostra, algumas dezenas por segundo. A
+ * verificação e o enquadramento (CRC e COBS) são feitos uma vez por quadro,
+ * no próprio vetor do quadro.
+ *
+ * Formato (inteiros sem sinal em varint LEB128: 7 bits por byte, bit 7 indica
+ * continuação; com sinal em zigzag: 0, -1, 1, -2... -> 0, 1, 2, 3...):
+ *
+ *   QUADRO_CONFIGURACAO: tipo, versão, numRiscos, estimador
+ *   QUADRO_AMOSTRAS:     tipo, instante (varint), intervalo por risco (varint), RPM (zigzag), risco (1 byte)
+ *                        e, para cada amostra:
+ *                          0 i i i p r r r                  amostra curta (k = 1): zigzag de 3 bits da variação
+ *                                                           do intervalo (i) e do RPM ou do resíduo (r)
+ *                          1 x p k k k k k, zigzag(dI), zigzag(dR) [, risco]   amostra longa
+ *                        k: riscos desde a amostra anterior (0 vale 1); intervalo = k * intervalo por risco + dI;
+ *                        p: r é o resíduo da previsão (com dI / k); x: o risco vem explícito (senão, risco anterior + k);
+ *                        intervalo por risco = intervalo / k; instante += intervalo
+ *   QUADRO_AMOSTRAS_JANELA: tipo, instante (varint), intervalo (varint), RPM (zigzag), risco (1 byte), passo (1 byte)
+ *                        e, para cada amostra:
+ *                          0 i i i i i i i                  amostra curta: zigzag de 7 bits da variação do
+ *                                                           intervalo; mesmo passo, RPM calculado da janela
+ *                          1 x q 0 0 0 0 0, zigzag(dI), zigzag(resíduo) [, passo] [, risco]   amostra longa
+ *                        q: o passo (riscos da janela) vem explícito; x: o risco vem explícito (senão, risco anterior + passo);
+ *                        RPM = 6e9 * passo / (numRiscos * intervalo) (centésimos, arredondado) + resíduo
+ *                        RPM em centésimos; ângulo = risco * 360 / numRiscos
+ *   QUADRO_EVENTO:       tipo, instante (varint), eventos (bits de EventoMovimento)
+ *   QUADRO_CAPTURA:      bordas brutas, descrito em capturaBordas.h
+ *
+ * O cabeçalho das amostras traz o estado anterior à primeira amostra (instante
+ * em micros de 32 bits, último intervalo, último RPM e último risco): cada
+ * quadro é decodificado sozinho (decodificarAmostrasTelemetria) e a perda de
+ * um quadro não corrompe os seguintes.
+ *
+ * Enquadramento: CRC-16 (polinômio 0x8408 refletido, valor inicial 0xFFFF, o
+ * _crc_ccitt_update da avr-libc) no fim do quadro, tudo codificado em COBS
+ * (nenhum byte 0 dentro do quadro) e terminado por 0x00. O receptor se
+ * sincroniza no próximo 0x00 depois de qualquer erro.
+ *
+ * A saída é um ponteiro para função (Serial.write no Arduino, um contador ou
+ * um vetor nos testes), chamada uma vez por quadro completo.
+ *
+ * Memória: Tamanho bytes do quadro (até 255) + 32 bytes de estado e contadores.
+ *
+ * Não depende do Arduino.h, podendo ser compilada e testada no Linux.
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef telemetriaBinaria_h // Guarda de inclusão.
+#define telemetriaBinaria_h
+
+#include <inttypes.h> // Tipos inteiros de tamanho fixo.
+
+#define TELEMETRIA_VERSAO 3 // Versão do formato, enviada no quadro de configuração (3: intervalo por risco e quadro por janela do M/T).
+#define TELEMETRIA_ESTIMADOR_MT 1 // Estimador do quadro de configuração com uma amostra por janela (ESTIMADOR_MT do sensorOpticoPro).
+
+typedef void (*SaidaTelemetria)(const uint8_t* quadro, uint8_t tamanho); // Recebe um quadro completo (COBS, terminado em 0x00).
+
+// Tipo do quadro (primeiro byte depois da decodificação COBS).
+enum TipoQuadroTelemetria : uint8_t {
+  QUADRO_CONFIGURACAO = 1, // Número de riscos e estimador: enviado ao configurar a telemetria e ao mudar o disco.
+  QUADRO_AMOSTRAS = 2,     // Amostras de RPM e ângulo codificadas por diferença.
+  QUADRO_EVENTO = 3,       // Parada ou partida do disco.
+  QUADRO_CAPTURA = 4,      // Bordas brutas do modo de captura (capturaBordas.h).
+  QUADRO_AMOSTRAS_JANELA = 5 // Amostras do M/T, uma por janela, com o RPM calculado do intervalo e do passo.
+};
+
+// Atualização do CRC-16 por byte, sem tabela (mesmo resultado do _crc_ccitt_update da avr-libc).
+inline uint16_t atualizarCrcTelemetria(uint16_t crc, uint8_t dado) {
+  dado ^= (uint8_t)crc;
+  dado ^= (uint8_t)(dado << 4);
+  return (((uint16_t)dado << 8) | (crc >> 8)) ^ (uint8_t)(dado >> 4) ^ ((uint16_t)dado << 3);
+}
+
+// Inclinação da previsão do RPM, em 1/16 de centésimo de RPM por micro: -RPM / intervalo (RPM x intervalo constante).
+// Calculada uma vez por quadro, com o estado do cabeçalho, pelo codificador e pelo decodificador. 0: sem previsão.
+inline int32_t inclinacaoRpmTelemetria(int32_t rpmCentesimos, uint32_t intervalo) {
+  if (intervalo == 0 || intervalo > 0x7FFFFFFFUL || rpmCentesimos < 0 || rpmCentesimos > 0x7FFFFFF) {
+    return 0;
+  }
+  int32_t inclinacao = -(rpmCentesimos * 16) / (int32_t)intervalo;
+  return (inclinacao < -0xFFFF) ? 0 : inclinacao; // Limita o produto em preverRpmTelemetria() a 31 bits.
+}
+
+// Variação do RPM (centésimos) prevista para uma variação do intervalo.
+inline int32_t preverRpmTelemetria(int32_t inclinacao, int32_t variacaoIntervalo) {
+  if (variacaoIntervalo < -0x7FFF || variacaoIntervalo > 0x7FFF) {
+    return 0;
+  }
+  return (inclinacao * variacaoIntervalo) >> 4;
+}
+
+// RPM (centésimos) de uma janela M/T de 'passo' riscos em 'intervalo' micros: 6e9 * passo / (numRiscos * intervalo),
+// arredondado. Previsão das amostras por janela, calculada igual pelo codificador e pelo decodificador. 0: sem previsão.
+inline int32_t preverRpmJanelaTelemetria(uint8_t numRiscos, uint8_t passo, uint32_t intervalo) {
+  if (numRiscos == 0 || intervalo == 0) {
+    return 0;
+  }
+  uint64_t divisor = (uint64_t)numRiscos * intervalo;
+  uint64_t rpm = (6000000000ULL * passo + divisor / 2) / divisor;
+  return rpm > 0x7FFFFFFF ? 0 : (int32_t)rpm;
+}
+
+// Risco 'passo' riscos depois de 'risco' em um disco de 'numRiscos' riscos.
+inline uint8_t avancarRiscoTelemetria(uint8_t risco, uint8_t passo, uint8_t numRiscos) {
+  uint16_t seguinte = (uint16_t)risco + passo;
+  return (uint8_t)(seguinte < numRiscos ? seguinte : seguinte % numRiscos);
+}
+
+// Fecha um quadro montado a partir da posição 1 (a posição 0 é reservada para o primeiro código COBS): acrescenta o
+// CRC, codifica em COBS no próprio vetor e acrescenta o terminador 0x00. O vetor precisa de 3 bytes livres no fim.
+// Retorna o tamanho do quadro pronto para a saída.
+inline uint8_t enquadrarTelemetria(uint8_t* quadro, uint8_t tamanho) {
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 1; i < tamanho; i++) {
+    crc = atualizarCrcTelemetria(crc, quadro[i]);
+  }
+  quadro[tamanho++] = (uint8_t)crc;
+  quadro[tamanho++] = (uint8_t)(crc >> 8);
+
+  // COBS: cada 0 vira a distância até o próximo 0 (ou até o fim); o quadro tem menos de 254 bytes, um código basta por trecho.
+  uint8_t codigo = 0;
+  for (uint8_t i = 1; i < tamanho; i++) {
+    if (quadro[i] == 0) {
+      quadro[codigo] = i - codigo;
+      codigo = i;
+    }
+  }
+  quadro[codigo] = tamanho - codigo;
+  quadro[tamanho++] = 0x00;
+  return tamanho;
+}
+
+// Decodifica no próprio vetor um quadro COBS recebido (sem o 0x00 final) e confere o CRC.
+// Retorna o tamanho do conteúdo (tipo e campos, sem o CRC), ou 0 se o quadro for inválido.
+inline uint8_t desenquadrarTelemetria(uint8_t* quadro, uint8_t tamanho) {
+  uint8_t lido = 0;
+  uint8_t escrito = 0;
+  while (lido < tamanho) {
+    uint8_t codigo = quadro[lido];
+    if (codigo == 0 || (uint16_t)lido + codigo > tamanho) {
+      return 0;
+    }
+    for (uint8_t i = 1; i < codigo; i++) {
+      quadro[escrito++] = quadro[lido + i];
+    }
+    lido += codigo;
+    if (lido < tamanho) {
+      quadro[escrito++] = 0;
+    }
+  }
+  if (escrito < 3) {
+    return 0;
+  }
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < escrito - 2; i++) {
+    crc = atualizarCrcTelemetria(crc, quadro[i]);
+  }
+  if (quadro[escrito - 2] != (uint8_t)crc || quadro[escrito - 1] != (uint8_t)(crc >> 8)) {
+    return 0;
+  }
+  return escrito - 2;
+}
+
+// Amostra decodificada de um QUADRO_AMOSTRAS.
+struct AmostraTelemetria {
+  uint32_t instante;      // Micros (32 bits).
+  int32_t rpmCentesimos;
+  uint8_t risco;
+};
+
+// Lê um varint de 'conteudo' a partir de 'posicao' (avança a posição). Retorna false se o quadro terminar antes.
+inline bool lerVarintTelemetria(const uint8_t* conteudo, uint8_t tamanho, uint8_t& posicao, uint32_t& valor) {
+  valor = 0;
+  for (uint8_t deslocamento = 0; deslocamento < 35; deslocamento += 7) {
+    if (posicao >= tamanho) {
+      return false;
+    }
+    uint8_t byte = conteudo[posicao++];
+    valor |= (uint32_t)(byte & 0x7F) << deslocamento;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+inline int32_t desfazerZigzagTelemetria(uint32_t valor) {
+  return (int32_t)(valor >> 1) ^ -(int32_t)(valor & 1);
+}
+
+// Decodifica o conteúdo de um QUADRO_AMOSTRAS ou QUADRO_AMOSTRAS_JANELA (saída de desenquadrarTelemetria, começando
+// pelo tipo) em 'amostras'. 'numRiscos' vem do QUADRO_CONFIGURACAO. Retorna o número de amostras, ou -1 se o conteúdo
+// estiver mal formado ou tiver mais de 'maxAmostras' amostras. Para o receptor no computador (e os testes no Linux): a
+// placa só codifica.
+inline int16_t decodificarAmostrasTelemetria(const uint8_t* conteudo, uint8_t tamanho, uint8_t numRiscos,
+                                             AmostraTelemetria* amostras, uint8_t maxAmostras) {
+  uint8_t posicao = 1;
+  uint32_t instante, intervalo, rpm;
+  if (tamanho < 1 || (conteudo[0] != QUADRO_AMOSTRAS && conteudo[0] != QUADRO_AMOSTRAS_JANELA) || numRiscos == 0
+      || !lerVarintTelemetria(conteudo, tamanho, posicao, instante)
+      || !lerVarintTelemetria(conteudo, tamanho, posicao, intervalo) || !lerVarintTelemetria(conteudo, tamanho, posicao, rpm)
+      || posicao >= tamanho) {
+    return -1;
+  }
+  bool janela = conteudo[0] == QUADRO_AMOSTRAS_JANELA;
+  int32_t rpmCentesimos = desfazerZigzagTelemetria(rpm);
+  uint8_t risco = conteudo[posicao++];
+  uint8_t passo = 1;
+  if (janela) {
+    if (posicao >= tamanho) {
+      return -1;
+    }
+    passo = conteudo[posicao++];
+  }
+  int32_t inclinacao = inclinacaoRpmTelemetria(rpmCentesimos, intervalo);
+  int16_t lidas = 0;
+  while (posicao < tamanho) {
+    uint8_t controle = conteudo[posicao++];
+    int32_t variacaoIntervalo, valorRpm = 0;
+    bool prevista = false, riscoExplicito = false, passoExplicito = false;
+    uint8_t riscos = 1; // Riscos desde a amostra anterior.
+    if (!(controle & 0x80)) {
+      if (janela) {
+        variacaoIntervalo = desfazerZigzagTelemetria(controle);
+      } else {
+        variacaoIntervalo = desfazerZigzagTelemetria((controle >> 4) & 0x07);
+        valorRpm = desfazerZigzagTelemetria(controle & 0x07);
+        prevista = controle & 0x08;
+      }
+    } else {
+      uint32_t valor;
+      riscoExplicito = controle & 0x40;
+      if (janela) {
+        passoExplicito = controle & 0x20;
+        if ((controle & 0x1F) != 0) {
+          return -1;
+        }
+      } else {
+        prevista = controle & 0x20;
+        riscos = (controle & 0x1F) != 0 ? (controle & 0x1F) : 1;
+      }
+      if (!lerVarintTelemetria(conteudo, tamanho, posicao, valor)) {
+        return -1;
+      }
+      variacaoIntervalo = desfazerZigzagTelemetria(valor);
+      if (!lerVarintTelemetria(conteudo, tamanho, posicao, valor)) {
+        return -1;
+      }
+      valorRpm = desfazerZigzagTelemetria(valor);
+    }
+    if (passoExplicito) {
+      if (posicao >= tamanho) {
+        return -1;
+      }
+      passo = conteudo[posicao++];
+    }
+    if (janela) {
+      intervalo += (uint32_t)variacaoIntervalo;
+      instante += intervalo;
+      rpmCentesimos = preverRpmJanelaTelemetria(numRiscos, passo, intervalo) + valorRpm;
+      riscos = passo;
+    } else {
+      uint32_t intervaloAmostra = riscos * intervalo + (uint32_t)variacaoIntervalo;
+      instante += intervaloAmostra;
+      rpmCentesimos += valorRpm + (prevista ? preverRpmTelemetria(inclinacao, variacaoIntervalo / riscos) : 0);
+      intervalo = (riscos == 1) ? intervaloAmostra : intervaloAmostra / riscos;
+    }
+    if (riscoExplicito) {
+      if (posicao >= tamanho) {
+        return -1;
+      }
+      risco = conteudo[posicao++];
+    } else {
+      risco = avancarRiscoTelemetria(risco, riscos, numRiscos);
+    }
+    if (lidas >= maxAmostras) {
+      return -1;
+    }
+    amostras[lidas].instante = instante;
+    amostras[lidas].rpmCentesimos = rpmCentesimos;
+    amostras[lidas].risco = risco;
+    lidas++;
+  }
+  return lidas;
+}
+
+template <uint8_t Tamanho>
+class telemetriaBinaria
+{
+  static_assert(Tamanho >= 35, "O quadro de telemetria deve ter pelo menos 35 bytes (maior cabeçalho, maior amostra e rodapé).");
+
+  private:
+    static const uint8_t MAX_AMOSTRA = 13; // Maior amostra codificada: controle, dois varints de 32 bits (5 bytes cada), o passo e o risco.
+    static const uint8_t RODAPE = 3;       // CRC (2 bytes) e o terminador 0x00.
+
+    uint8_t _quadro[Tamanho];      // Quadro em montagem; a posição 0 é reservada para o primeiro código COBS.
+    SaidaTelemetria _saida = nullptr;
+    uint32_t _ultimoInstante = 0;  // Instante (micros) da última amostra codificada.
+    uint32_t _ultimoIntervalo = 0; // Intervalo por risco da última amostra (por borda) ou intervalo da última janela (M/T).
+    int32_t _ultimoRpm = 0;        // RPM (centésimos) da última amostra.
+    int32_t _inclinacao = 0;       // Inclinação da previsão do RPM no quadro em montagem (inclinacaoRpmTelemetria).
+    uint8_t _ultimoRisco = 0;      // Risco da última amostra.
+    uint8_t _ultimoPasso = 1;      // Riscos da última janela (M/T).
+    uint8_t _numRiscos = 1;        // Para prever o risco seguinte.
+    bool _porJanela = false;       // Estimador M/T: QUADRO_AMOSTRAS_JANELA no lugar de QUADRO_AMOSTRAS.
+    unsigned long _bytesEnviados = 0;
+    unsigned long _amostrasEnviadas = 0;
+    unsigned long _quadrosEnviados = 0;
+    uint8_t _tamanho = 0;          // Bytes ocupados do quadro (0: nenhum quadro em montagem).
+
+    void escreverByte(uint8_t valor) {
+      _quadro[_tamanho++] = valor;
+    }
+
+    static uint32_t zigzag(int32_t valor) {
+      return ((uint32_t)valor << 1) ^ (uint32_t)(valor >> 31);
+    }
+
+    // Escreve um varint em 'destino' e retorna a posição seguinte.
+    static uint8_t* escreverVarint(uint8_t* destino, uint32_t valor) {
+      while (valor >= 0x80) {
+        *destino++ = (uint8_t)valor | 0x80;
+        valor >>= 7;
+      }
+      *destino++ = (uint8_t)valor;
+      return destino;
+    }
+
+    static bool cabeEm3Bits(int32_t valor) {
+      return valor >= -4 && valor <= 3;
+    }
+
+    void abrirQuadro(uint8_t tipo) {
+      _tamanho = 1; // Posição 0: primeiro código COBS.
+      escreverByte(tipo);
+    }
+
+    // Acrescenta o CRC, codifica em COBS no próprio vetor e entrega o quadro à saída.
+    void fecharQuadro() {
+      _tamanho = enquadrarTelemetria(_quadro, _tamanho);
+      if (_saida != nullptr) {
+        _saida(_quadro, _tamanho);
+      }
+      _bytesEnviados += _tamanho;
+      _quadrosEnviados++;
+      _tamanho = 0;
+    }
+
+    // Abre um quadro de amostras com o estado anterior à primeira amostra e calcula a inclinação da previsão do quadro.
+    void abrirQuadroAmostras() {
+      abrirQuadro(_porJanela ? QUADRO_AMOSTRAS_JANELA : QUADRO_AMOSTRAS);
+      uint8_t* fim = escreverVarint(_quadro + _tamanho, _ultimoInstante);
+      fim = escreverVarint(fim, _ultimoIntervalo);
+      fim = escreverVarint(fim, zigzag(_ultimoRpm));
+      *fim++ = _ultimoRisco;
+      if (_porJanela) {
+        *fim++ = _ultimoPasso;
+      }
+      _tamanho = (uint8_t)(fim - _quadro);
+      _inclinacao = inclinacaoRpmTelemetria(_ultimoRpm, _ultimoIntervalo);
+    }
+
+    // Riscos (1 a 31) contidos em um intervalo, pelo último intervalo por risco. Divide só acima de 1,5 risco.
+    uint8_t riscosNoIntervalo(uint32_t intervalo) const {
+      if (_ultimoIntervalo == 0 || intervalo < _ultimoIntervalo || intervalo - _ultimoIntervalo < _ultimoIntervalo / 2) {
+        return 1;
+      }
+      uint32_t riscos = (intervalo + _ultimoIntervalo / 2) / _ultimoIntervalo;
+      return (uint8_t)(riscos > 31 ? 31 : riscos);
+    }
+
+    // Codifica uma amostra por borda em 'destino' (até MAX_AMOSTRA bytes) em relação ao estado anterior.
+    // Retorna o tamanho; 'riscos' recebe os riscos desde a amostra anterior.
+    uint8_t codificarAmostraBorda(uint8_t* destino, uint32_t instante, int32_t rpmCentesimos, uint8_t risco,
+                                  uint8_t& riscos) const {
+      uint32_t intervalo = instante - _ultimoInstante;
+      int32_t variacaoRpm = rpmCentesimos - _ultimoRpm;
+      riscos = riscosNoIntervalo(intervalo);
+      int32_t variacaoIntervalo = (int32_t)(intervalo - riscos * _ultimoIntervalo);
+      int32_t residuo = variacaoRpm - preverRpmTelemetria(_inclinacao, riscos == 1 ? variacaoIntervalo : variacaoIntervalo / riscos);
+      bool prevista = zigzag(residuo) < zigzag(variacaoRpm);
+      int32_t valorRpm = prevista ? residuo : variacaoRpm;
+      bool riscoExplicito = risco != avancarRiscoTelemetria(_ultimoRisco, riscos, _numRiscos);
+      if (riscos == 1 && !riscoExplicito && cabeEm3Bits(variacaoIntervalo) && cabeEm3Bits(valorRpm)) {
+        destino[0] = (uint8_t)((zigzag(variacaoIntervalo) << 4) | (prevista ? 0x08 : 0) | zigzag(valorRpm));
+        return 1;
+      }
+      uint8_t* fim = destino;
+      *fim++ = 0x80 | (riscoExplicito ? 0x40 : 0) | (prevista ? 0x20 : 0) | (riscos == 1 ? 0 : riscos);
+      fim = escreverVarint(fim, zigzag(variacaoIntervalo));
+      fim = escreverVarint(fim, zigzag(valorRpm));
+      if (riscoExplicito) {
+        *fim++ = risco;
+      }
+      return (uint8_t)(fim - destino);
+    }
+
+    // Codifica uma amostra por janela (M/T). O RPM é previsto pelo passo da janela anterior; quando a previsão falha,
+    // o passo da janela é recuperado do próprio RPM (M = RPM * numRiscos * T / 6e9). 'passo' recebe os riscos da janela.
+    uint8_t codificarAmostraJanela(uint8_t* destino, uint32_t instante, int32_t rpmCentesimos, uint8_t risco,
+                                   uint8_t& passo) const {
+      uint32_t intervalo = instante - _ultimoInstante;
+      int32_t variacaoIntervalo = (int32_t)(intervalo - _ultimoIntervalo);
+      passo = _ultimoPasso;
+      if (risco == avancarRiscoTelemetria(_ultimoRisco, passo, _numRiscos) && zigzag(variacaoIntervalo) < 0x80
+          && rpmCentesimos == preverRpmJanelaTelemetria(_numRiscos, passo, intervalo)) {
+        destino[0] = (uint8_t)zigzag(variacaoIntervalo);
+        return 1;
+      }
+      if (rpmCentesimos > 0) {
+        uint64_t riscos = ((uint64_t)rpmCentesimos * _numRiscos * intervalo + 3000000000ULL) / 6000000000ULL;
+        passo = (uint8_t)(riscos < 1 ? 1 : (riscos > 255 ? 255 : riscos));
+      }
+      int32_t residuo = rpmCentesimos - preverRpmJanelaTelemetria(_numRiscos, passo, intervalo);
+      bool riscoExplicito = risco != avancarRiscoTelemetria(_ultimoRisco, passo, _numRiscos);
+      uint8_t* fim = destino;
+      *fim++ = 0x80 | (riscoExplicito ? 0x40 : 0) | (passo != _ultimoPasso ? 0x20 : 0);
+      fim = escreverVarint(fim, zigzag(variacaoIntervalo));
+      fim = escreverVarint(fim, zigzag(residuo));
+      if (passo != _ultimoPasso) {
+        *fim++ = passo;
+      }
+      if (riscoExplicito) {
+        *fim++ = risco;
+      }
+      return (uint8_t)(fim - destino);
+    }
+
+    uint8_t codificarAmostra(uint8_t* destino, uint32_t instante, int32_t rpmCentesimos, uint8_t risco, uint8_t& riscos) const {
+      return _porJanela ? codificarAmostraJanela(destino, instante, rpmCentesimos, risco, riscos)
+                        : codificarAmostraBorda(destino, instante, rpmCentesimos, risco, riscos);
+    }
+
+  public:
+    // Define a saída (nullptr descarta os quadros) e envia o quadro de configuração. As diferenças recomeçam do zero.
+    void configurar(SaidaTelemetria saida, uint8_t numRiscos, uint8_t estimador) {
+      _saida = saida;
+      _tamanho = 0; // Amostras ainda não enviadas são descartadas: a configuração mudou.
+      _ultimoInstante = 0;
+      _ultimoIntervalo = 0;
+      _ultimoRpm = 0;
+      _ultimoRisco = 0;
+      _ultimoPasso = 1;
+      _numRiscos = numRiscos == 0 ? 1 : numRiscos;
+      _porJanela = estimador == TELEMETRIA_ESTIMADOR_MT;
+      abrirQuadro(QUADRO_CONFIGURACAO);
+      escreverByte(TELEMETRIA_VERSAO);
+      escreverByte(numRiscos);
+      escreverByte(estimador);
+      fecharQuadro();
+    }
+
+    // Acrescenta uma amostra (instante em micros, RPM em centésimos e risco atual). Quando a amostra não cabe mais, o
+    // quadro é enviado e ela abre o seguinte, codificada de novo com a inclinação do quadro novo.
+    void registrarAmostra(uint32_t instante, int32_t rpmCentesimos, uint8_t risco) {
+      uint8_t amostra[MAX_AMOSTRA];
+      uint8_t riscos;
+      if (_tamanho == 0) {
+        abrirQuadroAmostras();
+      }
+      uint8_t bytes = codificarAmostra(amostra, instante, rpmCentesimos, risco, riscos);
+      if (_tamanho + bytes + RODAPE > Tamanho) {
+        fecharQuadro();
+        abrirQuadroAmostras();
+        bytes = codificarAmostra(amostra, instante, rpmCentesimos, risco, riscos);
+      }
+      for (uint8_t i = 0; i < bytes; i++) {
+        escreverByte(amostra[i]);
+      }
+      uint32_t intervalo = instante - _ultimoInstante;
+      if (_porJanela) {
+        _ultimoIntervalo = intervalo;
+        _ultimoPasso = riscos;
+      } else {
+        _ultimoIntervalo = (riscos == 1) ? intervalo : intervalo / riscos;
+      }
+      _ultimoInstante = instante;
+      _ultimoRpm = rpmCentesimos;
+      _ultimoRisco = risco;
+      _amostrasEnviadas++;
+    }
+
+    // Envia as amostras pendentes e, em seguida, um quadro de evento (a ordem dos quadros segue a dos acontecimentos).
+    void registrarEvento(uint32_t instante, uint8_t eventos) {
+      descarregar();
+      abrirQuadro(QUADRO_EVENTO);
+      _tamanho = (uint8_t)(escreverVarint(_quadro + _tamanho, instante) - _quadro);
+      escreverByte(eventos);
+      fecharQuadro();
+    }
+
+    // Envia o quadro em montagem, se houver (para limitar a latência em velocidades baixas).
+    void descarregar() {
+      if (_tamanho != 0) {
+        fecharQuadro();
+      }
+    }
+
+    // Decodifica no próprio vetor um quadro COBS recebido (sem o 0x00 final) e confere o CRC.
+    // Retorna o tamanho do conteúdo (tipo e campos, sem o CRC), ou 0 se o quadro for inválido.
+    static uint8_t decodificar(uint8_t* quadro, uint8_t tamanho) {
+      return desenquadrarTelemetria(quadro, tamanho);
+    }
+
+    SaidaTelemetria lerSaida() const { return _saida; }
+    unsigned long lerBytesEnviados() const { return _bytesEnviados; }     // Bytes entregues à saída (quadros completos, com o 0x00).
+    unsigned long lerAmostrasEnviadas() const { return _amostrasEnviadas; } // Amostras codificadas (incluindo as do quadro em montagem).
+    unsigned long lerQuadrosEnviados() const { return _quadrosEnviados; }
+    void zerarContadores() {
+      _bytesEnviados = 0;
+      _amostrasEnviadas = 0;
+      _quadrosEnviados = 0;
+    }
+    static uint8_t tamanhoQuadro() { return Tamanho; }
+};
+
+#endif // telemetriaBinaria_h
@@ -21,7 +21,6 @@ const int avancaPin = 6;
 //Intanciar Classes
 sensorOpticoPro sensorOptico(sensorOpticoPin); // Assumindo os pinos de comunicação do Sensor Optico
 gerenciadorComandos gerenciadorDeComandos (ligaDesligaPin, sentidoGiroPin); // Assumindo os pinos de comunicação do Motor
-gerenciadorComando gerenciador; // Tratamento de Comandos
 
 void setup() {  
   //Comunicação Serial com o Sistema
@@ -40,6 +39,8 @@ void setup() {
 }
 
 void loop() {
+  saidaSerial.atender(); // Transmite a fila de saída sem bloquear: respostas dos comandos antes da telemetria.
+
   while (Serial.available() > 0) {
     char c = Serial.read();
 
@@ -59,7 +60,7 @@ void loop() {
       //Serial.print("Enviando Comando: ");
       //Serial.println(comandoRecebido);
 
-      Comando comando = gerenciador.analisarComando(comandoRecebido);
+      Comando comando = gerenciadorDeComandos.analisarComando(comandoRecebido);
 
       //Serial.print("Comando: ");
       //Serial.println(comando.nome);
@@ -80,7 +81,7 @@ void loop() {
               }
           }
       } else {
-          Serial.println("Comando inválido ou vazio.");
+          saidaSerial.println("Comando inválido ou vazio.");
       }
 
       comandoRecebidoIndex = 0; // Reseta o índice *APÓS* processar o comando
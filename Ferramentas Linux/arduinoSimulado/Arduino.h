@@ -0,0 +1,154 @@
+/*
+ * Arduino.h (simulado)
+ *
+ * Descrição: Substituto do Arduino.h para compilar as bibliotecas da placa no
+ * Linux, usado pelas ferramentas desta pasta. Implementa apenas o que as
+ * bibliotecas usam, com pinos, relógio e interrupções simulados:
+ *
+ *   - micros() e millis() leem um relógio que só anda quando a ferramenta o
+ *     define (definirMicrosSimulado): a execução é determinística e tão rápida
+ *     quanto a CPU permitir.
+ *   - digitalRead() lê o nível definido por definirPinoSimulado(); a mudança
+ *     de nível chama a rotina associada por attachInterrupt(), como a
+ *     interrupção externa da placa (pinos 2 e 3, como no Uno).
+ *   - Serial escreve em um arquivo (saída padrão, por exemplo) ou em lugar
+ *     nenhum, e nunca bloqueia.
+ *   - random() usa um gerador próprio, com a mesma semente (randomSeed) dando
+ *     sempre a mesma sequência, como na placa.
+ *
+ * No Linux unsigned long tem 64 bits: o relógio simulado não dá a volta dos
+ * 32 bits do micros() da placa (a volta é tratada e testada na baseTempo.h).
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef Arduino_h // Guarda de inclusão (mesmo nome do Arduino.h original).
+#define Arduino_h
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define NOT_AN_INTERRUPT -1
+#define NOT_A_PIN 0 // Porta de um pino inexistente (digitalPinToPort).
+#define DEC 10
+#define HEX 16
+#define BIN 2
+#define PI 3.1415926535897932384626433832795
+#ifndef F_CPU
+#define F_CPU 16000000UL // Custos em ciclos dos relatórios calculados como no Uno.
+#endif
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// Texto em memória de programa: no Linux fica na RAM, mas o tipo separado mantém as sobrecargas de print() da placa.
+class __FlashStringHelper;
+#define F(texto) (reinterpret_cast<const __FlashStringHelper*>(texto))
+
+// Tempo e pinos
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long milissegundos);           // Avança o relógio simulado.
+void delayMicroseconds(unsigned int microssegundos);
+void pinMode(uint8_t pino, uint8_t modo);
+int digitalRead(uint8_t pino);
+void digitalWrite(uint8_t pino, uint8_t nivel);
+int digitalPinToInterrupt(uint8_t pino);
+void attachInterrupt(uint8_t interrupcao, void (*rotina)(void), int modo);
+void detachInterrupt(uint8_t interrupcao);
+void noInterrupts();
+void interrupts();
+
+// Números pseudoaleatórios
+long random(long maximo);               // De 0 a maximo - 1.
+long random(long minimo, long maximo);  // De minimo a maximo - 1.
+void randomSeed(unsigned long semente);
+
+// Portas (mapeamento do Uno: 0 a 7 na porta D, 8 a 13 na porta B, 14 a 19 na porta C; NOT_A_PIN nos demais).
+uint8_t digitalPinToPort(uint8_t pino);
+uint8_t digitalPinToBitMask(uint8_t pino);
+volatile uint8_t* portInputRegister(uint8_t porta);
+
+// Controle da simulação (somente no Linux).
+void definirMicrosSimulado(unsigned long instante);
+void definirPinoSimulado(uint8_t pino, uint8_t nivel); // Muda o nível e, se houver, chama a rotina de interrupção do pino.
+
+class String : public std::string {
+  public:
+    String() {}
+    String(const char* texto) : std::string(texto) {}
+    String(const std::string& texto) : std::string(texto) {}
+    long toInt() const { return atol(c_str()); }
+    float toFloat() const { return (float)atof(c_str()); }
+    bool equals(const char* texto) const { return compare(texto) == 0; }
+    int indexOf(char caractere) const { size_t posicao = find(caractere); return posicao == npos ? -1 : (int)posicao; }
+    String substring(size_t inicio) const { return inicio < size() ? String(substr(inicio)) : String(); }
+    String substring(size_t inicio, size_t fim) const { return inicio < fim && inicio < size() ? String(substr(inicio, fim - inicio)) : String(); }
+    void trim() {
+      erase(find_last_not_of(" \t\r\n") + 1); // npos + 1 = 0: só espaços, apaga tudo.
+      erase(0, find_first_not_of(" \t\r\n"));
+    }
+};
+
+class Print {
+  private:
+    size_t imprimirNumero(unsigned long long valor, int base, bool negativo);
+
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t valor) = 0;
+    virtual size_t write(const uint8_t* dados, size_t tamanho);
+    size_t write(const char* texto) { return write((const uint8_t*)texto, strlen(texto)); }
+
+    size_t print(const __FlashStringHelper* texto) { return write((const char*)texto); }
+    size_t print(const char* texto) { return write(texto); }
+    size_t print(const String& texto) { return write((const uint8_t*)texto.data(), texto.size()); }
+    size_t print(char valor) { return write((uint8_t)valor); }
+    size_t print(unsigned char valor, int base = DEC) { return imprimirNumero(valor, base, false); }
+    size_t print(int valor, int base = DEC) { return print((long long)valor, base); }
+    size_t print(unsigned int valor, int base = DEC) { return imprimirNumero(valor, base, false); }
+    size_t print(long valor, int base = DEC) { return print((long long)valor, base); }
+    size_t print(unsigned long valor, int base = DEC) { return imprimirNumero(valor, base, false); }
+    size_t print(long long valor, int base = DEC);
+    size_t print(unsigned long long valor, int base = DEC) { return imprimirNumero(valor, base, false); }
+    size_t print(double valor, int digitos = 2);
+
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(const T& valor) { size_t n = print(valor); return n + println(); }
+    template <typename T> size_t println(const T& valor, int formato) { size_t n = print(valor, formato); return n + println(); }
+};
+
+// Serial simulada: escreve no arquivo configurado (nenhum por padrão) e sempre tem espaço livre.
+class HardwareSerial : public Print {
+  private:
+    FILE* _destino = nullptr;
+
+  public:
+    using Print::write;
+    size_t write(uint8_t valor);
+    size_t write(const uint8_t* dados, size_t tamanho);
+    void begin(unsigned long) {}
+    int available() { return 0; }
+    int read() { return -1; }
+    int availableForWrite() { return 63; } // Buffer de transmissão do Uno.
+    void configurarDestino(FILE* destino) { _destino = destino; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // Arduino_h
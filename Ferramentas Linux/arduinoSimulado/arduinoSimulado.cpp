@@ -0,0 +1,185 @@
+/*
+ * arduinoSimulado.cpp
+ *
+ * Descrição: Implementação do Arduino.h simulado: relógio, pinos, interrupções
+ * externas e Serial das ferramentas de Linux.
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#include "Arduino.h"
+
+#define PINOS_SIMULADOS 20
+#define INTERRUPCOES_SIMULADAS 2
+
+static unsigned long relogio = 0;
+static uint8_t niveis[PINOS_SIMULADOS];
+static volatile uint8_t registradoresEntrada[5]; // Índice da porta: 2 = B, 3 = C, 4 = D (como no Uno).
+static void (*rotinas[INTERRUPCOES_SIMULADAS])(void);
+static int modos[INTERRUPCOES_SIMULADAS];
+static unsigned long sementeAleatoria = 1;
+
+HardwareSerial Serial;
+
+unsigned long micros() {
+  return relogio;
+}
+
+unsigned long millis() {
+  return relogio / 1000UL;
+}
+
+void delay(unsigned long milissegundos) {
+  relogio += milissegundos * 1000UL;
+}
+
+void delayMicroseconds(unsigned int microssegundos) {
+  relogio += microssegundos;
+}
+
+void definirMicrosSimulado(unsigned long instante) {
+  relogio = instante;
+}
+
+void pinMode(uint8_t, uint8_t) {
+}
+
+int digitalRead(uint8_t pino) {
+  return pino < PINOS_SIMULADOS ? niveis[pino] : LOW;
+}
+
+void digitalWrite(uint8_t pino, uint8_t nivel) {
+  definirPinoSimulado(pino, nivel);
+}
+
+uint8_t digitalPinToPort(uint8_t pino) {
+  return pino < 8 ? 4 : (pino < 14 ? 2 : (pino < PINOS_SIMULADOS ? 3 : NOT_A_PIN));
+}
+
+uint8_t digitalPinToBitMask(uint8_t pino) {
+  return (uint8_t)(1 << (pino < 8 ? pino : (pino < 14 ? pino - 8 : pino - 14)));
+}
+
+volatile uint8_t* portInputRegister(uint8_t porta) {
+  return &registradoresEntrada[porta];
+}
+
+// Gerador congruente linear de 32 bits (Numerical Recipes): a sequência depende só da semente.
+long random(long maximo) {
+  if (maximo <= 0) {
+    return 0;
+  }
+  sementeAleatoria = (sementeAleatoria * 1664525UL + 1013904223UL) & 0xFFFFFFFFUL;
+  return (long)((sementeAleatoria >> 1) % (unsigned long)maximo);
+}
+
+long random(long minimo, long maximo) {
+  return minimo >= maximo ? minimo : minimo + random(maximo - minimo);
+}
+
+void randomSeed(unsigned long semente) {
+  if (semente != 0) { // Como na placa: semente zero não altera a sequência.
+    sementeAleatoria = semente;
+  }
+}
+
+int digitalPinToInterrupt(uint8_t pino) {
+  return pino == 2 ? 0 : (pino == 3 ? 1 : NOT_AN_INTERRUPT);
+}
+
+void attachInterrupt(uint8_t interrupcao, void (*rotina)(void), int modo) {
+  if (interrupcao < INTERRUPCOES_SIMULADAS) {
+    rotinas[interrupcao] = rotina;
+    modos[interrupcao] = modo;
+  }
+}
+
+void detachInterrupt(uint8_t interrupcao) {
+  if (interrupcao < INTERRUPCOES_SIMULADAS) {
+    rotinas[interrupcao] = nullptr;
+  }
+}
+
+void noInterrupts() {
+}
+
+void interrupts() {
+}
+
+void definirPinoSimulado(uint8_t pino, uint8_t nivel) {
+  if (pino >= PINOS_SIMULADOS) {
+    return;
+  }
+  nivel = nivel ? HIGH : LOW;
+  uint8_t anterior = niveis[pino];
+  niveis[pino] = nivel;
+  uint8_t mascara = digitalPinToBitMask(pino);
+  volatile uint8_t& registrador = registradoresEntrada[digitalPinToPort(pino)];
+  registrador = nivel ? (registrador | mascara) : (registrador & ~mascara);
+
+  int interrupcao = digitalPinToInterrupt(pino);
+  if (interrupcao == NOT_AN_INTERRUPT || rotinas[interrupcao] == nullptr || nivel == anterior) {
+    return;
+  }
+  int modo = modos[interrupcao];
+  if (modo == CHANGE || (modo == RISING && nivel == HIGH) || (modo == FALLING && nivel == LOW)) {
+    rotinas[interrupcao]();
+  }
+}
+
+size_t Print::write(const uint8_t* dados, size_t tamanho) {
+  for (size_t i = 0; i < tamanho; i++) {
+    write(dados[i]);
+  }
+  return tamanho;
+}
+
+size_t Print::imprimirNumero(unsigned long long valor, int base, bool negativo) {
+  char texto[68];
+  char* posicao = &texto[sizeof(texto) - 1];
+  *posicao = '\0';
+  if (base < 2) {
+    base = DEC;
+  }
+  do {
+    int digito = (int)(valor % base);
+    *--posicao = (char)(digito < 10 ? '0' + digito : 'A' + digito - 10);
+    valor /= base;
+  } while (valor != 0);
+  if (negativo) {
+    *--posicao = '-';
+  }
+  return write(posicao);
+}
+
+size_t Print::print(long long valor, int base) {
+  if (base == DEC && valor < 0) {
+    return imprimirNumero(0ULL - (unsigned long long)valor, DEC, true);
+  }
+  return imprimirNumero((unsigned long long)valor, base, false);
+}
+
+size_t Print::print(double valor, int digitos) {
+  char texto[64];
+  if (isnan(valor)) return write("nan");
+  if (isinf(valor)) return write("inf");
+  if (valor > 4294967040.0 || valor < -4294967040.0) return write("ovf"); // Mesmos limites do print() da placa.
+  snprintf(texto, sizeof(texto), "%.*f", digitos, valor);
+  return write(texto);
+}
+
+size_t HardwareSerial::write(uint8_t valor) {
+  if (_destino != nullptr) {
+    fputc(valor, _destino);
+  }
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* dados, size_t tamanho) {
+  if (_destino != nullptr) {
+    fwrite(dados, 1, tamanho, _destino);
+  }
+  return tamanho;
+}
@@ -0,0 +1,136 @@
+/*
+ * arquivoBordas.h
+ *
+ * Descrição: Formato dos arquivos de bordas usados pelas ferramentas desta
+ * pasta (decodificador da captura, gerador de sinais e reprodutor) e leitura
+ * por mapeamento em memória (mmap): o arquivo é percorrido direto da cache de
+ * páginas do sistema, sem cópias, e traços com milhões de bordas são lidos
+ * na velocidade da memória.
+ *
+ * Formato (little-endian):
+ *   cabeçalho (16 bytes): assinatura "SOPB", versão (uint16), número de
+ *                         riscos do disco (uint16, 0 se desconhecido),
+ *                         indicadores (uint32), reservado (uint32)
+ *   registros (16 bytes cada, até o fim do arquivo):
+ *     instanteNivel  uint64  (instante em micros << 1) | nível após a borda
+ *     rpmVerdadeiro  float   RPM real do disco no instante (NaN: desconhecido)
+ *     marcas         uint32  bits 0-15: risco real (0xFFFF: desconhecido);
+ *                            bit 16: borda espúria (glitch); bit 17: a borda
+ *                            seguinte do sinal real foi perdida
+ *
+ * Traços gravados na placa (decodificadorCaptura -b) não têm a verdade: RPM
+ * NaN e risco desconhecido. Traços sintéticos (geradorSinais -o) têm os dois.
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef arquivoBordas_h // Guarda de inclusão.
+#define arquivoBordas_h
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define ARQUIVO_BORDAS_VERSAO 1
+#define ARQUIVO_BORDAS_TEM_VERDADE 0x01 // Indicador: os registros trazem o RPM e o risco reais.
+
+#define MARCA_RISCO_DESCONHECIDO 0xFFFFu
+#define MARCA_BORDA_ESPURIA (1u << 16)
+#define MARCA_PERDA_SEGUINTE (1u << 17)
+
+struct CabecalhoArquivoBordas {
+  char assinatura[4];
+  uint16_t versao;
+  uint16_t numRiscos;
+  uint32_t indicadores;
+  uint32_t reservado;
+};
+
+struct RegistroArquivoBordas {
+  uint64_t instanteNivel;
+  float rpmVerdadeiro;
+  uint32_t marcas;
+
+  uint64_t instante() const { return instanteNivel >> 1; }
+  uint8_t nivel() const { return (uint8_t)(instanteNivel & 1); }
+  bool temVerdade() const { return !isnan(rpmVerdadeiro); }
+};
+
+static_assert(sizeof(CabecalhoArquivoBordas) == 16 && sizeof(RegistroArquivoBordas) == 16, "Formato do arquivo de bordas alterado.");
+
+inline void escreverCabecalhoBordas(FILE* arquivo, uint16_t numRiscos, uint32_t indicadores) {
+  CabecalhoArquivoBordas cabecalho;
+  memcpy(cabecalho.assinatura, "SOPB", 4);
+  cabecalho.versao = ARQUIVO_BORDAS_VERSAO;
+  cabecalho.numRiscos = numRiscos;
+  cabecalho.indicadores = indicadores;
+  cabecalho.reservado = 0;
+  fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo);
+}
+
+inline RegistroArquivoBordas registroBordas(uint64_t instante, uint8_t nivel, float rpmVerdadeiro, uint32_t marcas) {
+  RegistroArquivoBordas registro;
+  registro.instanteNivel = (instante << 1) | (nivel ? 1 : 0);
+  registro.rpmVerdadeiro = rpmVerdadeiro;
+  registro.marcas = marcas;
+  return registro;
+}
+
+// Arquivo de bordas mapeado em memória, somente leitura.
+class arquivoBordasMapeado
+{
+  private:
+    void* _mapa = MAP_FAILED;
+    size_t _tamanho = 0;
+
+  public:
+    const CabecalhoArquivoBordas* cabecalho = nullptr;
+    const RegistroArquivoBordas* registros = nullptr;
+    size_t numRegistros = 0;
+
+    // Mapeia o arquivo e confere o cabeçalho. Retorna false (com a mensagem em 'erro') se não for um arquivo de bordas.
+    bool abrir(const char* caminho, const char*& erro) {
+      int descritor = open(caminho, O_RDONLY);
+      if (descritor < 0) {
+        erro = "não foi possível abrir o arquivo";
+        return false;
+      }
+      struct stat estado;
+      if (fstat(descritor, &estado) != 0 || (size_t)estado.st_size < sizeof(CabecalhoArquivoBordas)) {
+        close(descritor);
+        erro = "arquivo menor que o cabeçalho";
+        return false;
+      }
+      _tamanho = (size_t)estado.st_size;
+      _mapa = mmap(nullptr, _tamanho, PROT_READ, MAP_PRIVATE, descritor, 0);
+      close(descritor); // O mapeamento continua válido sem o descritor.
+      if (_mapa == MAP_FAILED) {
+        erro = "falha no mmap";
+        return false;
+      }
+      madvise(_mapa, _tamanho, MADV_SEQUENTIAL); // Leitura antecipada agressiva: o arquivo é percorrido uma vez, em ordem.
+      cabecalho = (const CabecalhoArquivoBordas*)_mapa;
+      if (memcmp(cabecalho->assinatura, "SOPB", 4) != 0 || cabecalho->versao != ARQUIVO_BORDAS_VERSAO) {
+        erro = "assinatura ou versão do arquivo de bordas inválida";
+        return false;
+      }
+      registros = (const RegistroArquivoBordas*)(cabecalho + 1);
+      numRegistros = (_tamanho - sizeof(CabecalhoArquivoBordas)) / sizeof(RegistroArquivoBordas);
+      return true;
+    }
+
+    ~arquivoBordasMapeado() {
+      if (_mapa != MAP_FAILED) {
+        munmap(_mapa, _tamanho);
+      }
+    }
+};
+
+#endif // arquivoBordas_h
@@ -0,0 +1,1438 @@
+/*
+ * bancadasSensor.cpp
+ *
+ * Descrição: Bancadas de medição da biblioteca sensorOpticoPro no Linux, com
+ * discos simulados pelo relógio e pelos pinos do Arduino simulado. Ficam fora
+ * da placa porque cada bancada cria as suas próprias instâncias (sensor,
+ * grupo de sensores, filas), que não cabem na pilha do Uno (2 KB de SRAM) ao
+ * lado do sensor em uso.
+ *
+ * Os custos são medidos com o relógio do Linux, em nanossegundos na máquina
+ * que executa: servem para comparar alternativas entre si (por pino x por
+ * porta, 1 x 8 sensores). O custo em ciclos do AVR só é medido na placa.
+ *
+ * As bancadas de reprodução geram as bordas com o modelo do disco
+ * (geradorSinais.h) e as reproduzem nos quatro estimadores
+ * (reprodutorBordas.h), no próprio processo, comparando com a verdade.
+ *
+ * Cada bancada confere os seus resultados e termina com código de saída 1
+ * se alguma conferência falhar, para ser usada como teste.
+ *
+ * Compilação (nesta pasta):
+ *   g++ -O2 -std=gnu++11 -IarduinoSimulado \
+ *       -I"../Bibliotecas Arduino/sensorOpticoPro" -o bancadasSensor bancadasSensor.cpp \
+ *       arduinoSimulado/arduinoSimulado.cpp "../Bibliotecas Arduino/sensorOpticoPro/sensorOpticoPro.cpp" \
+ *       "../Bibliotecas Arduino/sensorOpticoPro/saidaAssincrona.cpp"
+ *
+ * Utilização:
+ *   bancadasSensor                        lista as bancadas
+ *   bancadasSensor bancada [parâmetros]   executa uma bancada
+ *   bancadasSensor todas                  executa todas com os parâmetros padrão
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Arduino.h"
+#include "sensorOpticoPro.h"
+#include "grupoSensorOpticoPro.h"
+#include "geradorSinais.h"     // Bordas do modelo do disco, geradas no próprio processo.
+#include "reprodutorBordas.h"  // Reprodução das bordas geradas, com a verdade, nos quatro estimadores.
+
+static unsigned falhas = 0; // Conferências que falharam na execução.
+
+static void conferir(bool condicao, const char* descricao) {
+  if (!condicao) {
+    printf("  Falha: %s\n", descricao);
+    falhas++;
+  }
+}
+
+// Relógio do Linux em nanossegundos (o micros() simulado só anda quando a bancada o define).
+static double lerNanossegundos() {
+  timespec agora;
+  clock_gettime(CLOCK_MONOTONIC, &agora);
+  return agora.tv_sec * 1e9 + agora.tv_nsec;
+}
+
+// Parâmetro numérico opcional da bancada.
+static double lerParametro(int argc, char** argv, int indice, double padrao) {
+  return indice < argc ? atof(argv[indice]) : padrao;
+}
+
+// Discos simulados nos pinos de um grupo: o canal i gira a 600 + 150 * i RPM, com ciclo de trabalho de 50%.
+struct DiscosSimulados {
+  uint8_t pinos[8];
+  uint8_t canais = 0;
+  double meioPeriodo[8];  // Micros entre bordas de cada canal.
+  double proximaBorda[8];
+
+  void iniciar(const uint8_t* pinosGrupo, uint8_t numCanais, uint8_t numRiscos) {
+    canais = numCanais;
+    for (uint8_t i = 0; i < canais; i++) {
+      pinos[i] = pinosGrupo[i];
+      meioPeriodo[i] = 30000000.0 / (rpm(i) * numRiscos);
+      proximaBorda[i] = meioPeriodo[i] * (1.0 + 0.1 * i); // Fases diferentes: as bordas dos canais não coincidem.
+      definirPinoSimulado(pinos[i], LOW);
+    }
+  }
+
+  static double rpm(uint8_t canal) { return 600.0 + 150.0 * canal; }
+
+  // Troca o nível dos canais com borda até 'agora'.
+  void avancar(unsigned long agora) {
+    for (uint8_t i = 0; i < canais; i++) {
+      while (proximaBorda[i] <= agora) {
+        definirPinoSimulado(pinos[i], !digitalRead(pinos[i]));
+        proximaBorda[i] += meioPeriodo[i];
+      }
+    }
+  }
+};
+
+// Sensores dos canais de um grupo, nos pinos 0 a N - 1 (no heap, como no reprodutor), sem telemetria.
+template <uint8_t N>
+struct SensoresGrupo {
+  sensorOpticoPro* sensores[N];
+
+  SensoresGrupo() {
+    for (uint8_t i = 0; i < N; i++) {
+      sensores[i] = new sensorOpticoPro(i);
+      sensores[i]->configurarTelemetria(TELEMETRIA_DESLIGADA);
+    }
+  }
+  ~SensoresGrupo() {
+    for (uint8_t i = 0; i < N; i++) {
+      delete sensores[i];
+    }
+  }
+};
+
+// Um grupo de N canais nos pinos 0 a N - 1, varrido a cada 'passo' micros durante 'passagens' passagens.
+// O custo é o tempo do laço com atualizar() menos o do mesmo laço sem ele (só os discos simulados).
+template <typename Grupo, uint8_t N>
+static double medirCustoPassagens(Grupo& grupo, uint32_t passagens, unsigned long passo) {
+  uint8_t pinos[N];
+  for (uint8_t i = 0; i < N; i++) {
+    pinos[i] = i;
+  }
+  double duracao[2];
+  for (uint8_t comGrupo = 0; comGrupo < 2; comGrupo++) {
+    DiscosSimulados discos;
+    discos.iniciar(pinos, N, 36);
+    definirMicrosSimulado(0);
+    grupo.iniciar(36);
+    double inicio = lerNanossegundos();
+    for (uint32_t i = 1; i <= passagens; i++) {
+      definirMicrosSimulado(i * passo);
+      discos.avancar(i * passo);
+      if (comGrupo) {
+        grupo.atualizar();
+      }
+    }
+    duracao[comGrupo] = lerNanossegundos() - inicio;
+  }
+  double liquido = duracao[1] - duracao[0];
+  return liquido > 0 ? liquido / ((double)passagens * N) : 0.0;
+}
+
+// Confere o RPM de cada canal do grupo contra o disco simulado (quantização de um passo de varredura por período).
+template <typename Grupo>
+static void conferirRpmGrupo(const Grupo& grupo, uint8_t canais, unsigned long passo) {
+  for (uint8_t i = 0; i < canais; i++) {
+    double esperado = DiscosSimulados::rpm(i);
+    double tolerancia = esperado * passo * esperado * 36.0 / 60000000.0 + 0.01; // Um passo em um período.
+    conferir(fabs(grupo.lerRpmAtual(i) - esperado) <= tolerancia, "RPM de um canal do grupo diferente do disco simulado");
+  }
+}
+
+template <uint8_t N>
+static void medirCustoGrupo(uint32_t passagens, unsigned long passo) {
+  SensoresGrupo<N> canais;
+  grupoSensorOpticoPro<N> grupo(canais.sensores);
+  double custo = medirCustoPassagens<grupoSensorOpticoPro<N>, N>(grupo, passagens, passo);
+  printf("  Sensores: %u, custo por sensor: %.1f ns\n", N, custo);
+  conferirRpmGrupo(grupo, N, passo);
+}
+
+static void bancadaCustoGrupo(int argc, char** argv) {
+  uint32_t passagens = (uint32_t)lerParametro(argc, argv, 0, 200000);
+  const unsigned long passo = 10; // Micros entre passagens (loop() rápido: a quantização do período fica em 0,6% a 1000 RPM).
+  medirCustoGrupo<1>(passagens, passo);
+  medirCustoGrupo<2>(passagens, passo);
+  medirCustoGrupo<4>(passagens, passo);
+  medirCustoGrupo<8>(passagens, passo);
+}
+
+// A amostragem por porta entrega as bordas de subida e de descida de cada canal, com o instante comum da porta, ao sensor
+// do canal: o RPM de cada canal deve ser, a cada passagem, o mesmo de um sensor isolado que varre o seu pino no calcularRPM().
+static void conferirCaminhoIsolado(uint32_t passagens, unsigned long passo) {
+  SensoresGrupo<8> canais, isolados;
+  portaSensorOpticoPro<8> porPorta(canais.sensores);
+  DiscosSimulados discos;
+  const uint8_t pinos[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+  discos.iniciar(pinos, 8, 36);
+  definirMicrosSimulado(0);
+  porPorta.iniciar(36);
+  for (uint8_t i = 0; i < 8; i++) {
+    isolados.sensores[i]->iniciar();
+  }
+  uint32_t divergencias = 0;
+  for (uint32_t i = 1; i <= passagens; i++) {
+    definirMicrosSimulado(i * passo);
+    discos.avancar(i * passo);
+    porPorta.atualizar();
+    for (uint8_t c = 0; c < 8; c++) {
+      if (isolados.sensores[c]->calcularRPM() != porPorta.lerRpmAtual(c)) {
+        divergencias++;
+      }
+    }
+  }
+  printf("  Por porta x sensor isolado: %u divergências de RPM em %u leituras (canal 7: %.3f x %.3f)\n", divergencias,
+         passagens * 8, porPorta.lerRpmAtual(7), isolados.sensores[7]->lerRpmAtual());
+  conferir(divergencias == 0, "RPM por porta diferente do sensor isolado no mesmo pino");
+  conferir(porPorta.lerRpmAtual(7) > 0, "nenhuma medição por porta");
+}
+
+static void bancadaCustoPorta(int argc, char** argv) {
+  uint32_t passagens = (uint32_t)lerParametro(argc, argv, 0, 200000);
+  const unsigned long passo = 10;
+  SensoresGrupo<8> canaisPino, canaisPorta; // Pinos 0 a 7: porta D do Uno.
+  grupoSensorOpticoPro<8> porPino(canaisPino.sensores);
+  portaSensorOpticoPro<8> porPorta(canaisPorta.sensores);
+  double custoPino = medirCustoPassagens<grupoSensorOpticoPro<8>, 8>(porPino, passagens, passo);
+  double custoPorta = medirCustoPassagens<portaSensorOpticoPro<8>, 8>(porPorta, passagens, passo);
+  printf("  Custo por canal - por pino: %.1f ns, por porta: %.1f ns%s\n", custoPino, custoPorta,
+         porPorta.portaValida() ? "" : " (porta indisponível, usando digitalRead)");
+  conferir(porPorta.portaValida(), "os pinos 0 a 7 deveriam estar na mesma porta");
+  conferirRpmGrupo(porPino, 8, passo);
+  conferirRpmGrupo(porPorta, 8, passo);
+  for (uint8_t i = 0; i < 8; i++) {
+    conferir(porPino.lerRpmAtual(i) == porPorta.lerRpmAtual(i), "por pino e por porta mediram RPMs diferentes");
+  }
+  conferirCaminhoIsolado(passagens, passo);
+}
+
+// Custo por borda do cálculo de RPM e ângulo em cada estimador, com bordas sintéticas de um disco de 36 riscos a 1000 RPM.
+static void bancadaCustoBorda(int argc, char** argv) {
+  uint32_t pulsos = (uint32_t)lerParametro(argc, argv, 0, 500000);
+  const unsigned long periodo = 1667; // Micros: 36 riscos a 1000 RPM.
+  const double esperado = 60000000.0 / (36.0 * periodo); // 999,80 RPM.
+
+  sensorOpticoPro sensor(2);
+  sensor.configurarParametrosSensorOptico(36, 1000);
+  for (uint8_t estimador = ESTIMADOR_PERIODO; estimador <= ESTIMADOR_VOLTA; estimador++) {
+    sensor.novoEstimadorRPM(static_cast<EstimadorRPM>(estimador));
+    unsigned long instante = 0;
+    double inicio = lerNanossegundos();
+    for (uint32_t i = 0; i < pulsos; i++) {
+      instante += periodo;
+      sensor.processarBorda(instante, HIGH);
+      sensor.processarBorda(instante + periodo / 2, LOW);
+    }
+    double custo = (lerNanossegundos() - inicio) / (2.0 * pulsos);
+
+    float rpm = sensor.lerRpmAtual();
+    printf("  %s - custo por borda: %.1f ns, RPM: %.3f, milésimos de RPM: %u, mrad/s: %u\n",
+           estimador == ESTIMADOR_VOLTA ? "Volta" : estimador == ESTIMADOR_MT ? "M/T" : "Período",
+           custo, rpm, sensor.lerRpmMili(), sensor.lerVelocidadeAngularMiliRad());
+    conferir(fabs(rpm - esperado) < 0.01, "RPM diferente de 60e6 / (36 * 1667)");
+    conferir(fabs(sensor.lerRpmMili() - esperado * 1000.0) <= 1.0, "lerRpmMili() diferente do RPM");
+    conferir(fabs(sensor.lerVelocidadeAngularMiliRad() - esperado * 2.0 * PI / 60.0 * 1000.0) <= 1.0,
+             "lerVelocidadeAngularMiliRad() diferente da velocidade");
+  }
+}
+
+// Arena dos modos opcionais: a janela de uma volta só ocupa a arena com o estimador de uma volta, no tamanho do disco,
+// é devolvida ao trocar de estimador ou ao destruir o sensor, e um disco sem espaço volta ao M/T sem invadir a arena.
+// O maior disco da compilação (SENSOR_OPTICO_MAX_RISCOS_VOLTA) cabe na arena vazia; um disco maior usa o M/T.
+static void bancadaArena(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  arenaMemoria& arena = sensorOpticoPro::lerArena();
+  const uint16_t porRisco = sizeof(unsigned long);
+  const uint8_t riscosQueCabem = SENSOR_OPTICO_MAX_RISCOS_VOLTA;
+  conferir(arena.emUso() == 0, "arena ocupada antes de qualquer sensor");
+  {
+    sensorOpticoPro primeiro(2), segundo(3);
+    primeiro.configurarParametrosSensorOptico(36, 1000);
+    segundo.configurarParametrosSensorOptico(18, 1000);
+    conferir(arena.emUso() == 0, "janela de uma volta reservada sem o estimador de uma volta");
+
+    primeiro.novoEstimadorRPM(ESTIMADOR_VOLTA);
+    segundo.novoEstimadorRPM(ESTIMADOR_VOLTA);
+    printf("  Arena: %u bytes, dois sensores no estimador de uma volta (36 e 18 riscos): %u em uso\n",
+           arena.capacidade(), arena.emUso());
+    conferir(arena.emUso() == (36 + 18) * porRisco, "arena diferente da soma das janelas (4 bytes por risco no Uno)");
+    conferir(primeiro.lerEstimadorRPM() == ESTIMADOR_VOLTA && segundo.lerEstimadorRPM() == ESTIMADOR_VOLTA,
+             "estimador de uma volta recusado com espaço na arena");
+
+    // O segundo disco cresce além do espaço livre: volta ao M/T e a janela anterior é devolvida.
+    segundo.novoNumRiscos(riscosQueCabem);
+    conferir(segundo.lerEstimadorRPM() == ESTIMADOR_MT, "disco sem espaço na arena não voltou ao M/T");
+    conferir(arena.emUso() == 36 * porRisco, "janela do disco recusado continua na arena");
+
+    // Sem o primeiro, o mesmo disco cabe.
+    primeiro.novoEstimadorRPM(ESTIMADOR_MT);
+    conferir(arena.emUso() == 0, "janela não devolvida ao trocar de estimador");
+    segundo.novoEstimadorRPM(ESTIMADOR_VOLTA);
+    conferir(segundo.lerEstimadorRPM() == ESTIMADOR_VOLTA, "arena livre não aceitou o maior disco que cabe");
+
+    // A janela reservada mede: 1000 RPM com o disco de 'riscosQueCabem' riscos.
+    unsigned long periodo = 60000000UL / (1000UL * riscosQueCabem);
+    for (unsigned long i = 1; i <= 3UL * riscosQueCabem; i++) {
+      segundo.processarBorda(i * periodo, HIGH);
+      segundo.processarBorda(i * periodo + periodo / 2, LOW);
+    }
+    double esperado = 60000000.0 / ((double)riscosQueCabem * periodo);
+    printf("  Maior disco (SENSOR_OPTICO_MAX_RISCOS_VOLTA): %u riscos, RPM %.3f (esperado %.3f)\n", riscosQueCabem,
+           segundo.lerRpmAtual(), esperado);
+    conferir(fabs(segundo.lerRpmAtual() - esperado) < 0.01, "RPM da janela reservada na arena");
+
+    // Acima do limite da compilação, o M/T, mesmo com espaço livre.
+    if (SENSOR_OPTICO_MAX_RISCOS_VOLTA < 255) {
+      primeiro.novoNumRiscos(riscosQueCabem + 1);
+      primeiro.novoEstimadorRPM(ESTIMADOR_VOLTA);
+      conferir(primeiro.lerEstimadorRPM() == ESTIMADOR_MT, "disco acima de SENSOR_OPTICO_MAX_RISCOS_VOLTA aceito");
+      conferir(arena.emUso() == riscosQueCabem * porRisco, "janela do disco acima do limite reservada na arena");
+    }
+  }
+  conferir(arena.emUso() == 0, "sensores destruídos sem devolver a arena");
+}
+
+// Filtro de nível: calibra o limiar com um disco limpo (36 riscos a 1000 RPM) e injeta glitches de 5 µs em várias posições
+// dos níveis alto e baixo, inclusive logo depois e logo antes das bordas reais. Nenhuma borda real pode ser perdida ou deslocada.
+static void bancadaLimiar(int argc, char** argv) {
+  const unsigned long periodo = 1667, meio = periodo / 2, largura = 5;
+  const double esperado = 60000000.0 / (36.0 * periodo);
+  sensorOpticoPro sensor(2);
+  sensor.configurarParametrosSensorOptico(36, 1000);
+  sensor.recalibrarLimiar();
+  unsigned long instante = 0;
+  uint32_t pulsos = 0;
+  for (; pulsos < 2000 && !sensor.limiarCalibrado(); pulsos++) {
+    instante += periodo;
+    sensor.processarBorda(instante, HIGH);
+    sensor.processarBorda(instante + meio, LOW);
+  }
+  printf("  Limiar calibrado em %u pulsos: %lu micros (filtro de nível: %lu micros)\n",
+         pulsos, sensor.lerLimiarPulsacoes(), sensor.lerLimiarNivel());
+  conferir(sensor.limiarCalibrado() && sensor.lerLimiarNivel() > largura, "limiar não calibrado com o disco limpo");
+
+  // Posição do glitch em frações do nível (nível baixo: pulso alto espúrio; nível alto: falha curta).
+  const double posicoes[] = {0.01, 0.1, 0.5, 0.6, 0.9, 0.99};
+  const uint8_t numPosicoes = sizeof(posicoes) / sizeof(posicoes[0]);
+  unsigned long voltas = sensor.lerVoltas();
+  uint8_t risco = sensor.lerIndiceRisco();
+  unsigned long curtos = sensor.lerNiveisCurtos();
+  uint32_t glitches = 0;
+  bool exato = true;
+  for (uint32_t i = 0; i < 36 * 20; i++) {
+    instante += periodo;
+    double posicao = posicoes[i % numPosicoes];
+    unsigned long glitch = (unsigned long)(posicao * (meio - largura));
+    sensor.processarBorda(instante, HIGH);
+    if (i % 2 == 0) { // Falha no nível alto.
+      sensor.processarBorda(instante + glitch, LOW);
+      sensor.processarBorda(instante + glitch + largura, HIGH);
+    }
+    sensor.processarBorda(instante + meio, LOW);
+    if (i % 2 == 1) { // Pulso espúrio no nível baixo.
+      sensor.processarBorda(instante + meio + glitch, HIGH);
+      sensor.processarBorda(instante + meio + glitch + largura, LOW);
+    }
+    glitches++;
+    exato = exato && (i < 2 || fabs(sensor.lerRpmAtual() - esperado) < 0.01);
+  }
+  sensor.processarBorda(instante + periodo, HIGH); // Confirma a última borda de descida.
+  printf("  Glitches: %u, níveis curtos descartados: %lu, RPM: %.3f (esperado %.3f)\n",
+         glitches, sensor.lerNiveisCurtos() - curtos, sensor.lerRpmAtual(), esperado);
+  conferir(exato, "um glitch alterou o RPM medido");
+  conferir(sensor.lerNiveisCurtos() - curtos == glitches, "glitches e níveis curtos descartados diferentes");
+  conferir((sensor.lerVoltas() - voltas) * 36 + sensor.lerIndiceRisco() - risco == 36 * 20, "riscos contados diferentes dos pulsos reais");
+}
+
+// Pulsos extras com o filtro de nível inativo: um pulso estreito espúrio a cada três períodos, com a subida entre 55% e
+// 95% do período, passa pelo filtro de glitches (50%). A borda espúria é unida ao fragmento seguinte ou rejeitada: o RPM
+// continua exato em cada borda real, os riscos contados são os reais e cada pulso espúrio conta uma borda rejeitada.
+static void bancadaExtras(int argc, char** argv) {
+  const unsigned long periodo = 2778, meio = periodo / 2, largura = 30;
+  const double posicoes[] = {0.55, 0.65, 0.75, 0.85, 0.94};
+  const uint8_t numPosicoes = sizeof(posicoes) / sizeof(posicoes[0]);
+  const EstimadorRPM estimadores[] = {ESTIMADOR_PERIODO, ESTIMADOR_MT};
+  const char* const nomes[] = {"período", "M/T"};
+  const double esperado = 60000000.0 / (36.0 * periodo);
+  for (uint8_t e = 0; e < 2; e++) {
+    sensorOpticoPro sensor(2);
+    sensor.configurarParametrosSensorOptico(36, 1000);
+    sensor.novoEstimadorRPM(estimadores[e]);
+    unsigned long instante = 0;
+    for (uint8_t i = 0; i < 3 * 36; i++) { // Aquecimento: mediana, janela M/T.
+      instante += periodo;
+      sensor.processarBorda(instante, HIGH);
+      sensor.processarBorda(instante + meio, LOW);
+    }
+    conferir(sensor.lerLimiarNivel() == 0, "filtro de nível ativo sem calibração");
+
+    unsigned long voltas = sensor.lerVoltas();
+    uint8_t risco = sensor.lerIndiceRisco();
+    unsigned long rejeitadas = sensor.lerBordasRejeitadas();
+    uint32_t espurios = 0;
+    bool exato = true;
+    for (uint32_t i = 0; i < 36 * 30; i++) {
+      instante += periodo;
+      sensor.processarBorda(instante, HIGH);
+      exato = exato && fabs(sensor.lerRpmAtual() - esperado) < 0.01;
+      sensor.processarBorda(instante + meio, LOW);
+      if (i % 3 == 1) {
+        unsigned long subida = (unsigned long)(posicoes[espurios % numPosicoes] * periodo);
+        sensor.processarBorda(instante + subida, HIGH);
+        sensor.processarBorda(instante + subida + largura, LOW);
+        espurios++;
+      }
+    }
+    printf("  Estimador %s: %u pulsos espúrios, %lu bordas rejeitadas, RPM: %.3f (esperado %.3f)\n", nomes[e], espurios,
+           sensor.lerBordasRejeitadas() - rejeitadas, sensor.lerRpmAtual(), esperado);
+    conferir(exato, "um pulso espúrio alterou o RPM medido");
+    conferir(sensor.lerBordasRejeitadas() - rejeitadas == espurios, "bordas rejeitadas diferentes dos pulsos espúrios");
+    conferir((sensor.lerVoltas() - voltas) * 36 + sensor.lerIndiceRisco() - risco == 36 * 30, "riscos contados diferentes dos pulsos reais");
+  }
+}
+
+// Gera um perfil (tempos em s, RPM) com o modelo do disco e o reproduz nos quatro estimadores; confere o RMS relativo de
+// cada um contra 'limite' e, se 'erros' não for nulo, devolve os erros de cada estimador. 'preparar' ajusta as
+// instâncias antes da primeira borda.
+static void reproduzirPerfil(const char* descricao, const ParametrosGerador& parametros, const std::vector<double>& tempos,
+                             const std::vector<double>& rpms, double limite, ErrosReproducao* erros = nullptr,
+                             PreparacaoReprodutor preparar = nullptr, double aquecimento = 1.0) {
+  geradorSinais gerador;
+  reprodutorBordas reprodutor;
+  if (!gerador.configurar(parametros, tempos, rpms)) {
+    conferir(false, "perfil recusado pelo gerador");
+    return;
+  }
+  reprodutor.configurar(parametros.numRiscos, (uint16_t)ceil(gerador.rpmMaximoPerfil()), 1000, (uint64_t)(aquecimento * 1e6),
+                        (1 << REPRODUTOR_CONFIGURACOES) - 1);
+  reprodutor.configurarPreparacao(preparar);
+  RegistroArquivoBordas registro;
+  while (gerador.proxima(registro)) {
+    reprodutor.reproduzir(registro);
+  }
+  reprodutor.concluir();
+  saidaSerial.esvaziar();
+  printf("  %s (RMS %%):", descricao);
+  for (uint8_t c = 0; c < REPRODUTOR_CONFIGURACOES; c++) {
+    printf(" %s %.4f", nomesConfiguracoesReprodutor[c], reprodutor.lerErros(c).rmsRelativoPercentual());
+    if (erros != nullptr) {
+      erros[c] = reprodutor.lerErros(c);
+    }
+  }
+  printf("\n");
+  conferir(reprodutor.dentroDoLimite(limite), "RMS relativo acima do limite na reprodução");
+}
+
+// Pulsos perdidos (1% dos pulsos) e glitches (200 por segundo) no modelo do disco de 36 riscos a 600 RPM.
+static void bancadaPerdas(int argc, char** argv) {
+  const std::vector<double> tempos = {0, 10}, rpms = {600, 600};
+  ParametrosGerador perdas;
+  perdas.probabilidadePerda = 0.01;
+  reproduzirPerfil("1% dos pulsos perdidos, 600 RPM", perdas, tempos, rpms, 0.05);
+  ParametrosGerador glitches;
+  glitches.glitchesPorSegundo = 200;
+  reproduzirPerfil("200 glitches/s, 600 RPM", glitches, tempos, rpms, 0.1);
+}
+
+// Ângulo extrapolado entre as bordas (lerAnguloEm) contra o ângulo exato de um disco simulado: 36 riscos a 600 RPM, com
+// aceleração opcional (RPM/s). Compara com o ângulo sem extrapolação (lerAnguloBinario) e mede o custo da leitura.
+static void bancadaPrecisaoAngulo(int argc, char** argv) {
+  const uint8_t riscos = 36;           // Riscos do disco simulado.
+  const uint16_t bordas = 180;         // Bordas simuladas (5 voltas).
+  const uint8_t leituras = 9;          // Leituras por intervalo, igualmente espaçadas entre duas bordas.
+  const double velocidade = 10.0;      // Velocidade inicial (voltas/s = 600 RPM).
+  double aceleracao = lerParametro(argc, argv, 0, 0.0) / 60.0; // Voltas/s^2.
+
+  sensorOpticoPro sensor(2);
+  sensor.configurarParametrosSensorOptico(riscos, 1000);
+  sensor.novoEstimadorRPM(ESTIMADOR_PERIODO);
+
+  // Instante (s) em que o disco chega ao risco k: theta = w0 * t + a * t^2 / 2.
+  auto instanteRisco = [&](uint16_t k) -> double {
+    double voltas = (double)k / riscos;
+    if (aceleracao == 0.0) {
+      return voltas / velocidade;
+    }
+    double discriminante = velocidade * velocidade + 2.0 * aceleracao * voltas;
+    return (discriminante < 0.0) ? -1.0 : (sqrt(discriminante) - velocidade) / aceleracao;
+  };
+
+  double erroMaximo = 0.0, somaQuadrados = 0.0, erroMaximoSemExtrapolacao = 0.0, custo = 0.0;
+  uint32_t amostras = 0;
+  for (uint16_t k = 1; k < bordas; k++) {
+    double t = instanteRisco(k);
+    double proximo = instanteRisco(k + 1);
+    if (t < 0.0 || proximo < 0.0) {
+      break; // O disco parou antes do fim da simulação.
+    }
+    sensor.processarBorda(1000 + (unsigned long)(t * 1e6), HIGH);
+    sensor.processarBorda(1000 + (unsigned long)((t + proximo) * 0.5e6), LOW);
+    if (k < 4) {
+      continue; // Aguarda dois intervalos medidos.
+    }
+    for (uint8_t q = 1; q <= leituras; q++) {
+      double instante = t + (proximo - t) * q / (leituras + 1);
+      double voltas = velocidade * instante + 0.5 * aceleracao * instante * instante;
+      uint16_t exato = (uint16_t)((voltas - floor(voltas)) * 65536.0);
+
+      double inicio = lerNanossegundos();
+      uint16_t estimado = sensor.lerAnguloEm(1000 + (unsigned long)(instante * 1e6));
+      custo += lerNanossegundos() - inicio;
+
+      double erro = abs((int16_t)(estimado - exato)); // A diferença em 16 bits já considera a volta.
+      double erroSemExtrapolacao = abs((int16_t)(sensor.lerAnguloBinario() - exato));
+      erroMaximo = fmax(erroMaximo, erro);
+      erroMaximoSemExtrapolacao = fmax(erroMaximoSemExtrapolacao, erroSemExtrapolacao);
+      somaQuadrados += erro * erro;
+      amostras++;
+    }
+  }
+  if (amostras == 0) {
+    conferir(false, "aceleração alta demais: o disco parou antes das leituras");
+    return;
+  }
+
+  const double graus = 360.0 / 65536.0;
+  double rms = sqrt(somaQuadrados / amostras);
+  printf("  Aceleração %.1f RPM/s, %u leituras: erro máximo %.3f graus, RMS %.3f graus, sem extrapolação %.3f graus, %.1f ns por leitura\n",
+         aceleracao * 60.0, amostras, erroMaximo * graus, rms * graus, erroMaximoSemExtrapolacao * graus, custo / amostras);
+  // Perto da parada o intervalo muda muito de uma borda para a outra: o erro máximo cresce, o RMS continua pequeno.
+  conferir(rms < erroMaximoSemExtrapolacao / 8, "a extrapolação não reduziu o erro do ângulo entre as bordas");
+  conferir(aceleracao != 0.0 || erroMaximo * graus < 0.05, "erro do ângulo extrapolado em velocidade constante");
+}
+
+// Simula um disco de 36 riscos (1000 RPM constantes e depois rampa de 3000 RPM/s, jitter de +-5 us nas bordas) e mede
+// o ruído (desvio padrão do RPM em velocidade constante) e o atraso (erro médio na rampa / aceleração) de um estimador.
+// 'tamanhoMedia' = 0 usa o filtro de rastreamento; caso contrário, a média móvel dos últimos 'tamanhoMedia' intervalos.
+static void medirEstimadorRastreamento(float ruidoProcesso, uint8_t tamanhoMedia, double& ruido, double& atraso) {
+  const uint8_t riscos = 36;
+  const uint16_t bordasConstante = 1000, bordasRampa = 1000, aquecimento = 300;
+  const double aceleracaoRampa = 3000.0; // RPM/s.
+  unsigned long instantes[64];           // Últimos instantes (média móvel).
+
+  filtroRastreamento filtro;
+  filtro.configurarRuido(ruidoProcesso);
+  randomSeed(1); // Mesmo jitter para todos os estimadores.
+
+  double voltasPorSegundo = 1000.0 / 60.0, aceleracao = 0.0, tempo = 0.0;
+  double soma = 0.0, somaQuadrados = 0.0, somaAtraso = 0.0, custo = 0.0;
+  uint16_t amostrasRuido = 0, amostrasAtraso = 0;
+  unsigned long anterior = 0;
+  for (uint16_t k = 0; k < bordasConstante + bordasRampa; k++) {
+    if (k == bordasConstante) {
+      aceleracao = aceleracaoRampa / 60.0;
+    }
+    double passo = 1.0 / riscos; // Voltas por risco.
+    double dt = (aceleracao == 0.0) ? passo / voltasPorSegundo
+              : (sqrt(voltasPorSegundo * voltasPorSegundo + 2.0 * aceleracao * passo) - voltasPorSegundo) / aceleracao;
+    tempo += dt;
+    voltasPorSegundo += aceleracao * dt;
+    unsigned long instante = 1000 + (unsigned long)(tempo * 1e6) + random(-5, 6);
+
+    double rpm = 0.0;
+    if (tamanhoMedia == 0) {
+      double inicio = lerNanossegundos();
+      if (anterior != 0) {
+        filtro.registrar(instante - anterior, 1);
+      }
+      custo += lerNanossegundos() - inicio;
+      rpm = filtro.lerRpm(riscos);
+    } else {
+      if (k >= tamanhoMedia) { // instantes[k % tamanhoMedia] ainda guarda o instante de 'tamanhoMedia' bordas atrás.
+        rpm = 60000000.0 * tamanhoMedia / (riscos * (double)(instante - instantes[k % tamanhoMedia]));
+      }
+      instantes[k % tamanhoMedia] = instante;
+    }
+    anterior = instante;
+
+    double erro = rpm - voltasPorSegundo * 60.0;
+    if (k >= aquecimento && k < bordasConstante) {
+      soma += erro;
+      somaQuadrados += erro * erro;
+      amostrasRuido++;
+    } else if (k >= bordasConstante + aquecimento) {
+      somaAtraso -= erro;
+      amostrasAtraso++;
+    }
+  }
+
+  double media = soma / amostrasRuido;
+  ruido = sqrt(somaQuadrados / amostrasRuido - media * media);
+  atraso = somaAtraso / amostrasAtraso / aceleracaoRampa * 1000.0;
+  if (tamanhoMedia == 0) {
+    printf("  Rastreamento    - ruído: %7.3f RPM | atraso: %6.2f ms | %.1f ns por borda\n", ruido, atraso,
+           custo / (bordasConstante + bordasRampa - 1));
+  } else {
+    printf("  Média móvel %2u  - ruído: %7.3f RPM | atraso: %6.2f ms\n", tamanhoMedia, ruido, atraso);
+  }
+}
+
+// Filtro de rastreamento (alfa-beta-gama) contra médias móveis de 8 a 64 intervalos, com o ruído de processo do
+// parâmetro (padrão: o do filtro). Na reprodução do modelo do disco (rampa de 300 a 1000 RPM, jitter de 20 us), o
+// rastreamento deve ficar abaixo do M/T e do estimador de uma volta.
+static void bancadaRastreamento(int argc, char** argv) {
+  double ruidoProcesso = lerParametro(argc, argv, 0, filtroRastreamento().lerRuidoProcesso());
+  if (!(ruidoProcesso > 0.0)) {
+    conferir(false, "o ruído de processo deve ser maior que zero");
+    return;
+  }
+  double ruidoFiltro, atrasoFiltro, ruido, atraso;
+  medirEstimadorRastreamento((float)ruidoProcesso, 0, ruidoFiltro, atrasoFiltro);
+  bool dominado = false;     // Alguma média móvel com menos ruído e menos atraso que o filtro.
+  bool maisRuidosa = false;  // Alguma média móvel com mais ruído que o filtro.
+  for (uint8_t tamanho = 8; tamanho <= 64; tamanho *= 2) {
+    medirEstimadorRastreamento((float)ruidoProcesso, tamanho, ruido, atraso);
+    dominado = dominado || (ruido < ruidoFiltro && atraso < atrasoFiltro);
+    maisRuidosa = maisRuidosa || ruido > ruidoFiltro;
+  }
+  conferir(!dominado, "uma média móvel tem menos ruído e menos atraso que o filtro de rastreamento");
+  conferir(maisRuidosa, "o filtro de rastreamento não tem menos ruído que nenhuma média móvel");
+
+  ParametrosGerador parametros;
+  parametros.jitter = 20;
+  ErrosReproducao erros[REPRODUTOR_CONFIGURACOES];
+  reproduzirPerfil("Rampa de 300 a 1000 RPM em 10 s, jitter de 20 us", parametros, {0, 10}, {300, 1000}, 2.0, erros);
+  conferir(erros[3].rmsRelativoPercentual() < 0.1, "RMS relativo do rastreamento acima de 0,1% na rampa");
+  conferir(erros[3].rmsRelativoPercentual() * 2 < erros[1].rmsRelativoPercentual(), "rastreamento sem vantagem sobre o M/T na rampa");
+  conferir(erros[3].rmsRelativoPercentual() * 2 < erros[2].rmsRelativoPercentual(), "rastreamento sem vantagem sobre a volta na rampa");
+}
+
+// Desaceleração (RPM/s) de um disco de 36 riscos a 1000 RPM até parar, com o relógio simulado avançando como um loop()
+// de 1 ms: mede o atraso entre a parada física e a leitura zero e o maior excesso da leitura sobre a velocidade real.
+static void medirParada(EstimadorRPM estimador, const char* nome, double desaceleracao) {
+  const uint8_t riscos = 36;               // Riscos do disco simulado.
+  const double velocidade = 1000.0 / 60.0; // Velocidade inicial (voltas/s).
+  const unsigned long passo = 1000;        // Intervalo (micros) entre as chamadas de verificarParada(), como um loop() de 1 ms.
+
+  sensorOpticoPro sensor(2);
+  relogioSimulado() = 1000;
+  sensor.configurarBaseTempo(lerRelogioSimulado);
+  sensor.configurarParametrosSensorOptico(riscos, 1000);
+  sensor.novoEstimadorRPM(estimador);
+
+  // O disco gira 0,2 s em velocidade constante e depois desacelera: theta = w0 * t - a * (t - 0,2)^2 / 2.
+  const double inicioDesaceleracao = 0.2;
+  double instanteParada = inicioDesaceleracao + velocidade / desaceleracao; // Segundos.
+  auto instanteRisco = [&](uint16_t k) -> double { // Instante (s) em que o disco chega ao risco k, ou -1 se parar antes.
+    double voltas = (double)k / riscos;
+    if (voltas <= velocidade * inicioDesaceleracao) {
+      return voltas / velocidade;
+    }
+    voltas -= velocidade * inicioDesaceleracao;
+    double discriminante = velocidade * velocidade - 2.0 * desaceleracao * voltas;
+    return (discriminante < 0.0) ? -1.0 : inicioDesaceleracao + (velocidade - sqrt(discriminante)) / desaceleracao;
+  };
+
+  uint16_t k = 1;
+  double proximaBorda = instanteRisco(k);
+  unsigned long ultimaBorda = 0, penultimaBorda = 0, instanteZero = 0;
+  double excessoMaximo = 0.0; // Maior diferença entre a leitura e a velocidade real (RPM) durante a desaceleração.
+  double leituraAnterior = -1.0; // Leitura da passagem anterior, depois da última borda (-1: ainda não houve).
+  bool acimaDecaimento = false; // Depois da última borda, a leitura subiu ou não seguiu 1 risco / tempo sem bordas.
+  unsigned long fim = 1000 + (unsigned long)(instanteParada * 1e6) + sensor.lerTempoParada() * 1000UL + 100000UL;
+  for (unsigned long agora = 1000; agora < fim && instanteZero == 0; agora += passo) {
+    relogioSimulado() = agora;
+    while (proximaBorda >= 0.0 && 1000 + (unsigned long)(proximaBorda * 1e6) <= agora) {
+      penultimaBorda = ultimaBorda;
+      ultimaBorda = 1000 + (unsigned long)(proximaBorda * 1e6);
+      sensor.processarBorda(ultimaBorda, HIGH);
+      sensor.processarBorda(ultimaBorda + 10, LOW);
+      proximaBorda = instanteRisco(++k);
+    }
+    sensor.verificarParada(sensor.lerBaseTempo().lerMicros());
+
+    double t = (agora - 1000) * 1e-6;
+    double real = (t < inicioDesaceleracao) ? velocidade : velocidade - desaceleracao * (t - inicioDesaceleracao);
+    real = fmax(real, 0.0);
+    double excesso = sensor.lerRpmAtual() - real * 60.0;
+    if (t > inicioDesaceleracao && excesso > excessoMaximo) excessoMaximo = excesso;
+    // Depois da última borda (que fecha a janela M/T ou de uma volta com a média dela), a leitura só desce; passados
+    // dois intervalos, segue 1 risco / (tempo sem bordas - 1/4 de intervalo).
+    unsigned long decorrido = agora - ultimaBorda, intervalo = ultimaBorda - penultimaBorda;
+    if (proximaBorda < 0.0 && sensor.girando()) {
+      acimaDecaimento = acimaDecaimento || (leituraAnterior >= 0.0 && sensor.lerRpmAtual() > leituraAnterior);
+      if (decorrido >= 2 * intervalo) {
+        double decaimento = 60000000.0 / ((double)riscos * (decorrido - intervalo / 4));
+        acimaDecaimento = acimaDecaimento || sensor.lerRpmAtual() > decaimento * 1.001;
+      }
+      leituraAnterior = sensor.lerRpmAtual();
+    }
+    if (!sensor.girando() && (sensor.lerEventosMovimento() & EVENTO_PARADA)) {
+      instanteZero = agora;
+    }
+  }
+  if (instanteZero == 0) {
+    conferir(false, "a parada não foi detectada");
+    return;
+  }
+
+  double atraso = (instanteZero - 1000) * 1e-3 - instanteParada * 1e3; // ms entre a parada física e a leitura zero.
+  unsigned long limite = sensor.lerTempoParada() + passo / 1000;
+  printf("  %-8s parada física: %.1f ms | última borda: %.1f ms | leitura zero: %.1f ms | atraso: %.1f ms (limite: %lu ms)"
+         " | maior excesso: %.2f RPM\n", nome, instanteParada * 1e3, (ultimaBorda - 1000) * 1e-3, (instanteZero - 1000) * 1e-3,
+         atraso, limite, excessoMaximo);
+  conferir(atraso <= limite, "leitura zero depois do tempo limite de parada");
+  conferir(!acimaDecaimento, "leitura subiu ou ficou acima do decaimento depois da última borda");
+}
+
+// Atraso da leitura zero na desaceleração até a parada (parâmetro: RPM/s, padrão 2000) nos estimadores período, M/T e volta.
+static void bancadaParada(int argc, char** argv) {
+  double desaceleracao = lerParametro(argc, argv, 0, 2000.0) / 60.0; // Voltas/s^2.
+  if (desaceleracao <= 0.0) {
+    conferir(false, "a desaceleração deve ser maior que zero (RPM/s)");
+    return;
+  }
+  medirParada(ESTIMADOR_PERIODO, "período", desaceleracao);
+  medirParada(ESTIMADOR_MT, "M/T", desaceleracao);
+  medirParada(ESTIMADOR_VOLTA, "volta", desaceleracao);
+}
+
+// Volta do micros() com o relógio simulado: RPM atravessando a volta do contador de 32 bits, parada depois de horas sem
+// chamadas e nova partida. O instante de 64 bits da base de tempo deve crescer sempre. No Linux unsigned long tem 64
+// bits: as bordas recebem o instante sem a volta, como o micros() simulado, e a volta de 32 bits é a do relógio da base
+// de tempo (verificarParada e o instante estendido de cada borda).
+static void medirRelogio(EstimadorRPM estimador, const char* nome) {
+  const uint8_t riscos = 36;          // Riscos do disco simulado.
+  const uint32_t passo = 1000;        // Intervalo (micros) entre chamadas, como um loop() de 1 ms.
+  const uint32_t inicio = 0xFFFFFFFFUL - 1500000UL; // 1,5 s antes da volta do contador de 32 bits.
+
+  sensorOpticoPro sensor(2);
+  relogioSimulado() = inicio;
+  sensor.configurarBaseTempo(lerRelogioSimulado);
+  sensor.configurarParametrosSensorOptico(riscos, 1000);
+  sensor.novoEstimadorRPM(estimador);
+  baseTempo& relogio = sensor.lerBaseTempo();
+
+  // Gira por 'duracao' micros a 'rpm' a partir de 'agora' (o relógio simulado avança de 'passo' em 'passo').
+  // Retorna o maior erro relativo do RPM depois de 'acomodacao' micros e verifica que o instante de 64 bits só cresce.
+  bool monotonico = true;
+  uint64_t anterior = relogio.lerMicros();
+  auto girar = [&](uint64_t& agora, double rpm, uint32_t duracao, uint32_t acomodacao) -> double {
+    double periodo = 60000000.0 / (rpm * riscos);
+    double proximaBorda = periodo;
+    double erroMaximo = 0.0;
+    for (uint32_t decorrido = 0; decorrido < duracao; decorrido += passo) {
+      while (proximaBorda <= decorrido) {
+        unsigned long borda = (unsigned long)(agora - decorrido + (uint64_t)proximaBorda);
+        sensor.processarBorda(borda, HIGH);
+        sensor.processarBorda(borda + (unsigned long)(periodo / 2), LOW);
+        proximaBorda += periodo;
+      }
+      uint64_t instante = relogio.lerMicros();
+      monotonico = monotonico && instante >= anterior;
+      anterior = instante;
+      sensor.verificarParada(instante);
+      if (decorrido >= acomodacao) {
+        erroMaximo = fmax(erroMaximo, fabs(sensor.lerRpmAtual() - rpm) / rpm);
+      }
+      agora += passo;
+      relogioSimulado() = (unsigned long)agora; // lerRelogioSimulado() devolve os 32 bits baixos, como o micros() da placa.
+    }
+    return erroMaximo;
+  };
+
+  // 1) Três segundos a 1000 RPM atravessando a volta do contador.
+  uint64_t agora = inicio;
+  double erroVolta = girar(agora, 1000.0, 3000000UL, 200000UL);
+  sensor.lerEventosMovimento();
+  unsigned long voltasContador = relogio.lerVoltas();
+
+  // 2) Três horas parado, com chamadas a cada 50 minutos (mais de meia volta do contador de 32 bits entre elas).
+  const uint32_t intervaloChamadas = 50UL * 60UL * 1000000UL;
+  bool paradaDetectada = false;
+  for (uint8_t i = 0; i < 4; i++) {
+    agora += intervaloChamadas;
+    relogioSimulado() = (unsigned long)agora;
+    uint64_t instante = relogio.lerMicros();
+    monotonico = monotonico && instante >= anterior;
+    anterior = instante;
+    sensor.verificarParada(instante);
+    if (i == 0) {
+      paradaDetectada = !sensor.girando() && (sensor.lerEventosMovimento() & EVENTO_PARADA) && sensor.lerRpmAtual() == 0.0;
+    }
+  }
+
+  // 3) Nova partida a 500 RPM.
+  double erroPartida = girar(agora, 500.0, 1000000UL, 200000UL);
+  bool partida = sensor.lerEventosMovimento() & EVENTO_PARTIDA;
+  printf("  %-8s volta do contador: %lu voltas, erro máximo %.3f%% | parada após 50 min: %s | voltas: %lu"
+         " | partida: %s, erro máximo %.3f%% | instante de 64 bits crescente: %s\n", nome, voltasContador, erroVolta * 100.0,
+         paradaDetectada ? "sim" : "NÃO", (unsigned long)relogio.lerVoltas(), partida ? "sim" : "NÃO", erroPartida * 100.0,
+         monotonico ? "sim" : "NÃO");
+  conferir(voltasContador == 1, "a volta do contador de 32 bits não foi contada");
+  conferir(erroVolta < 0.001, "erro do RPM na volta do contador");
+  conferir(paradaDetectada, "parada não detectada depois de 50 min sem chamadas");
+  conferir(partida && erroPartida < 0.001, "nova partida sem o evento ou com erro no RPM");
+  conferir(relogio.lerVoltas() == (unsigned long)(agora >> 32), "voltas do contador diferentes das do relógio simulado");
+  conferir(monotonico, "o instante de 64 bits diminuiu");
+}
+
+// Volta do contador de 32 bits do micros() nos estimadores período, M/T e volta.
+static void bancadaRelogio(int argc, char** argv) {
+  medirRelogio(ESTIMADOR_PERIODO, "período");
+  medirRelogio(ESTIMADOR_MT, "M/T");
+  medirRelogio(ESTIMADOR_VOLTA, "volta");
+}
+
+// Estimadores em um disco de 36 riscos com espaçamento irregular (parâmetro: erro máximo de cada risco em %, padrão 3):
+// ondulação a 1000 RPM e atraso até 1% de um degrau para 1100 RPM. Na reprodução do modelo do disco (erro de largura de
+// 5% e excentricidade de 2 graus), o estimador de uma volta não pode ver o erro de geometria.
+static void bancadaVolta(int argc, char** argv) {
+  const uint8_t riscos = 36;      // Riscos do disco simulado.
+  const uint8_t voltas = 10;      // Voltas simuladas em cada velocidade.
+  const double rpmInicial = 1000.0;
+  const double rpmFinal = 1100.0; // Degrau de velocidade depois de 'voltas' voltas.
+  double erroRisco = lerParametro(argc, argv, 0, 3.0) / 100.0;
+
+  // Largura de cada risco: padrão pseudoaleatório fixo (erro de corte) mais excentricidade (uma senoide por volta).
+  double largura[riscos];
+  double soma = 0.0;
+  for (uint8_t i = 0; i < riscos; i++) {
+    largura[i] = 1.0 + erroRisco * (((i * 7919UL) % 101) / 50.0 - 1.0) + 0.5 * erroRisco * sin(2.0 * M_PI * i / riscos);
+    soma += largura[i];
+  }
+  for (uint8_t i = 0; i < riscos; i++) {
+    largura[i] *= riscos / soma; // A volta continua tendo 360 graus.
+  }
+
+  const char* const nomes[] = {"período", "M/T", "volta"};
+  double ondulacao[3], atrasos[3];
+  for (uint8_t estimador = ESTIMADOR_PERIODO; estimador <= ESTIMADOR_VOLTA; estimador++) {
+    sensorOpticoPro sensor(2);
+    sensor.configurarParametrosSensorOptico(riscos, 1000);
+    sensor.novoEstimadorRPM(static_cast<EstimadorRPM>(estimador));
+
+    double instante = 1000.0, minimo = 1e9, maximo = 0.0, instanteDegrau = 0.0, atraso = -1.0;
+    for (uint16_t k = 0; k < 2 * voltas * riscos; k++) {
+      bool depois = (k >= voltas * riscos);
+      if (depois && instanteDegrau == 0.0) instanteDegrau = instante;
+      instante += largura[k % riscos] * 60000000.0 / ((depois ? rpmFinal : rpmInicial) * riscos);
+      sensor.processarBorda((unsigned long)instante, HIGH);
+      sensor.processarBorda((unsigned long)instante + 100, LOW);
+      double rpm = sensor.lerRpmAtual();
+      if (!depois && k >= 3 * riscos) { // Ondulação depois de a medição acomodar.
+        minimo = fmin(minimo, rpm);
+        maximo = fmax(maximo, rpm);
+      }
+      if (depois && atraso < 0.0 && fabs(rpm - rpmFinal) < 0.01 * rpmFinal) {
+        atraso = (instante - instanteDegrau) / 1000.0;
+      }
+    }
+    uint8_t e = estimador - ESTIMADOR_PERIODO;
+    ondulacao[e] = (maximo - minimo) / rpmInicial * 100.0;
+    atrasos[e] = atraso;
+    printf("  %-8s ondulação a 1000 RPM: %7.3f%% pico a pico | atraso até 1%% do degrau para 1100 RPM: %6.2f ms\n",
+           nomes[e], ondulacao[e], atraso);
+  }
+  const double umaVolta = 60000.0 / rpmFinal; // ms.
+  conferir(ondulacao[2] < 0.01, "ondulação do estimador de uma volta com o disco irregular");
+  conferir(erroRisco == 0.0 || ondulacao[2] * 10 < ondulacao[0], "estimador de uma volta sem vantagem sobre o período");
+  conferir(atrasos[2] >= 0.0 && atrasos[2] <= umaVolta * 1.05, "atraso do estimador de uma volta acima de uma volta");
+
+  ParametrosGerador parametros;
+  parametros.erroLargura = 0.05;
+  parametros.excentricidade = 2;
+  ErrosReproducao erros[REPRODUTOR_CONFIGURACOES];
+  reproduzirPerfil("Erro de largura de 5% e excentricidade de 2 graus, 1000 RPM", parametros, {0, 10}, {1000, 1000}, 20.0, erros);
+  conferir(erros[2].rmsRelativoPercentual() < 0.01, "o estimador de uma volta viu o erro de geometria na reprodução");
+}
+
+// Saída da telemetria na bancada: guarda os quadros para a decodificação no fim.
+static std::vector<std::vector<uint8_t>> quadrosTelemetria;
+static void guardarQuadroTelemetria(const uint8_t* quadro, uint8_t tamanho) {
+  quadrosTelemetria.push_back(std::vector<uint8_t>(quadro, quadro + tamanho));
+}
+
+// Destino de texto que apenas conta os bytes: mede a formatação do modo texto sem o tempo de transmissão da Serial.
+class contadorBytesTexto : public Print {
+  public:
+    unsigned long bytes = 0;
+    size_t write(uint8_t) { bytes++; return 1; }
+};
+
+// Bytes e custo por amostra da saída em texto e da telemetria binária, com bordas sintéticas de um disco de 36 riscos a
+// 1000 RPM com jitter de +-2 us; todos os quadros passam pelo COBS e pelo CRC e todas as amostras são decodificadas e
+// comparadas com as publicadas. Em todas as configurações (por borda, por janela do M/T, com pulsos perdidos) a telemetria
+// deve ocupar no máximo um décimo dos bytes do texto. O custo é medido à parte, repetindo a formatação e a codificação
+// das mesmas medições, sem o cálculo do RPM.
+static void medirTelemetria(EstimadorRPM estimador, const char* nome, uint32_t intervaloPerda, uint32_t pulsos) {
+  const unsigned long periodo = 1667; // Micros: 36 riscos a 1000 RPM.
+  const uint8_t repeticoes = 20;      // Passagens pelas medições na medida do custo.
+  sensorOpticoPro sensor(2);
+  sensor.configurarParametrosSensorOptico(36, 1000);
+  sensor.novoEstimadorRPM(estimador);
+  quadrosTelemetria.clear();
+  sensor.configurarTelemetria(TELEMETRIA_BINARIA, guardarQuadroTelemetria);
+
+  std::vector<AmostraTelemetria> publicadas;
+  std::vector<float> rpms;
+  unsigned long instante = 0;
+  for (uint32_t i = 0; i < pulsos; i++) {
+    instante += periodo + (i % 5) - 2; // O RPM varia de uma amostra para a outra.
+    if (intervaloPerda != 0 && i % intervaloPerda == intervaloPerda - 1) {
+      continue; // Pulso perdido: o risco avança dois.
+    }
+    if (sensor.processarBorda(instante, HIGH)) {
+      float rpm = sensor.lerRpmAtual();
+      sensor.publicarMedicao(rpm);
+      publicadas.push_back({(uint32_t)instante, (int32_t)(rpm * 100.0 + 0.5), sensor.lerIndiceRisco()});
+      rpms.push_back(rpm);
+    }
+    sensor.processarBorda(instante + periodo / 2, LOW);
+  }
+  sensor.descarregarTelemetria();
+
+  // Custo: mesma formatação do modo texto do calcularRPM() e mesma codificação do publicarMedicao().
+  contadorBytesTexto texto;
+  double inicio = lerNanossegundos();
+  for (uint8_t r = 0; r < repeticoes; r++) {
+    for (float rpm : rpms) {
+      texto.print("RPM: ");
+      texto.println(rpm);
+    }
+  }
+  double custoTexto = (lerNanossegundos() - inicio) / (repeticoes * rpms.size());
+  telemetriaBinaria<SENSOR_OPTICO_TAMANHO_QUADRO_TELEMETRIA> binaria;
+  binaria.configurar(nullptr, 36, estimador);
+  inicio = lerNanossegundos();
+  for (uint8_t r = 0; r < repeticoes; r++) {
+    for (size_t i = 0; i < rpms.size(); i++) {
+      binaria.registrarAmostra(publicadas[i].instante, (int32_t)(rpms[i] * 100.0 + 0.5), publicadas[i].risco);
+    }
+  }
+  double custoBinario = (lerNanossegundos() - inicio) / (repeticoes * rpms.size());
+
+  // Decodificação de todos os quadros: configuração primeiro, depois as amostras na ordem publicada.
+  AmostraTelemetria decodificadas[SENSOR_OPTICO_TAMANHO_QUADRO_TELEMETRIA];
+  size_t conferidas = 0;
+  bool validos = !quadrosTelemetria.empty(), iguais = true;
+  uint8_t numRiscos = 0;
+  for (std::vector<uint8_t>& quadro : quadrosTelemetria) {
+    uint8_t conteudo = desenquadrarTelemetria(quadro.data(), (uint8_t)(quadro.size() - 1));
+    if (conteudo == 0) {
+      validos = false;
+    } else if (quadro[0] == QUADRO_CONFIGURACAO) {
+      validos = validos && quadro[1] == TELEMETRIA_VERSAO;
+      numRiscos = quadro[2];
+    } else if (quadro[0] == QUADRO_AMOSTRAS || quadro[0] == QUADRO_AMOSTRAS_JANELA) { // Os eventos (partida) não têm amostras.
+      int16_t lidas = decodificarAmostrasTelemetria(quadro.data(), conteudo, numRiscos, decodificadas,
+                                                    SENSOR_OPTICO_TAMANHO_QUADRO_TELEMETRIA);
+      validos = validos && lidas > 0 && numRiscos != 0;
+      for (int16_t i = 0; i < lidas && conferidas < publicadas.size(); i++, conferidas++) {
+        const AmostraTelemetria& a = decodificadas[i];
+        const AmostraTelemetria& b = publicadas[conferidas];
+        iguais = iguais && a.instante == b.instante && a.rpmCentesimos == b.rpmCentesimos && a.risco == b.risco;
+      }
+    }
+  }
+
+  double bytesTexto = (double)texto.bytes / (repeticoes * rpms.size());
+  double bytesBinario = (double)sensor.lerTelemetria().lerBytesEnviados() / publicadas.size();
+  printf("  %-34s texto: %5.2f bytes, %6.1f ns | binária: %4.2f bytes, %5.1f ns, %lu quadros | redução: %4.1fx bytes, %4.1fx custo\n",
+         nome, bytesTexto, custoTexto, bytesBinario, custoBinario, (unsigned long)quadrosTelemetria.size(),
+         bytesTexto / bytesBinario, custoBinario > 0.0 ? custoTexto / custoBinario : 0.0);
+  conferir(validos, "quadro de telemetria com COBS, CRC ou conteúdo inválido");
+  conferir(iguais && conferidas == publicadas.size(), "amostra decodificada diferente da publicada");
+  conferir(custoBinario < custoTexto, "telemetria binária mais cara que o texto");
+  conferir(bytesTexto / bytesBinario >= 10.0, "telemetria binária sem redução de uma ordem de grandeza nos bytes");
+}
+
+static void bancadaTelemetria(int argc, char** argv) {
+  uint32_t pulsos = (uint32_t)lerParametro(argc, argv, 0, 50000);
+  medirTelemetria(ESTIMADOR_PERIODO, "período", 0, pulsos);
+  medirTelemetria(ESTIMADOR_MT, "M/T", 0, pulsos);
+  medirTelemetria(ESTIMADOR_PERIODO, "período, 1 pulso perdido a cada 50", 50, pulsos);
+  medirTelemetria(ESTIMADOR_MT, "M/T, 1 pulso perdido a cada 50", 50, pulsos);
+}
+
+// Receptor simulado da bancada da fila de saída: confere se as mensagens chegam inteiras e se a resposta não é
+// intercalada. Telemetria: 0xA5, sequência (2 bytes) e 10 bytes 0x5A; resposta: bytes 'R'.
+struct ReceptorBancadaSaida {
+  int credito = 0;                  // Bytes que o "enlace" aceita nesta passagem (espaço livre simulado).
+  uint8_t posicao = 0;              // Posição dentro da mensagem de telemetria em recepção (0: fora de uma mensagem).
+  uint8_t byteBaixo = 0;            // Byte baixo da sequência da mensagem em recepção.
+  uint16_t ultimaSequencia = 0;
+  bool respostaPendente = false;    // A resposta já foi enfileirada e ainda não começou a chegar.
+  uint16_t bytesAntesResposta = 0;  // Bytes de telemetria recebidos entre o enfileiramento e o início da resposta.
+  uint16_t bytesResposta = 0;
+  uint16_t mensagens = 0;           // Mensagens de telemetria recebidas inteiras.
+  uint16_t erros = 0;               // Bytes fora do formato (mensagem cortada ou intercalada, sequência fora de ordem).
+};
+static ReceptorBancadaSaida receptorBancada;
+
+static void receberBancadaSaida(const uint8_t* dados, uint8_t tamanho) {
+  ReceptorBancadaSaida& r = receptorBancada;
+  r.credito -= tamanho;
+  for (uint8_t i = 0; i < tamanho; i++) {
+    uint8_t valor = dados[i];
+    if (r.posicao == 0) {
+      if (valor == 'R') {
+        r.bytesResposta++;
+        r.respostaPendente = false;
+        continue;
+      }
+      if (valor != 0xA5) {
+        r.erros++;
+        continue;
+      }
+    } else if (r.posicao == 1) {
+      r.byteBaixo = valor;
+    } else if (r.posicao == 2) {
+      uint16_t sequencia = ((uint16_t)valor << 8) | r.byteBaixo;
+      if (r.mensagens > 0 && sequencia <= r.ultimaSequencia) {
+        r.erros++; // A sequência só cresce: descartes deixam lacunas, nunca invertem a ordem.
+      }
+      r.ultimaSequencia = sequencia;
+    } else if (valor != 0x5A) {
+      r.erros++;
+    }
+    if (r.respostaPendente) {
+      r.bytesAntesResposta++;
+    }
+    if (++r.posicao == 13) {
+      r.posicao = 0;
+      r.mensagens++;
+    }
+  }
+}
+
+static int espacoBancadaSaida() {
+  return receptorBancada.credito;
+}
+
+// Fila de saída com um enlace mais lento que a telemetria gerada, nas duas políticas: descartes, pior tempo por
+// mensagem e atraso de uma resposta. Nenhuma mensagem pode chegar cortada, intercalada ou fora de ordem, e a resposta
+// espera no máximo o restante da mensagem de telemetria em transmissão.
+static void bancadaSaida(int argc, char** argv) {
+  const uint16_t mensagens = (uint16_t)lerParametro(argc, argv, 0, 1000); // Mensagens de 13 bytes, como "RPM: 999.80\r\n".
+  const uint8_t creditoPorPassagem = 8;          // Bytes que o enlace transmite por passagem: ~60% dos 13 gerados.
+  const uint16_t passagemResposta = mensagens / 2; // Passagem em que uma resposta de comando é enfileirada.
+  const uint8_t bytesResposta = 16;
+
+  for (uint8_t politica = POLITICA_DESCARTAR_ANTIGAS; politica <= POLITICA_DIZIMAR; politica++) {
+    filaSaida<32, 96> fila(receberBancadaSaida, espacoBancadaSaida); // Fila pequena: os descartes aparecem logo.
+    fila.configurarPolitica(static_cast<PoliticaSaida>(politica), 2);
+    receptorBancada = ReceptorBancadaSaida();
+
+    uint8_t mensagem[13];
+    mensagem[0] = 0xA5;
+    for (uint8_t i = 3; i < sizeof(mensagem); i++) {
+      mensagem[i] = 0x5A;
+    }
+    double piorMensagem = 0.0, piorAtender = 0.0;
+    for (uint16_t passagem = 0; passagem < mensagens; passagem++) {
+      mensagem[1] = (uint8_t)passagem;
+      mensagem[2] = (uint8_t)(passagem >> 8);
+      double inicio = lerNanossegundos();
+      fila.enviarMensagem(mensagem, sizeof(mensagem)); // Caminho da medição: nunca espera pelo enlace.
+      piorMensagem = fmax(piorMensagem, lerNanossegundos() - inicio);
+
+      if (passagem == passagemResposta) {
+        for (uint8_t i = 0; i < bytesResposta; i++) {
+          fila.escrever('R'); // Resposta: cabe na fila de respostas, entra sem esperar.
+        }
+        receptorBancada.respostaPendente = true;
+      }
+
+      receptorBancada.credito = creditoPorPassagem;
+      inicio = lerNanossegundos();
+      fila.atender();
+      piorAtender = fmax(piorAtender, lerNanossegundos() - inicio);
+    }
+
+    const ReceptorBancadaSaida& r = receptorBancada;
+    unsigned long descartadas = fila.lerDescartadasAntigas() + fila.lerDescartadasNovas() + fila.lerDizimadas();
+    printf("  %-27s recebidas inteiras: %u/%u, descartadas (antigas/novas/dizimadas): %u/%u/%u\n",
+           politica == POLITICA_DIZIMAR ? "dizimar (fator 2)" : "descartar antigas", r.mensagens, mensagens,
+           (unsigned)fila.lerDescartadasAntigas(), (unsigned)fila.lerDescartadasNovas(), (unsigned)fila.lerDizimadas());
+    printf("  %-27s pior tempo por mensagem: %.0f ns, pior atender(): %.0f ns | resposta: %u bytes depois de %u bytes"
+           " de telemetria | bytes fora do formato: %u\n", "", piorMensagem, piorAtender, r.bytesResposta,
+           r.bytesAntesResposta, r.erros);
+    conferir(r.erros == 0, "mensagem cortada, intercalada ou fora de ordem no receptor");
+    conferir(r.bytesResposta == bytesResposta, "resposta incompleta");
+    conferir(r.bytesAntesResposta <= sizeof(mensagem) - 1, "resposta esperou mais que o restante de uma mensagem");
+    conferir(descartadas > 0 && r.mensagens + descartadas <= mensagens, "descartes e mensagens recebidas incoerentes");
+  }
+}
+
+// Gerador da bancada da captura: 20 mil bordas por segundo (50 us +-3 us entre bordas), níveis alternados.
+struct GeradorCaptura {
+  uint32_t instante;
+  uint16_t indice;
+  uint8_t nivel;
+};
+
+static void avancarGeradorCaptura(GeradorCaptura& gerador) {
+  gerador.instante += 47 + (gerador.indice % 7);
+  gerador.indice++;
+  gerador.nivel = !gerador.nivel;
+}
+
+// Saídas da bancada da captura: a primeira apenas aceita os quadros; a segunda decodifica cada quadro e confere as bordas.
+static GeradorCaptura esperadoBancadaCaptura;
+static uint32_t conferidasBancadaCaptura = 0;
+static uint32_t errosBancadaCaptura = 0;
+
+static bool aceitarQuadroCaptura(const uint8_t* quadro, uint8_t tamanho) {
+  return true;
+}
+
+static bool conferirQuadroCaptura(const uint8_t* quadro, uint8_t tamanho) {
+  uint8_t conteudo[SENSOR_OPTICO_TAMANHO_QUADRO_CAPTURA];
+  memcpy(conteudo, quadro + 1, tamanho - 2); // Sem o 0x00 separador e sem o terminador.
+  uint8_t util = desenquadrarTelemetria(conteudo, tamanho - 2);
+  CabecalhoCaptura cabecalho;
+  if (quadro[0] != 0 || util == 0 || !capturaBordasSensor::lerCabecalho(conteudo, util, cabecalho)) {
+    errosBancadaCaptura++;
+    return true;
+  }
+  uint32_t instante = cabecalho.referencia;
+  uint32_t delta;
+  uint8_t nivel;
+  while (capturaBordasSensor::lerRegistro(conteudo, util, cabecalho.posicao, delta, nivel)) {
+    instante += delta;
+    if (instante != esperadoBancadaCaptura.instante || nivel != esperadoBancadaCaptura.nivel) {
+      errosBancadaCaptura++;
+    }
+    conferidasBancadaCaptura++;
+    avancarGeradorCaptura(esperadoBancadaCaptura);
+  }
+  return true;
+}
+
+// Captura de bordas a 20 mil bordas/s, começando perto da volta do micros(): bytes e custo por borda e decodificação de
+// todos os quadros. Os quadros só ocupam a arena entre o armar() e a saída do último quadro depois da parada, e uma
+// captura sem espaço na arena (janela de uma volta reservada) não é armada.
+static void bancadaCaptura(int argc, char** argv) {
+  uint16_t bordas = (uint16_t)lerParametro(argc, argv, 0, 20000);
+  arenaMemoria& arena = sensorOpticoPro::lerArena();
+  const uint16_t bytesQuadros = (uint16_t)SENSOR_OPTICO_QUADROS_CAPTURA * SENSOR_OPTICO_TAMANHO_QUADRO_CAPTURA;
+
+  // Passagem 1: custo por borda com uma saída que só aceita. Passagem 2: mesmas bordas, conferidas depois da decodificação.
+  double custo = 0.0;
+  unsigned long bytes = 0;
+  conferidasBancadaCaptura = 0;
+  errosBancadaCaptura = 0;
+  for (uint8_t passagem = 0; passagem < 2; passagem++) {
+    capturaBordasSensor captura(arena, passagem == 0 ? aceitarQuadroCaptura : conferirQuadroCaptura);
+    conferir(arena.emUso() == 0 && !captura.lerQuadrosReservados(), "captura parada ocupando a arena");
+    GeradorCaptura gerador = { 0xFFFFF000UL, 0, LOW }; // Começa perto da volta do micros().
+    esperadoBancadaCaptura = gerador;
+    conferir(captura.armar(bordas), "captura não armada com a arena livre");
+    conferir(arena.emUso() >= bytesQuadros, "quadros da captura fora da arena");
+    captura.disparar();
+    double inicio = lerNanossegundos();
+    for (uint16_t i = 0; i < bordas; i++) {
+      captura.registrar(gerador.instante, gerador.nivel);
+      captura.atender(); // Como no calcularRPM(): um atender() por passagem.
+      avancarGeradorCaptura(gerador);
+    }
+    captura.atender();
+    if (passagem == 0) {
+      custo = (lerNanossegundos() - inicio) / bordas;
+      bytes = captura.lerBytesEnviados();
+    }
+    conferir(captura.lerEstado() == CAPTURA_PARADA && arena.emUso() == 0,
+             "arena não devolvida depois da parada e do envio do último quadro");
+  }
+  double bytesPorBorda = (double)bytes / bordas;
+  printf("  Bytes por borda: %.2f, custo por borda: %.1f ns, taxa máxima na Serial a 1 Mbaud: %.0f bordas/s\n",
+         bytesPorBorda, custo, 100000.0 / bytesPorBorda); // 10 bits por byte na Serial (início, 8 dados, fim).
+  printf("  Decodificação: %u/%u bordas conferidas, %u erros\n", conferidasBancadaCaptura, bordas, errosBancadaCaptura);
+  conferir(conferidasBancadaCaptura == bordas && errosBancadaCaptura == 0, "bordas decodificadas diferentes das capturadas");
+  conferir(bytesPorBorda < 1.5, "captura acima de 1,5 bytes por borda a 20 mil bordas/s");
+
+  // Com a janela de uma volta na arena, não há espaço para os quadros: armar() recusa sem alterar a captura.
+  sensorOpticoPro sensor(2);
+  sensor.configurarParametrosSensorOptico(36, 1000);
+  sensor.novoEstimadorRPM(ESTIMADOR_VOLTA);
+  capturaBordasSensor captura(arena, aceitarQuadroCaptura);
+  uint16_t emUso = arena.emUso();
+  bool armada = captura.armar(0);
+  printf("  Arena com a janela de uma volta (%u de %u bytes): captura de %u bytes %s\n", emUso, arena.capacidade(),
+         bytesQuadros, armada ? "armada" : "recusada");
+  conferir(!armada && captura.lerEstado() == CAPTURA_PARADA && arena.emUso() == emUso, "captura armada sem espaço na arena");
+  sensor.novoEstimadorRPM(ESTIMADOR_MT);
+  conferir(captura.armar(0), "captura recusada depois de a janela ser devolvida");
+  captura.parar();
+  captura.atender();
+  conferir(arena.emUso() == 0, "captura parada sem quadros não devolveu a arena");
+}
+
+// Instâncias da bancada M/T: a mesma configuração em toda a faixa (RPM máximo de 20000) e tempo de parada para 1 RPM,
+// em que as bordas de subida de um disco de 36 riscos chegam a cada 1,7 s.
+static void prepararBancadaMT(sensorOpticoPro& sensor, uint8_t configuracao) {
+  (void)configuracao;
+  sensor.configurarParametrosSensorOptico(sensor.lerNumRiscos(), 20000);
+  sensor.novoTempoParada(3000);
+}
+
+// Estimador M/T de 1 a 20000 RPM na reprodução do modelo do disco, com as bordas carimbadas na resolução de 4 us do
+// micros() do Uno: a mesma fórmula em toda a faixa, sem ponto de troca. O erro fica abaixo de um tique do relógio sobre
+// a janela medida (a janela de 50 Hz, ou um intervalo entre bordas quando ele é mais longo), e nunca acima do período.
+// O aquecimento cobre a primeira volta inteira (o estimador de uma volta lê zero até ela terminar, ~46 s a 1,3 RPM), e
+// todas as configurações devem ficar abaixo do RMS relativo limite.
+static void bancadaMT(int argc, char** argv) {
+  double limite = lerParametro(argc, argv, 0, 2.0);
+  const double velocidades[] = {1.3, 13.7, 137, 1370, 13700, 19900}; // Fora dos múltiplos exatos do tique.
+  const double tique = 4.0;      // Resolução do micros() (us).
+  const double janela = 20000.0; // Janela do M/T na taxa padrão de 50 Hz (us).
+  ParametrosGerador parametros;
+  parametros.resolucao = (uint32_t)tique;
+  for (double rpm : velocidades) {
+    char descricao[48];
+    snprintf(descricao, sizeof(descricao), "%g RPM, micros() de 4 us", rpm);
+    double intervalo = 60e6 / (rpm * parametros.numRiscos);  // Entre bordas de subida (us).
+    double duracao = fmax(10.0, 200.0 * intervalo / 1e6);     // Pelo menos ~150 bordas de subida depois do aquecimento.
+    ErrosReproducao erros[REPRODUTOR_CONFIGURACOES];
+    double aquecimento = fmax(1.0, 1.5 * 60.0 / rpm);         // Uma volta e meia.
+    reproduzirPerfil(descricao, parametros, {0, duracao}, {rpm, rpm}, limite, erros, prepararBancadaMT, aquecimento);
+    double rmsMT = erros[1].rms() / rpm * 100.0, rmsPeriodo = erros[0].rms() / rpm * 100.0;
+    double resolucao = tique / fmax(janela, intervalo) * 100.0;
+    printf("    M/T: RMS %.5f%% (um tique sobre a janela: %.4f%%), período: %.5f%%\n", rmsMT, resolucao, rmsPeriodo);
+    conferir(erros[1].comparacoes > 100, "poucas comparações do M/T");
+    conferir(rmsMT < resolucao, "RMS do M/T acima de um tique sobre a janela");
+    conferir(rmsMT <= rmsPeriodo * 1.01 + 1e-6, "M/T pior que o período");
+  }
+}
+
+// Instâncias da bancada da geometria: aprendem a tabela nas primeiras voltas, em velocidade constante.
+static void prepararBancadaGeometria(sensorOpticoPro& sensor, uint8_t configuracao) {
+  (void)configuracao;
+  sensor.aprenderGeometria(20);
+}
+
+// Reproduz o disco irregular da bancada da geometria e devolve o maior erro relativo (%) por borda do período e do M/T
+// nos trechos de velocidade constante (depois do aprendizado e fora do degrau). 'ativas': instâncias com a tabela aplicada.
+static void reproduzirGeometria(const ParametrosGerador& parametros, bool aprender, double picos[2], uint8_t& ativas) {
+  const std::vector<double> tempos = {0, 4, 4, 8}, rpms = {1000, 1000, 1300, 1300}; // Degrau no meio, com a tabela já aprendida.
+  geradorSinais gerador;
+  reprodutorBordas reprodutor;
+  gerador.configurar(parametros, tempos, rpms);
+  reprodutor.configurar(parametros.numRiscos, 1300, 1000, 1000000, (1 << REPRODUTOR_CONFIGURACOES) - 1);
+  reprodutor.configurarPreparacao(aprender ? prepararBancadaGeometria : nullptr);
+  picos[0] = picos[1] = 0.0;
+  RegistroArquivoBordas registro;
+  while (gerador.proxima(registro)) {
+    reprodutor.reproduzir(registro);
+    double segundos = registro.instante() / 1e6;
+    bool constante = (segundos >= 2.0 && segundos < 4.0) || segundos >= 4.5;
+    if (registro.nivel() == HIGH && registro.temVerdade() && constante) {
+      for (uint8_t c = 0; c < 2; c++) {
+        double erro = fabs(reprodutor.lerSensor(c)->lerRpmAtual() - registro.rpmVerdadeiro) / registro.rpmVerdadeiro * 100.0;
+        picos[c] = fmax(picos[c], erro);
+      }
+    }
+  }
+  saidaSerial.esvaziar();
+  ativas = 0;
+  for (uint8_t c = 0; c < REPRODUTOR_CONFIGURACOES; c++) {
+    ativas += reprodutor.lerSensor(c)->lerGeometria().ativa() ? 1 : 0;
+  }
+}
+
+// Tabela da geometria na reprodução de um disco com espaçamento irregular (excentricidade de 2 graus, ~3,5% de erro
+// senoidal no espaçamento, mais 1% de erro de largura por borda) e jitter de 2 us: o aprendizado nas primeiras 20 voltas
+// deve levar o pico do erro por borda do período ao piso do jitter e o do M/T a menos de um décimo, também depois de um
+// degrau de 1000 para 1300 RPM.
+static void bancadaGeometria(int argc, char** argv) {
+  ParametrosGerador parametros;
+  parametros.excentricidade = lerParametro(argc, argv, 0, 2.0);
+  parametros.erroLargura = 0.01;
+  parametros.jitter = 2.0;
+  double sem[2], com[2];
+  uint8_t ativasSem, ativasCom;
+  reproduzirGeometria(parametros, false, sem, ativasSem);
+  reproduzirGeometria(parametros, true, com, ativasCom);
+  printf("  Pico do erro por borda (1000 e 1300 RPM) - período: %.3f%% -> %.3f%%, M/T: %.3f%% -> %.3f%% (%u de %u tabelas ativas)\n",
+         sem[0], com[0], sem[1], com[1], ativasCom, REPRODUTOR_CONFIGURACOES);
+
+  // Piso do jitter: o mesmo disco sem erro de geometria.
+  ParametrosGerador regular;
+  regular.jitter = parametros.jitter;
+  double piso[2];
+  uint8_t ativasRegular;
+  reproduzirGeometria(regular, false, piso, ativasRegular);
+  printf("  Disco regular com o mesmo jitter - período: %.3f%%, M/T: %.3f%%\n", piso[0], piso[1]);
+  conferir(ativasSem == 0 && ativasCom == REPRODUTOR_CONFIGURACOES, "tabela da geometria não aprendida na reprodução");
+  conferir(com[0] < 1.5 * piso[0], "período com a tabela acima do piso do jitter");
+  conferir(com[1] * 10.0 < sem[1], "tabela sem redução de uma ordem de grandeza no M/T");
+}
+
+// Marca de índice da bancada do índice, selecionada antes de cada reprodução.
+static MarcaIndice marcaBancadaIndice = MARCA_NENHUMA;
+
+static void prepararBancadaIndice(sensorOpticoPro& sensor, uint8_t configuracao) {
+  (void)configuracao;
+  sensor.novaMarcaIndice(marcaBancadaIndice);
+}
+
+// Resultado de uma reprodução da bancada do índice (todas as configurações do reprodutor).
+struct ResultadoIndice {
+  double voltasSincronizacao = -1;  // Da primeira borda à primeira configuração sincronizada (-1: nunca).
+  unsigned long sincronizadas = 0;  // Descidas reais com o índice sincronizado.
+  unsigned long divergentes = 0;    // Dessas, com o risco diferente da verdade.
+  unsigned long perdasSincronizacao = 0;
+  unsigned long voltas = 0;         // Voltas contadas pelo estimador do período.
+  unsigned long passagens = 0;      // Passagens reais pelo risco 0 depois da primeira borda.
+};
+
+// Reproduz o disco com a marca de 'parametros' a 1000 RPM por 'segundos'. O risco é conferido nas descidas: a subida só
+// é aplicada quando o nível dura o limiar do filtro, e a descida do mesmo risco é a primeira borda que a encontra aplicada.
+static ResultadoIndice reproduzirIndice(const ParametrosGerador& parametros, double segundos) {
+  const double RPM = 1000;
+  const std::vector<double> tempos = {0, segundos}, rpms = {RPM, RPM};
+  marcaBancadaIndice = (MarcaIndice)parametros.marcaIndice;
+  geradorSinais gerador;
+  reprodutorBordas reprodutor;
+  gerador.configurar(parametros, tempos, rpms);
+  reprodutor.configurar(parametros.numRiscos, 2000, 1000, 1000000, (1 << REPRODUTOR_CONFIGURACOES) - 1);
+  reprodutor.configurarPreparacao(prepararBancadaIndice);
+
+  ResultadoIndice resultado;
+  RegistroArquivoBordas registro;
+  double primeira = -1;
+  uint32_t riscoAnterior = MARCA_RISCO_DESCONHECIDO;
+  bool sincronizadoAntes[REPRODUTOR_CONFIGURACOES] = {};
+  while (gerador.proxima(registro)) {
+    reprodutor.reproduzir(registro);
+    double instante = registro.instante() / 1e6;
+    primeira = primeira < 0 ? instante : primeira;
+    uint32_t risco = registro.marcas & MARCA_RISCO_DESCONHECIDO;
+    if (registro.nivel() == HIGH && risco != MARCA_RISCO_DESCONHECIDO) {
+      resultado.passagens += (riscoAnterior != MARCA_RISCO_DESCONHECIDO && risco <= riscoAnterior) ? 1 : 0;
+      riscoAnterior = risco;
+    }
+    for (uint8_t c = 0; c < REPRODUTOR_CONFIGURACOES; c++) {
+      const sensorOpticoPro* sensor = reprodutor.lerSensor(c);
+      bool sincronizado = sensor->indiceSincronizado();
+      resultado.perdasSincronizacao += (sincronizadoAntes[c] && !sincronizado) ? 1 : 0;
+      sincronizadoAntes[c] = sincronizado;
+      if (sincronizado && resultado.voltasSincronizacao < 0) {
+        resultado.voltasSincronizacao = (instante - primeira) * RPM / 60.0;
+      }
+      if (sincronizado && registro.nivel() == LOW && !(registro.marcas & MARCA_BORDA_ESPURIA)) {
+        resultado.sincronizadas++;
+        resultado.divergentes += sensor->lerIndiceRisco() != (registro.marcas & MARCA_RISCO_DESCONHECIDO) ? 1 : 0;
+      }
+    }
+  }
+  saidaSerial.esvaziar();
+  resultado.voltas = reprodutor.lerSensor(0)->lerVoltas();
+  return resultado;
+}
+
+// Marca de índice na reprodução de um disco de 36 riscos a 1000 RPM com jitter de 2 us, para os dois tipos de marca:
+// partindo de cada um dos riscos sem perdas, o maior número de voltas até a sincronização (a primeira marca é candidata,
+// a seguinte, uma volta depois, confirma; partindo logo antes da marca, ela passa antes de haver intervalos ou níveis
+// de referência e a sincronização leva pouco mais de duas voltas); com pulsos perdidos (1%), as descidas sincronizadas
+// com o risco diferente da verdade e as perdas da sincronização. Nos dois casos, as voltas contadas devem ser exatamente
+// as passagens reais pelo risco 0 depois da primeira borda. O RPM máximo de 2000 mantém o limiar do filtro de nível
+// abaixo do nível baixo curto depois do risco largo (0,2 do passo).
+static void bancadaIndice(int argc, char** argv) {
+  const MarcaIndice marcas[] = { MARCA_RISCO_AUSENTE, MARCA_RISCO_LARGO };
+  const char* const nomes[] = { "risco ausente", "risco largo" };
+  double perda = lerParametro(argc, argv, 0, 0.01);
+  for (uint8_t m = 0; m < 2; m++) {
+    ParametrosGerador parametros;
+    parametros.marcaIndice = (uint8_t)marcas[m];
+    parametros.jitter = 2.0;
+    double maiorSincronizacao = 0;
+    bool todas = true;
+    long maiorDiferenca = 0; // Voltas contadas menos passagens reais pelo risco 0.
+    unsigned exatas = 0;
+    for (uint16_t risco = 0; risco < parametros.numRiscos; risco++) {
+      parametros.riscoInicial = risco;
+      ResultadoIndice resultado = reproduzirIndice(parametros, 0.5);
+      todas = todas && resultado.voltasSincronizacao >= 0 && resultado.divergentes == 0;
+      maiorSincronizacao = fmax(maiorSincronizacao, resultado.voltasSincronizacao);
+      long diferenca = (long)resultado.voltas - (long)resultado.passagens;
+      maiorDiferenca = labs(diferenca) > labs(maiorDiferenca) ? diferenca : maiorDiferenca;
+      exatas += diferenca == 0 ? 1 : 0;
+    }
+
+    parametros.riscoInicial = 13;
+    parametros.probabilidadePerda = perda;
+    ResultadoIndice comPerdas = reproduzirIndice(parametros, 10.0);
+    printf("  %-13s sem perdas: sincronizado em até %.2f voltas partindo de cada risco, voltas exatas em %u de %u "
+           "(maior diferença %+ld); com %.1f%% de perdas: sincronizado em %.2f voltas, risco diferente da verdade em "
+           "%lu de %lu descidas, %lu perdas da sincronização, %lu voltas contadas de %lu\n", nomes[m], maiorSincronizacao,
+           exatas, parametros.numRiscos, maiorDiferenca, perda * 100.0, comPerdas.voltasSincronizacao,
+           comPerdas.divergentes, comPerdas.sincronizadas, comPerdas.perdasSincronizacao, comPerdas.voltas,
+           comPerdas.passagens);
+    conferir(todas, "marca de índice sem perdas não sincronizada ou com o risco diferente da verdade");
+    conferir(maiorSincronizacao <= 2.25, "marca de índice sem perdas sincronizada depois de 2,25 voltas");
+    conferir(comPerdas.voltasSincronizacao >= 0 && comPerdas.divergentes * 100 < comPerdas.sincronizadas,
+             "risco sincronizado diferente da verdade em mais de 1% das descidas com perdas");
+    conferir(maiorDiferenca == 0, "voltas contadas sem perdas diferentes das passagens pelo risco 0");
+    conferir(comPerdas.voltas == comPerdas.passagens, "voltas contadas com perdas diferentes das passagens pelo risco 0");
+  }
+}
+
+struct Bancada {
+  const char* nome;
+  void (*funcao)(int, char**);  // Recebe os parâmetros depois do nome da bancada; as falhas vão para 'falhas'.
+  const char* descricao;
+};
+
+static const Bancada bancadas[] = {
+  {"custoGrupo", bancadaCustoGrupo, "[passagens]  custo por sensor do grupoSensorOpticoPro com 1, 2, 4 e 8 discos simulados"},
+  {"custoPorta", bancadaCustoPorta, "[passagens]  custo por canal da amostragem de 8 canais por pino (digitalRead) e por porta"},
+  {"custoBorda", bancadaCustoBorda, "[pulsos]  custo por borda do cálculo de RPM e ângulo nos estimadores período, M/T e volta"},
+  {"arena", bancadaArena, "  ocupação da arena pela janela de uma volta (reserva, recusa, devolução)"},
+  {"limiar", bancadaLimiar, "  filtro de nível com o limiar calibrado: glitches em várias posições dos níveis alto e baixo"},
+  {"extras", bancadaExtras, "  pulsos espúrios entre 55% e 95% do período com o filtro de nível inativo (períodos e M/T)"},
+  {"perdas", bancadaPerdas, "  reprodução do modelo do disco com 1% dos pulsos perdidos e com 200 glitches/s"},
+  {"precisaoAngulo", bancadaPrecisaoAngulo, "[RPM/s]  ângulo extrapolado entre as bordas contra um disco simulado de 36 riscos a 600 RPM"},
+  {"rastreamento", bancadaRastreamento, "[ruído]  filtro de rastreamento contra médias móveis e na reprodução de uma rampa"},
+  {"parada", bancadaParada, "[RPM/s]  atraso da leitura zero na desaceleração de 1000 RPM até a parada"},
+  {"relogio", bancadaRelogio, "  volta do micros(): RPM na volta do contador, parada depois de horas sem chamadas e nova partida"},
+  {"volta", bancadaVolta, "[erro %]  estimadores com um disco de espaçamento irregular: ondulação e atraso de um degrau"},
+  {"telemetria", bancadaTelemetria, "[pulsos]  bytes e custo por amostra do texto e da telemetria binária, com a decodificação conferida"},
+  {"saida", bancadaSaida, "[mensagens]  fila de saída com um enlace mais lento que a telemetria: descartes e atraso de uma resposta"},
+  {"captura", bancadaCaptura, "[bordas]  bytes e custo por borda da captura a 20 mil bordas/s, decodificação e uso da arena"},
+  {"mt", bancadaMT, "[RMS %]  estimador M/T de 1 a 20000 RPM com as bordas na resolução de 4 us do micros()"},
+  {"geometria", bancadaGeometria, "[graus]  tabela da geometria aprendida na reprodução de um disco excêntrico, com um degrau depois"},
+  {"indice", bancadaIndice, "[perda]  sincronização da marca de índice (ausente e larga) partindo de cada risco e com pulsos perdidos"},
+  {nullptr, nullptr, nullptr}
+};
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    printf("Uso: %s bancada [parâmetros] | todas\n", argv[0]);
+    for (const Bancada* b = bancadas; b->nome != nullptr; b++) {
+      printf("  %s %s\n", b->nome, b->descricao);
+    }
+    return 2;
+  }
+
+  bool todas = strcmp(argv[1], "todas") == 0;
+  bool encontrada = false;
+  for (const Bancada* b = bancadas; b->nome != nullptr; b++) {
+    if (todas || strcmp(argv[1], b->nome) == 0) {
+      printf("%s\n", b->nome);
+      b->funcao(todas ? 0 : argc - 2, argv + 2);
+      saidaSerial.esvaziar();
+      encontrada = true;
+    }
+  }
+  if (!encontrada) {
+    fprintf(stderr, "Bancada desconhecida: %s\n", argv[1]);
+    return 2;
+  }
+  printf(falhas == 0 ? "Conferências corretas.\n" : "%u conferências falharam.\n", falhas);
+  return falhas == 0 ? 0 : 1;
+}
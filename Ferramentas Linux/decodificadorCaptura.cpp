@@ -0,0 +1,182 @@
+/*
+ * decodificadorCaptura.cpp
+ *
+ * Descrição: Decodificador, no Linux, da captura de bordas brutas do
+ * sensorOpticoPro (comando 'captura', capturaBordas.h). Lê os bytes recebidos
+ * da Serial, separa os quadros entre 0x00, confere COBS e CRC, e devolve as
+ * bordas como uma lista de instantes em micros (64 bits, contínuos através da
+ * volta do micros() de 32 bits) com o nível após cada transição.
+ *
+ * Texto das respostas dos comandos e quadros de outros tipos (telemetria
+ * binária) misturados à captura são ignorados; quadros com erro são contados.
+ *
+ * Gravação da Serial:
+ *   stty -F /dev/ttyACM0 1000000 raw -echo
+ *   cat /dev/ttyACM0 > captura.bin      (e, em outro terminal, 'captura 2' no monitor)
+ *
+ * Compilação:
+ *   g++ -O2 -std=c++11 -o decodificadorCaptura decodificadorCaptura.cpp
+ *
+ * Utilização:
+ *   decodificadorCaptura [-b] [-r riscos] [entrada [saída]]   (sem arquivos: entrada padrão e saída padrão)
+ *
+ *   Texto (padrão): uma borda por linha, "instante nível"; lacunas (bordas
+ *                   perdidas na placa ou quadros perdidos) viram linhas "# ...".
+ *   Binário (-b):   arquivo de bordas (arquivoBordas.h), lido pelo reprodutor;
+ *                   -r grava no cabeçalho o número de riscos do disco.
+ *
+ * O resumo (quadros, bordas, lacunas e erros) sai na saída de erros.
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "../Bibliotecas Arduino/sensorOpticoPro/capturaBordas.h" // Formato do quadro e leitura dos registros.
+#include "arquivoBordas.h" // Formato do arquivo de bordas (-b).
+
+// Tamanho e número de quadros não mudam a leitura: qualquer instância da classe serve para os métodos estáticos.
+typedef capturaBordas<254, 2> leitorCaptura;
+
+struct ResumoDecodificacao {
+  unsigned long quadros = 0;
+  unsigned long bordas = 0;
+  unsigned long perdidasPlaca = 0;   // Soma do campo 'perdidas' dos cabeçalhos.
+  unsigned long quadrosPerdidos = 0; // Lacunas na sequência.
+  unsigned long invalidos = 0;       // Trechos entre 0x00 que não são quadros válidos (texto, bytes corrompidos).
+  unsigned long outrosTipos = 0;     // Quadros válidos de outros tipos (telemetria binária).
+  unsigned long capturas = 0;        // Capturas (a sequência recomeça em 0 a cada 'captura 1' ou 'captura 2').
+};
+
+static bool binario = false;
+static FILE* saida = stdout;
+
+static void escreverBorda(uint64_t instante, uint8_t nivel) {
+  if (binario) {
+    RegistroArquivoBordas registro = registroBordas(instante, nivel, NAN, MARCA_RISCO_DESCONHECIDO); // Sem a verdade: captura real.
+    fwrite(&registro, sizeof(registro), 1, saida);
+  } else {
+    fprintf(saida, "%llu %u\n", (unsigned long long)instante, nivel);
+  }
+}
+
+static void escreverLacuna(const char* motivo, unsigned long quantidade) {
+  if (!binario) {
+    fprintf(saida, "# %s: %lu\n", motivo, quantidade);
+  }
+}
+
+int main(int argc, char** argv) {
+  int argumento = 1;
+  uint16_t numRiscos = 0;
+  while (argumento < argc && argv[argumento][0] == '-' && argv[argumento][1] != '\0') {
+    if (strcmp(argv[argumento], "-b") == 0) {
+      binario = true;
+    } else if (strcmp(argv[argumento], "-r") == 0 && argumento + 1 < argc) {
+      numRiscos = (uint16_t)atoi(argv[++argumento]);
+    } else {
+      fprintf(stderr, "Uso: %s [-b] [-r riscos] [entrada [saída]]\n", argv[0]);
+      return 1;
+    }
+    argumento++;
+  }
+  FILE* entrada = stdin;
+  if (argumento < argc && (entrada = fopen(argv[argumento++], "rb")) == nullptr) {
+    perror("entrada");
+    return 1;
+  }
+  if (argumento < argc && (saida = fopen(argv[argumento++], binario ? "wb" : "w")) == nullptr) {
+    perror("saída");
+    return 1;
+  }
+
+  if (binario) {
+    escreverCabecalhoBordas(saida, numRiscos, 0);
+  }
+
+  ResumoDecodificacao resumo;
+  std::vector<uint8_t> trecho;   // Bytes desde o último 0x00.
+  uint64_t ultimoInstante = 0;   // Instante estendido da última borda.
+  bool temInstante = false;
+  int ultimaSequencia = -1;
+  uint8_t quadro[256];
+
+  int valor;
+  while ((valor = fgetc(entrada)) != EOF) {
+    if (valor != 0) {
+      trecho.push_back((uint8_t)valor);
+      continue;
+    }
+    if (trecho.empty()) {
+      continue; // Separador antes do quadro ou 0x00 repetido.
+    }
+    uint8_t conteudo = 0;
+    if (trecho.size() <= 255) {
+      memcpy(quadro, trecho.data(), trecho.size());
+      conteudo = desenquadrarTelemetria(quadro, (uint8_t)trecho.size());
+    }
+    trecho.clear();
+    if (conteudo == 0) {
+      resumo.invalidos++;
+      continue;
+    }
+    if (quadro[0] != QUADRO_CAPTURA) {
+      resumo.outrosTipos++;
+      continue;
+    }
+    CabecalhoCaptura cabecalho;
+    if (!leitorCaptura::lerCabecalho(quadro, conteudo, cabecalho)) {
+      resumo.invalidos++;
+      continue;
+    }
+
+    resumo.quadros++;
+    if (cabecalho.sequencia == 0 && ultimaSequencia != 255) {
+      resumo.capturas++;
+      if (ultimaSequencia >= 0) {
+        escreverLacuna("nova captura", resumo.capturas);
+      }
+    } else if (ultimaSequencia >= 0 && cabecalho.sequencia != (uint8_t)(ultimaSequencia + 1)) {
+      uint8_t perdidos = cabecalho.sequencia - (uint8_t)(ultimaSequencia + 1);
+      resumo.quadrosPerdidos += perdidos;
+      escreverLacuna("quadros perdidos", perdidos);
+    }
+    ultimaSequencia = cabecalho.sequencia;
+    if (cabecalho.perdidas != 0) {
+      resumo.perdidasPlaca += cabecalho.perdidas;
+      escreverLacuna("bordas perdidas na placa", cabecalho.perdidas);
+    }
+
+    // A referência avança em relação à última borda (a diferença sem sinal atravessa a volta do micros()).
+    uint64_t instante = temInstante ? ultimoInstante + (uint32_t)(cabecalho.referencia - (uint32_t)ultimoInstante)
+                                    : cabecalho.referencia;
+    uint32_t delta;
+    uint8_t nivel;
+    while (leitorCaptura::lerRegistro(quadro, conteudo, cabecalho.posicao, delta, nivel)) {
+      instante += delta;
+      escreverBorda(instante, nivel);
+      resumo.bordas++;
+    }
+    ultimoInstante = instante;
+    temInstante = true;
+  }
+  if (!trecho.empty()) {
+    resumo.invalidos++; // Quadro cortado no fim da gravação.
+  }
+
+  fprintf(stderr, "Capturas: %lu, quadros: %lu, bordas: %lu\n", resumo.capturas, resumo.quadros, resumo.bordas);
+  fprintf(stderr, "Lacunas - bordas perdidas na placa: %lu, quadros perdidos: %lu\n", resumo.perdidasPlaca, resumo.quadrosPerdidos);
+  fprintf(stderr, "Ignorados - trechos inválidos ou texto: %lu, quadros de outros tipos: %lu\n", resumo.invalidos, resumo.outrosTipos);
+
+  if (entrada != stdin) {
+    fclose(entrada);
+  }
+  if (saida != stdout) {
+    fclose(saida);
+  }
+  return 0;
+}
@@ -0,0 +1,213 @@
+/*
+ * geradorSinais.cpp
+ *
+ * Descrição: Gerador de sinais do sensor óptico a partir do modelo físico do
+ * Disco Decodificador (geradorSinais.h). As bordas geradas podem ser gravadas
+ * em um arquivo de bordas (arquivoBordas.h, com a verdade), reproduzidas no
+ * próprio processo pela biblioteca sensorOpticoPro (reprodutorBordas.h), sem
+ * arquivo intermediário, ou apenas contadas, para medir a taxa de geração.
+ *
+ * Compilação (nesta pasta):
+ *   g++ -O2 -std=gnu++11 -IarduinoSimulado \
+ *       -I"../Bibliotecas Arduino/sensorOpticoPro" -o geradorSinais geradorSinais.cpp \
+ *       arduinoSimulado/arduinoSimulado.cpp "../Bibliotecas Arduino/sensorOpticoPro/sensorOpticoPro.cpp" \
+ *       "../Bibliotecas Arduino/sensorOpticoPro/saidaAssincrona.cpp"
+ *
+ * Utilização:
+ *   geradorSinais [opções]
+ *     -s perfil      pontos tempo:rpm separados por vírgula (padrão: 0:600,10:600)
+ *                    rampa: 0:0,10:1000   degrau: 0:300,5:300,5:900,10:900   parada: ...,8:500,9:0,12:0
+ *     -r riscos      faixas do disco (padrão: 36; o disco de 72 faixas também existe)
+ *     -c ciclo       fração preta de cada passo (padrão: 0.5)
+ *     -w fração      erro de largura: desvio padrão de cada borda, em frações do passo (padrão: 0)
+ *     -e graus       excentricidade: amplitude do deslocamento das bordas na volta (padrão: 0)
+ *     -v pct:hz      vibração: amplitude relativa (%) e frequência da velocidade (padrão: sem vibração)
+ *     -j micros      jitter: desvio padrão do instante de cada borda (padrão: 0)
+ *     -q micros      resolução do relógio que carimba as bordas (padrão: 1; 4 no micros() do Uno)
+ *     -g taxa        glitches por segundo (padrão: 0)
+ *     -d prob        probabilidade de perda de cada pulso (padrão: 0)
+ *     -x marca       marca de índice: 1 risco ausente, 2 risco largo (padrão: 0, sem marca)
+ *     -k risco       risco sob o sensor no início (padrão: 0)
+ *     -z semente     semente do ruído (padrão: 1)
+ *     -o arquivo     grava as bordas em um arquivo de bordas
+ *     -i             reproduz as bordas na biblioteca, no próprio processo
+ *     -m rpm         com -i: RPM máximo do sensor (padrão: o do perfil, com a vibração)
+ *     -p micros      com -i: período do loop() (padrão: 1000)
+ *     -a segundos    com -i: aquecimento fora da comparação (padrão: 1)
+ *     -l percentual  com -i: falha (código de saída 1) se o RMS relativo passar do limite
+ *   Sem -o nem -i, as bordas são apenas geradas e contadas (taxa de geração).
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "geradorSinais.h"
+#include "reprodutorBordas.h"
+
+#define GERADOR_BLOCO_GRAVACAO 65536 // Registros por fwrite().
+
+// Lê "t:rpm,t:rpm,...". Retorna false se o texto estiver mal formado.
+static bool lerPerfil(const char* texto, std::vector<double>& tempos, std::vector<double>& rpms) {
+  tempos.clear();
+  rpms.clear();
+  const char* posicao = texto;
+  while (*posicao != '\0') {
+    char* fim;
+    double tempo = strtod(posicao, &fim);
+    if (fim == posicao || *fim != ':') {
+      return false;
+    }
+    posicao = fim + 1;
+    double rpm = strtod(posicao, &fim);
+    if (fim == posicao || (*fim != ',' && *fim != '\0')) {
+      return false;
+    }
+    tempos.push_back(tempo);
+    rpms.push_back(rpm);
+    posicao = *fim == ',' ? fim + 1 : fim;
+  }
+  return tempos.size() >= 2;
+}
+
+int main(int argc, char** argv) {
+  ParametrosGerador parametros;
+  const char* perfil = "0:600,10:600";
+  const char* caminho = nullptr;
+  bool reproduzir = false;
+  double rpmMaximo = 0;
+  uint64_t periodoLoop = 1000;
+  double aquecimento = 1.0;
+  double limite = -1;
+  bool valido = true;
+
+  for (int i = 1; i < argc && valido; i++) {
+    bool valor = i + 1 < argc;
+    if (strcmp(argv[i], "-s") == 0 && valor) {
+      perfil = argv[++i];
+    } else if (strcmp(argv[i], "-r") == 0 && valor) {
+      parametros.numRiscos = (uint16_t)atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-c") == 0 && valor) {
+      parametros.cicloTrabalho = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-w") == 0 && valor) {
+      parametros.erroLargura = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-e") == 0 && valor) {
+      parametros.excentricidade = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-v") == 0 && valor) {
+      valido = sscanf(argv[++i], "%lf:%lf", &parametros.vibracaoAmplitude, &parametros.vibracaoFrequencia) == 2;
+      parametros.vibracaoAmplitude /= 100.0;
+    } else if (strcmp(argv[i], "-j") == 0 && valor) {
+      parametros.jitter = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-q") == 0 && valor) {
+      parametros.resolucao = (uint32_t)atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-g") == 0 && valor) {
+      parametros.glitchesPorSegundo = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-d") == 0 && valor) {
+      parametros.probabilidadePerda = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-x") == 0 && valor) {
+      parametros.marcaIndice = (uint8_t)atoi(argv[++i]);
+      valido = parametros.marcaIndice <= GERADOR_MARCA_RISCO_LARGO;
+    } else if (strcmp(argv[i], "-k") == 0 && valor) {
+      parametros.riscoInicial = (uint16_t)atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-z") == 0 && valor) {
+      parametros.semente = strtoull(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "-o") == 0 && valor) {
+      caminho = argv[++i];
+    } else if (strcmp(argv[i], "-i") == 0) {
+      reproduzir = true;
+    } else if (strcmp(argv[i], "-m") == 0 && valor) {
+      rpmMaximo = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-p") == 0 && valor) {
+      periodoLoop = strtoull(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "-a") == 0 && valor) {
+      aquecimento = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-l") == 0 && valor) {
+      limite = atof(argv[++i]);
+    } else {
+      valido = false;
+    }
+  }
+
+  std::vector<double> tempos, rpms;
+  geradorSinais gerador;
+  if (!valido || !lerPerfil(perfil, tempos, rpms) || !gerador.configurar(parametros, tempos, rpms)) {
+    fprintf(stderr, "Uso: %s [-s t:rpm,...] [-r riscos] [-c ciclo] [-w fracao] [-e graus] [-v pct:hz] [-j micros] [-q micros] [-g taxa]\n"
+                    "       [-d prob] [-x marca] [-k risco] [-z semente] [-o arquivo] [-i [-m rpm] [-p micros] [-a segundos] [-l percentual]]\n", argv[0]);
+    return 2;
+  }
+  if (reproduzir && parametros.numRiscos > 255) {
+    fprintf(stderr, "A biblioteca aceita até 255 riscos.\n");
+    return 2;
+  }
+
+  FILE* arquivo = nullptr;
+  if (caminho != nullptr) {
+    arquivo = fopen(caminho, "wb");
+    if (arquivo == nullptr) {
+      fprintf(stderr, "%s: não foi possível criar o arquivo\n", caminho);
+      return 2;
+    }
+    escreverCabecalhoBordas(arquivo, parametros.numRiscos, ARQUIVO_BORDAS_TEM_VERDADE);
+  }
+
+  reprodutorBordas reprodutor;
+  if (reproduzir) {
+    if (rpmMaximo <= 0) {
+      rpmMaximo = ceil(gerador.rpmMaximoPerfil());
+    }
+    rpmMaximo = rpmMaximo < 1 ? 1 : (rpmMaximo > 65535 ? 65535 : rpmMaximo);
+    reprodutor.configurar(parametros.numRiscos, (uint16_t)rpmMaximo, periodoLoop, (uint64_t)(aquecimento * 1e6),
+                          (1 << REPRODUTOR_CONFIGURACOES) - 1);
+  }
+
+  // Gera em blocos: o bloco é gravado e/ou reproduzido antes do próximo.
+  std::vector<RegistroArquivoBordas> bloco(GERADOR_BLOCO_GRAVACAO);
+  unsigned long long bordas = 0, espurias = 0, perdas = 0;
+  clock_t inicio = clock();
+  bool continuar = true;
+  while (continuar) {
+    size_t quantidade = 0;
+    while (quantidade < bloco.size() && (continuar = gerador.proxima(bloco[quantidade]))) {
+      quantidade++;
+    }
+    for (size_t i = 0; i < quantidade; i++) {
+      espurias += (bloco[i].marcas & MARCA_BORDA_ESPURIA) ? 1 : 0;
+      perdas += (bloco[i].marcas & MARCA_PERDA_SEGUINTE) ? 1 : 0;
+    }
+    if (arquivo != nullptr && fwrite(bloco.data(), sizeof(RegistroArquivoBordas), quantidade, arquivo) != quantidade) {
+      fprintf(stderr, "%s: falha na gravação\n", caminho);
+      fclose(arquivo);
+      return 2;
+    }
+    if (reproduzir) {
+      for (size_t i = 0; i < quantidade; i++) {
+        reprodutor.reproduzir(bloco[i]);
+      }
+    }
+    bordas += quantidade;
+  }
+  double segundosCpu = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+  if (arquivo != nullptr && fclose(arquivo) != 0) {
+    fprintf(stderr, "%s: falha na gravação\n", caminho);
+    return 2;
+  }
+
+  printf("Perfil: %s (%.3f s, %u riscos), bordas: %llu (espúrias: %llu, pulsos perdidos: %llu)\n",
+         perfil, gerador.duracaoPerfil(), parametros.numRiscos, bordas, espurias, perdas);
+  printf("CPU: %.3f s (%.0f bordas/s, %.0f milhões de bordas/min)\n", segundosCpu,
+         segundosCpu > 0 ? bordas / segundosCpu : 0.0, segundosCpu > 0 ? bordas / segundosCpu * 60.0 / 1e6 : 0.0);
+
+  if (reproduzir) {
+    reprodutor.concluir();
+    saidaSerial.esvaziar();
+    reprodutor.relatar(stdout);
+    if (limite >= 0 && !reprodutor.dentroDoLimite(limite)) {
+      printf("Falha: RMS relativo acima de %.4f%%.\n", limite);
+      return 1;
+    }
+  }
+  return 0;
+}
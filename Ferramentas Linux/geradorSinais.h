@@ -0,0 +1,333 @@
+/*
+ * geradorSinais.h
+ *
+ * Descrição: Gerador de bordas do sensor óptico a partir de um modelo físico
+ * do Disco Decodificador (36 ou 72 faixas pretas; cada faixa gera um pulso):
+ * o ângulo do disco é a integral exata do perfil de velocidade, e cada borda
+ * acontece no instante em que o ângulo passa pela borda de uma faixa.
+ *
+ * Modelo:
+ *   - Perfil de velocidade: pontos (tempo, RPM) ligados por rampas; dois
+ *     pontos no mesmo tempo formam um degrau; RPM 0 para o disco.
+ *   - Vibração: velocidade multiplicada por (1 + a * sen(2 pi f t)), com a < 1
+ *     (o disco nunca gira para trás).
+ *   - Disco: faixas com ciclo de trabalho (fração preta do passo), erro de
+ *     largura (desvio padrão de cada borda, em frações do passo, fixo por
+ *     disco) e excentricidade (deslocamento senoidal das bordas ao longo da
+ *     volta, em graus). As posições das bordas são calculadas uma vez.
+ *   - Marca de índice (opcional): o último risco da volta falta (a borda
+ *     seguinte à falha é a do risco 0) ou o risco 0 é mais largo (nível alto
+ *     GERADOR_FATOR_MARCA_LARGA vezes o nominal), e o disco pode partir com
+ *     qualquer risco sob o sensor.
+ *   - Sensor: jitter gaussiano dos instantes, glitches (pulsos espúrios de 1 a
+ *     20 µs, processo de Poisson em glitches por segundo, no máximo um entre
+ *     duas bordas reais) e perdas (pulsos inteiros não detectados, com
+ *     probabilidade por pulso).
+ *
+ * O ângulo tem forma fechada em cada rampa (também com a vibração), e o
+ * instante de cada borda é encontrado por Newton protegido por bissecção:
+ * uma a três avaliações por borda, sem passo de integração. Os instantes são
+ * arredondados para micros e, opcionalmente, truncados para a resolução do
+ * relógio que carimba as bordas (4 µs no micros() do Uno a 16 MHz).
+ *
+ * Cada borda sai como um registro de arquivoBordas.h, com o RPM real, o
+ * risco real e as marcas de borda espúria e de perda.
+ *
+ * Não depende do Arduino.h.
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef geradorSinais_h // Guarda de inclusão.
+#define geradorSinais_h
+
+#include <inttypes.h>
+#include <math.h>
+#include <vector>
+#include "arquivoBordas.h" // Registro gerado (instante, nível, verdade e marcas).
+
+#define GERADOR_MAX_RISCOS 4096
+#define GERADOR_FATOR_MARCA_LARGA 1.6 // Nível alto do risco largo da marca de índice, em vezes o nominal.
+#define GERADOR_MARCA_RISCO_AUSENTE 1 // Marcas de índice: os mesmos valores de MarcaIndice (sensorOpticoPro.h).
+#define GERADOR_MARCA_RISCO_LARGO 2
+
+// Parâmetros do disco, do sensor e do ruído.
+struct ParametrosGerador {
+  uint16_t numRiscos = 36;
+  double cicloTrabalho = 0.5;         // Fração preta de cada passo (0 a 1).
+  double erroLargura = 0;             // Desvio padrão da posição de cada borda, em frações do passo.
+  double excentricidade = 0;          // Amplitude do deslocamento das bordas ao longo da volta (graus).
+  double vibracaoAmplitude = 0;       // Amplitude relativa da vibração (0 a 0,99).
+  double vibracaoFrequencia = 0;      // Hz.
+  double jitter = 0;                  // Desvio padrão do instante de cada borda (µs).
+  double glitchesPorSegundo = 0;
+  double probabilidadePerda = 0;      // Probabilidade de um pulso inteiro não ser detectado.
+  uint8_t marcaIndice = 0;            // 0: sem marca; GERADOR_MARCA_RISCO_AUSENTE ou GERADOR_MARCA_RISCO_LARGO.
+  uint16_t riscoInicial = 0;          // Risco sob o sensor no início do perfil (as bordas anteriores não acontecem).
+  uint32_t resolucao = 1;             // Resolução do relógio que carimba as bordas (µs): 4 no micros() do Uno.
+  uint64_t semente = 1;
+};
+
+class geradorSinais
+{
+  private:
+    // Trecho do perfil: velocidade linear b0 + a * tau (voltas/s) a partir de 'inicio' (s).
+    struct Trecho {
+      double inicio, duracao, b0, a, anguloInicial;
+    };
+
+    ParametrosGerador _p;
+    std::vector<Trecho> _trechos;
+    std::vector<double> _bordas;      // Posição de cada borda na volta (frações da volta), em ordem: subida, descida, ...
+    uint64_t _estadoAleatorio;
+    double _w = 0;                    // 2 pi f da vibração.
+    size_t _trecho = 0;
+    double _tau = 0;                  // Instante dentro do trecho atual da última borda real.
+    uint64_t _volta = 0;
+    uint32_t _indiceBorda = 0;        // Próxima borda na volta (0 a 2 * numRiscos - 1).
+    uint8_t _nivel = 0;               // Nível após a última borda emitida.
+    double _proximoGlitch = 0;        // Instante (s) do próximo glitch.
+    bool _perdendoPulso = false;      // O pulso atual não foi detectado (suas duas bordas somem).
+    bool _terminado = false;
+
+    // Pendências: a borda anterior só sai quando se sabe se a seguinte foi perdida; o glitch sai em duas bordas.
+    RegistroArquivoBordas _pendente;
+    bool _temPendente = false;
+    RegistroArquivoBordas _fila[3];
+    uint8_t _filaInicio = 0, _filaTamanho = 0;
+
+    uint64_t aleatorio() { // xorshift64*: rápido e suficiente para ruído.
+      _estadoAleatorio ^= _estadoAleatorio >> 12;
+      _estadoAleatorio ^= _estadoAleatorio << 25;
+      _estadoAleatorio ^= _estadoAleatorio >> 27;
+      return _estadoAleatorio * 0x2545F4914F6CDD1DULL;
+    }
+    double uniforme() { return (aleatorio() >> 11) * (1.0 / 9007199254740992.0); }
+    double gaussiano() {
+      double u = uniforme();
+      return sqrt(-2.0 * log(u > 0 ? u : 1e-300)) * cos(2.0 * M_PI * uniforme());
+    }
+    double exponencial(double taxa) { return -log(1.0 - uniforme()) / taxa; }
+
+    double velocidade(const Trecho& t, double tau) const { // Voltas/s.
+      double base = t.b0 + t.a * tau;
+      return _p.vibracaoAmplitude != 0 ? base * (1.0 + _p.vibracaoAmplitude * sin(_w * (t.inicio + tau))) : base;
+    }
+
+    double angulo(const Trecho& t, double tau) const { // Voltas desde o início do perfil.
+      double theta = t.anguloInicial + t.b0 * tau + 0.5 * t.a * tau * tau;
+      if (_p.vibracaoAmplitude != 0) {
+        double x0 = _w * t.inicio;
+        double x = x0 + _w * tau;
+        double base = t.b0 + t.a * tau;
+        theta += _p.vibracaoAmplitude * (-(base * cos(x) - t.b0 * cos(x0)) / _w + t.a * (sin(x) - sin(x0)) / (_w * _w));
+      }
+      return theta;
+    }
+
+    // Instante (s) em que o disco atinge o ângulo 'alvo' (voltas). Retorna false se o perfil acabar antes.
+    bool resolver(double alvo, double& instante) {
+      while (_trecho < _trechos.size() && angulo(_trechos[_trecho], _trechos[_trecho].duracao) < alvo) {
+        _trecho++;
+        _tau = 0;
+      }
+      if (_trecho >= _trechos.size()) {
+        return false;
+      }
+      const Trecho& t = _trechos[_trecho];
+      double baixo = _tau, alto = t.duracao;
+      double v = velocidade(t, _tau);
+      double tau = v > 0 ? _tau + (alvo - angulo(t, _tau)) / v : 0.5 * (baixo + alto);
+      for (int i = 0; i < 60; i++) {
+        if (!(tau > baixo && tau < alto)) {
+          tau = 0.5 * (baixo + alto); // Newton saiu do intervalo: bissecção.
+        }
+        double erro = angulo(t, tau) - alvo;
+        if (erro < 0) baixo = tau; else alto = tau;
+        v = velocidade(t, tau);
+        if (fabs(erro) < 1e-13 * (1.0 + fabs(alvo)) || alto - baixo < 1e-11) {
+          break;
+        }
+        tau = v > 0 ? tau - erro / v : 0.5 * (baixo + alto);
+      }
+      _tau = tau;
+      instante = t.inicio + tau;
+      return true;
+    }
+
+    void enfileirar(const RegistroArquivoBordas& registro) {
+      _fila[(_filaInicio + _filaTamanho) % 3] = registro;
+      _filaTamanho++;
+    }
+
+    // Emite uma borda (real ou espúria) depois da pendente, mantendo os instantes em ordem.
+    void emitir(uint64_t instante, uint8_t nivel, float rpm, uint32_t marcas) {
+      if (_temPendente) {
+        if (instante < _pendente.instante()) {
+          instante = _pendente.instante(); // O jitter não inverte a ordem das bordas.
+        }
+        enfileirar(_pendente);
+      }
+      _pendente = registroBordas(instante, nivel, rpm, marcas);
+      _temPendente = true;
+      _nivel = nivel;
+    }
+
+    // Carimba um instante (µs) com a resolução do relógio.
+    uint64_t carimbar(double micros) const {
+      uint64_t instante = micros > 0 ? (uint64_t)llround(micros) : 0;
+      return instante / _p.resolucao * _p.resolucao;
+    }
+
+    // Gera a próxima borda real (e os glitches antes dela). Retorna false no fim do perfil.
+    bool gerarBordaReal() {
+      uint32_t bordasPorVolta = 2u * _p.numRiscos;
+      double alvo = _volta + _bordas[_indiceBorda];
+      double instante;
+      if (!resolver(alvo, instante)) {
+        return false;
+      }
+      uint8_t nivel = (_indiceBorda & 1) ? LOW_GERADOR : HIGH_GERADOR;
+      uint32_t risco = _indiceBorda / 2;
+      bool ausente = _p.marcaIndice == GERADOR_MARCA_RISCO_AUSENTE && risco == _p.numRiscos - 1u; // Falha da marca.
+      float rpm = (float)(velocidade(_trechos[_trecho], _tau) * 60.0);
+
+      if (nivel == HIGH_GERADOR) { // Início de um pulso: decide se ele será detectado.
+        _perdendoPulso = _p.probabilidadePerda > 0 && uniforme() < _p.probabilidadePerda;
+        if (_perdendoPulso && _temPendente) {
+          _pendente.marcas |= MARCA_PERDA_SEGUINTE;
+        }
+      }
+
+      // Glitch antes desta borda: um pulso curto no nível oposto ao atual. No máximo um por intervalo entre bordas
+      // reais (os demais sorteados no mesmo intervalo são descartados), o que limita a fila a três registros.
+      bool glitchEmitido = false;
+      while (_p.glitchesPorSegundo > 0 && _proximoGlitch < instante) {
+        double largura = (1.0 + 19.0 * uniforme()) * 1e-6;
+        if (!glitchEmitido && _proximoGlitch + largura < instante) {
+          glitchEmitido = true;
+          uint64_t inicio = carimbar(_proximoGlitch * 1e6);
+          float rpmGlitch = (float)(velocidade(_trechos[_trecho], _tau) * 60.0);
+          uint8_t nivelAtual = _nivel;
+          emitir(inicio, !nivelAtual, rpmGlitch, MARCA_BORDA_ESPURIA | MARCA_RISCO_DESCONHECIDO);
+          emitir(carimbar((_proximoGlitch + largura) * 1e6), nivelAtual, rpmGlitch, MARCA_BORDA_ESPURIA | MARCA_RISCO_DESCONHECIDO);
+        }
+        _proximoGlitch += exponencial(_p.glitchesPorSegundo);
+      }
+
+      if (!_perdendoPulso && !ausente) {
+        double comJitter = instante * 1e6 + (_p.jitter > 0 ? _p.jitter * gaussiano() : 0);
+        emitir(carimbar(comJitter), nivel, rpm, risco);
+      }
+
+      if (++_indiceBorda >= bordasPorVolta) {
+        _indiceBorda = 0;
+        _volta++;
+      }
+      return true;
+    }
+
+  public:
+    static const uint8_t HIGH_GERADOR = 1;
+    static const uint8_t LOW_GERADOR = 0;
+
+    // Configura o disco e o perfil (tempos em s, velocidades em RPM). Retorna false se os parâmetros forem inválidos.
+    bool configurar(const ParametrosGerador& parametros, const std::vector<double>& tempos, const std::vector<double>& rpms) {
+      _p = parametros;
+      if (_p.numRiscos == 0 || _p.numRiscos > GERADOR_MAX_RISCOS || _p.cicloTrabalho <= 0 || _p.cicloTrabalho >= 1
+          || _p.vibracaoAmplitude < 0 || _p.vibracaoAmplitude >= 1 || _p.resolucao == 0 || tempos.size() < 2
+          || tempos.size() != rpms.size() || _p.riscoInicial >= _p.numRiscos || (_p.marcaIndice != 0 && _p.numRiscos < 2)) {
+        return false;
+      }
+      _estadoAleatorio = _p.semente ? _p.semente : 1;
+      _w = 2.0 * M_PI * _p.vibracaoFrequencia;
+      if (_w == 0) {
+        _p.vibracaoAmplitude = 0;
+      }
+
+      // Perfil: trechos lineares com o ângulo acumulado no início de cada um.
+      _trechos.clear();
+      double anguloAcumulado = 0;
+      for (size_t i = 0; i + 1 < tempos.size(); i++) {
+        if (tempos[i + 1] < tempos[i] || rpms[i] < 0 || rpms[i + 1] < 0) {
+          return false;
+        }
+        Trecho t;
+        t.inicio = tempos[i];
+        t.duracao = tempos[i + 1] - tempos[i];
+        t.b0 = rpms[i] / 60.0;
+        t.a = t.duracao > 0 ? (rpms[i + 1] - rpms[i]) / 60.0 / t.duracao : 0;
+        t.anguloInicial = anguloAcumulado;
+        if (t.duracao > 0) { // Degraus (duração zero) não ocupam trecho.
+          anguloAcumulado = angulo(t, t.duracao);
+          _trechos.push_back(t);
+        }
+      }
+
+      // Disco: bordas nominais, erro de largura fixo por disco e excentricidade (uma senoide por volta).
+      double passo = 1.0 / _p.numRiscos;
+      double fase = 2.0 * M_PI * uniforme();
+      double limite = 0.45 * passo * (_p.cicloTrabalho < 0.5 ? _p.cicloTrabalho : 1.0 - _p.cicloTrabalho); // As bordas não se cruzam.
+      _bordas.resize(2u * _p.numRiscos);
+      for (uint32_t i = 0; i < 2u * _p.numRiscos; i++) {
+        double nominal = (i / 2) * passo + ((i & 1) ? _p.cicloTrabalho * passo : 0);
+        double desvio = _p.erroLargura * passo * gaussiano();
+        desvio += _p.excentricidade / 360.0 * sin(2.0 * M_PI * nominal + fase);
+        _bordas[i] = nominal + (desvio > limite ? limite : (desvio < -limite ? -limite : desvio));
+      }
+      _bordas[0] = _bordas[0] < 0 ? 0 : _bordas[0]; // A volta começa na primeira borda.
+      if (_p.marcaIndice == GERADOR_MARCA_RISCO_LARGO) { // Descida do risco 0 adiada, sem alcançar a subida do risco 1.
+        double larga = _bordas[0] + GERADOR_FATOR_MARCA_LARGA * (_bordas[1] - _bordas[0]);
+        _bordas[1] = larga < _bordas[2] - 0.05 * passo ? larga : _bordas[2] - 0.05 * passo;
+      }
+
+      _trecho = 0;
+      _tau = 0;
+      _volta = 0;
+      _indiceBorda = 2u * _p.riscoInicial;
+      _nivel = LOW_GERADOR;
+      _temPendente = false;
+      _filaInicio = 0;
+      _filaTamanho = 0;
+      _terminado = false;
+      _proximoGlitch = _p.glitchesPorSegundo > 0 ? exponencial(_p.glitchesPorSegundo) : 0;
+      return true;
+    }
+
+    // Próxima borda do sinal. Retorna false quando o perfil termina.
+    bool proxima(RegistroArquivoBordas& registro) {
+      while (_filaTamanho == 0) {
+        if (_terminado || !gerarBordaReal()) {
+          if (!_terminado) {
+            _terminado = true;
+            if (_temPendente) {
+              enfileirar(_pendente);
+              _temPendente = false;
+            }
+          }
+          if (_filaTamanho == 0) {
+            return false;
+          }
+        }
+      }
+      registro = _fila[_filaInicio];
+      _filaInicio = (_filaInicio + 1) % 3;
+      _filaTamanho--;
+      return true;
+    }
+
+    double duracaoPerfil() const { return _trechos.empty() ? 0 : _trechos.back().inicio + _trechos.back().duracao; }
+    double rpmMaximoPerfil() const {
+      double maior = 0;
+      for (const Trecho& t : _trechos) {
+        double fim = (t.b0 + t.a * t.duracao) * 60.0;
+        maior = t.b0 * 60.0 > maior ? t.b0 * 60.0 : maior;
+        maior = fim > maior ? fim : maior;
+      }
+      return maior * (1.0 + _p.vibracaoAmplitude);
+    }
+};
+
+#endif // geradorSinais_h
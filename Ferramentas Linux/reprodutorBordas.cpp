@@ -0,0 +1,127 @@
+/*
+ * reprodutorBordas.cpp
+ *
+ * Descrição: Reprodução determinística de um arquivo de bordas
+ * (arquivoBordas.h) pela biblioteca sensorOpticoPro, no Linux e mais rápido
+ * que o tempo real. O arquivo é mapeado em memória e percorrido uma vez; todos
+ * os estimadores escolhidos recebem as mesmas bordas na mesma passagem e são
+ * comparados com o RPM verdadeiro do arquivo (reprodutorBordas.h).
+ *
+ * Arquivos gravados na placa (decodificadorCaptura -b) não têm a verdade: a
+ * reprodução mede apenas a velocidade e serve para repetir um problema visto
+ * na bancada. Traços sintéticos (geradorSinais -o), com o RPM real de cada
+ * borda, têm; o geradorSinais -i também reproduz sem arquivo intermediário.
+ *
+ * Compilação (nesta pasta):
+ *   g++ -O2 -std=gnu++11 -IarduinoSimulado \
+ *       -I"../Bibliotecas Arduino/sensorOpticoPro" -o reprodutorBordas reprodutorBordas.cpp \
+ *       arduinoSimulado/arduinoSimulado.cpp "../Bibliotecas Arduino/sensorOpticoPro/sensorOpticoPro.cpp" \
+ *       "../Bibliotecas Arduino/sensorOpticoPro/saidaAssincrona.cpp"
+ *
+ * Utilização:
+ *   reprodutorBordas [opções] arquivo
+ *     -r riscos      riscos do disco (padrão: o do cabeçalho, ou 36)
+ *     -m rpm         RPM máximo configurado no sensor (padrão: 1000)
+ *     -p micros      período do loop() entre bordas espaçadas (padrão: 1000; 0: só nas bordas)
+ *     -a segundos    aquecimento fora da comparação (padrão: 1)
+ *     -e lista       configurações separadas por vírgula (padrão: periodo,mt,volta,rastreamento)
+ *     -l percentual  falha (código de saída 1) se o RMS relativo de alguma configuração passar do limite
+ *     -v             mostra a saída da Serial da biblioteca na saída de erros
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "reprodutorBordas.h"
+
+// Bits das configurações a partir da lista "periodo,mt,...". Retorna 0 se algum nome for desconhecido.
+static uint8_t lerConfiguracoes(const char* lista) {
+  uint8_t configuracoes = 0;
+  char copia[128];
+  strncpy(copia, lista, sizeof(copia) - 1);
+  copia[sizeof(copia) - 1] = '\0';
+  for (char* nome = strtok(copia, ","); nome != nullptr; nome = strtok(nullptr, ",")) {
+    uint8_t c = 0;
+    while (c < REPRODUTOR_CONFIGURACOES && strcmp(nome, nomesConfiguracoesReprodutor[c]) != 0) {
+      c++;
+    }
+    if (c == REPRODUTOR_CONFIGURACOES) {
+      return 0;
+    }
+    configuracoes |= 1 << c;
+  }
+  return configuracoes;
+}
+
+int main(int argc, char** argv) {
+  uint16_t numRiscos = 0;
+  uint16_t rpmMaximo = 1000;
+  uint64_t periodoLoop = 1000;
+  double aquecimento = 1.0;
+  uint8_t configuracoes = (1 << REPRODUTOR_CONFIGURACOES) - 1;
+  double limite = -1;
+  const char* caminho = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    bool valor = i + 1 < argc;
+    if (strcmp(argv[i], "-r") == 0 && valor) {
+      numRiscos = (uint16_t)atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-m") == 0 && valor) {
+      rpmMaximo = (uint16_t)atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-p") == 0 && valor) {
+      periodoLoop = strtoull(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "-a") == 0 && valor) {
+      aquecimento = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-e") == 0 && valor) {
+      configuracoes = lerConfiguracoes(argv[++i]);
+    } else if (strcmp(argv[i], "-l") == 0 && valor) {
+      limite = atof(argv[++i]);
+    } else if (strcmp(argv[i], "-v") == 0) {
+      Serial.configurarDestino(stderr);
+    } else if (argv[i][0] != '-' && caminho == nullptr) {
+      caminho = argv[i];
+    } else {
+      caminho = nullptr;
+      break;
+    }
+  }
+  if (caminho == nullptr || configuracoes == 0) {
+    fprintf(stderr, "Uso: %s [-r riscos] [-m rpm] [-p micros] [-a segundos] [-e periodo,mt,volta,rastreamento] [-l percentual] [-v] arquivo\n", argv[0]);
+    return 2;
+  }
+
+  arquivoBordasMapeado arquivo;
+  const char* erro = nullptr;
+  if (!arquivo.abrir(caminho, erro)) {
+    fprintf(stderr, "%s: %s\n", caminho, erro);
+    return 2;
+  }
+  if (numRiscos == 0) {
+    numRiscos = arquivo.cabecalho->numRiscos != 0 ? arquivo.cabecalho->numRiscos : 36;
+  }
+  if (numRiscos > 255) {
+    fprintf(stderr, "A biblioteca aceita até 255 riscos.\n");
+    return 2;
+  }
+
+  reprodutorBordas reprodutor;
+  reprodutor.configurar(numRiscos, rpmMaximo, periodoLoop, (uint64_t)(aquecimento * 1e6), configuracoes);
+  for (size_t i = 0; i < arquivo.numRegistros; i++) {
+    reprodutor.reproduzir(arquivo.registros[i]);
+  }
+  reprodutor.concluir();
+  saidaSerial.esvaziar(); // Mensagens da biblioteca ainda na fila (com -v).
+
+  printf("Arquivo: %s (%u riscos%s)\n", caminho, numRiscos,
+         (arquivo.cabecalho->indicadores & ARQUIVO_BORDAS_TEM_VERDADE) ? "" : ", sem a verdade: apenas velocidade");
+  reprodutor.relatar(stdout);
+
+  if (limite >= 0 && !reprodutor.dentroDoLimite(limite)) {
+    printf("Falha: RMS relativo acima de %.4f%%.\n", limite);
+    return 1;
+  }
+  return 0;
+}
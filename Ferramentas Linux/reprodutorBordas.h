@@ -0,0 +1,220 @@
+/*
+ * reprodutorBordas.h
+ *
+ * Descrição: Motor de reprodução de bordas: alimenta instâncias do
+ * sensorOpticoPro com bordas (de um arquivo ou geradas no próprio processo)
+ * pelo pino e pelo relógio simulados (arduinoSimulado), sem hardware, e
+ * compara o RPM de cada estimador com a verdade registrada em cada borda.
+ *
+ * Cada borda define o relógio e o nível do pino e chama calcularRPM() de
+ * todas as instâncias, como um loop() mais rápido que as bordas (nenhuma borda
+ * é perdida pela varredura). Entre bordas mais espaçadas que o período do
+ * loop, o calcularRPM() também é chamado a cada período, para que o
+ * decaimento e a parada aconteçam como na placa.
+ *
+ * A comparação é feita nas bordas de subida reais (não espúrias) com RPM
+ * verdadeiro conhecido, depois do aquecimento (calibração do limiar e
+ * primeira janela de medição): erro médio, erro absoluto médio, RMS, maior
+ * erro e RMS relativo à verdade.
+ *
+ * Configurações reproduzidas (uma instância cada, todas na mesma passagem):
+ *   periodo, mt, volta        os estimadores de calcularRPM()
+ *   rastreamento              M/T com o filtro de rastreamento ligado
+ *
+ * Uma função de preparação opcional ajusta cada instância logo depois de
+ * criada (tempo de parada, marca de índice, aprendizado da geometria), e
+ * lerSensor() dá acesso às instâncias durante a reprodução, para conferir
+ * mais que o RPM (risco, ângulo, estado da geometria).
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#ifndef reprodutorBordas_h // Guarda de inclusão.
+#define reprodutorBordas_h
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+#include "Arduino.h"          // Arduino simulado: relógio e pino controlados pelo reprodutor.
+#include "sensorOpticoPro.h"  // Biblioteca reproduzida.
+#include "arquivoBordas.h"    // Registro de borda com a verdade.
+
+#define REPRODUTOR_PINO 2            // Pino simulado do sensor (interrupção externa 0 no Uno).
+#define REPRODUTOR_CONFIGURACOES 4
+
+static const char* const nomesConfiguracoesReprodutor[REPRODUTOR_CONFIGURACOES] = { "periodo", "mt", "volta", "rastreamento" };
+
+typedef void (*PreparacaoReprodutor)(sensorOpticoPro& sensor, uint8_t configuracao); // Ajusta uma instância recém-criada.
+
+// Erros acumulados de uma configuração.
+struct ErrosReproducao {
+  unsigned long long comparacoes = 0;
+  unsigned long long comparacoesRelativas = 0; // Comparações com verdade acima de 1 RPM (entram no RMS relativo).
+  double soma = 0;             // Soma dos erros (viés).
+  double somaAbsoluta = 0;
+  double somaQuadrados = 0;
+  double somaQuadradosRelativos = 0;
+  double maior = 0;            // Maior erro absoluto.
+
+  void registrar(double medido, double verdade) {
+    double erro = medido - verdade;
+    comparacoes++;
+    soma += erro;
+    somaAbsoluta += fabs(erro);
+    somaQuadrados += erro * erro;
+    if (fabs(erro) > maior) {
+      maior = fabs(erro);
+    }
+    if (verdade > 1.0) {
+      comparacoesRelativas++;
+      somaQuadradosRelativos += (erro / verdade) * (erro / verdade);
+    }
+  }
+
+  double media() const { return comparacoes ? soma / comparacoes : 0; }
+  double mediaAbsoluta() const { return comparacoes ? somaAbsoluta / comparacoes : 0; }
+  double rms() const { return comparacoes ? sqrt(somaQuadrados / comparacoes) : 0; }
+  double rmsRelativoPercentual() const { return comparacoesRelativas ? 100.0 * sqrt(somaQuadradosRelativos / comparacoesRelativas) : 0; }
+};
+
+class reprodutorBordas
+{
+  private:
+    sensorOpticoPro* _sensores[REPRODUTOR_CONFIGURACOES] = {};
+    ErrosReproducao _erros[REPRODUTOR_CONFIGURACOES];
+    uint8_t _configuracoes = 0;       // Bits das configurações ativas.
+    PreparacaoReprodutor _preparar = nullptr;
+    uint16_t _numRiscos = 36;
+    uint16_t _rpmMaximo = 1000;
+    uint64_t _periodoLoop = 1000;     // Micros entre chamadas de calcularRPM() sem bordas (0: somente nas bordas).
+    uint64_t _aquecimento = 1000000;  // Micros iniciais fora da comparação.
+    uint64_t _instanteInicial = 0;
+    uint64_t _ultimoInstante = 0;
+    uint64_t _bordas = 0;
+    bool _iniciado = false;
+    clock_t _inicioCpu = 0;
+    double _segundosCpu = 0;
+
+    void chamarLoop() {
+      for (uint8_t c = 0; c < REPRODUTOR_CONFIGURACOES; c++) {
+        if (_sensores[c] != nullptr) {
+          _sensores[c]->calcularRPM();
+        }
+      }
+    }
+
+    void iniciarSensores(uint64_t instante, uint8_t nivelInicial) {
+      definirMicrosSimulado(instante);
+      definirPinoSimulado(REPRODUTOR_PINO, nivelInicial);
+      for (uint8_t c = 0; c < REPRODUTOR_CONFIGURACOES; c++) {
+        if (!(_configuracoes & (1 << c))) {
+          continue;
+        }
+        sensorOpticoPro* sensor = new sensorOpticoPro(REPRODUTOR_PINO);
+        sensor->iniciar();
+        sensor->configurarParametrosSensorOptico((uint8_t)_numRiscos, _rpmMaximo);
+        sensor->configurarTelemetria(TELEMETRIA_DESLIGADA);
+        sensor->novoEstimadorRPM(c == 0 ? ESTIMADOR_PERIODO : (c == 2 ? ESTIMADOR_VOLTA : ESTIMADOR_MT));
+        sensor->ativarFiltroRastreamento(c == 3);
+        if (_preparar != nullptr) {
+          _preparar(*sensor, c);
+        }
+        _sensores[c] = sensor;
+      }
+      _instanteInicial = instante;
+      _ultimoInstante = instante;
+      _iniciado = true;
+      _inicioCpu = clock();
+    }
+
+  public:
+    ~reprodutorBordas() {
+      for (uint8_t c = 0; c < REPRODUTOR_CONFIGURACOES; c++) {
+        delete _sensores[c];
+      }
+    }
+
+    // Parâmetros do disco e da reprodução; chamar antes da primeira borda. 'configuracoes': bits de nomesConfiguracoesReprodutor.
+    void configurar(uint16_t numRiscos, uint16_t rpmMaximo, uint64_t periodoLoop, uint64_t aquecimento, uint8_t configuracoes) {
+      _numRiscos = numRiscos;
+      _rpmMaximo = rpmMaximo;
+      _periodoLoop = periodoLoop;
+      _aquecimento = aquecimento;
+      _configuracoes = configuracoes;
+    }
+
+    // Função chamada para cada instância logo depois de criada (nullptr: nenhuma); chamar antes da primeira borda.
+    void configurarPreparacao(PreparacaoReprodutor preparar) {
+      _preparar = preparar;
+    }
+
+    // Reproduz uma borda: avança o relógio (com as passagens do loop sem bordas), muda o pino e compara as medições.
+    void reproduzir(const RegistroArquivoBordas& registro) {
+      uint64_t instante = registro.instante();
+      uint8_t nivel = registro.nivel();
+      if (!_iniciado) {
+        iniciarSensores(instante, !nivel); // O pino estava no nível oposto antes da primeira borda.
+      }
+      if (_periodoLoop != 0) {
+        for (uint64_t passagem = _ultimoInstante + _periodoLoop; passagem < instante; passagem += _periodoLoop) {
+          definirMicrosSimulado(passagem);
+          chamarLoop();
+        }
+      }
+      _ultimoInstante = instante;
+      _bordas++;
+      definirMicrosSimulado(instante);
+      definirPinoSimulado(REPRODUTOR_PINO, nivel);
+
+      bool comparar = nivel == HIGH && registro.temVerdade() && !(registro.marcas & MARCA_BORDA_ESPURIA)
+                      && instante - _instanteInicial >= _aquecimento;
+      for (uint8_t c = 0; c < REPRODUTOR_CONFIGURACOES; c++) {
+        if (_sensores[c] != nullptr) {
+          float rpm = _sensores[c]->calcularRPM();
+          if (comparar) {
+            _erros[c].registrar(rpm, registro.rpmVerdadeiro);
+          }
+        }
+      }
+    }
+
+    // Encerra a contagem do tempo de CPU.
+    void concluir() {
+      _segundosCpu = (double)(clock() - _inicioCpu) / CLOCKS_PER_SEC;
+    }
+
+    // Tabela com os erros de cada configuração e a velocidade da reprodução.
+    void relatar(FILE* destino) const {
+      double segundosTraco = (_ultimoInstante - _instanteInicial) / 1e6;
+      fprintf(destino, "Bordas: %llu, traço: %.3f s, CPU: %.3f s (%.0f bordas/s, %.0fx o tempo real)\n",
+              (unsigned long long)_bordas, segundosTraco, _segundosCpu,
+              _segundosCpu > 0 ? _bordas / _segundosCpu : 0.0, _segundosCpu > 0 ? segundosTraco / _segundosCpu : 0.0);
+      fprintf(destino, "%-13s %12s %12s %12s %12s %12s %10s\n", "estimador", "comparacoes", "vies", "erro medio", "RMS", "maior", "RMS %");
+      for (uint8_t c = 0; c < REPRODUTOR_CONFIGURACOES; c++) {
+        if (_sensores[c] == nullptr) {
+          continue;
+        }
+        const ErrosReproducao& e = _erros[c];
+        fprintf(destino, "%-13s %12llu %12.4f %12.4f %12.4f %12.4f %10.4f\n", nomesConfiguracoesReprodutor[c],
+                e.comparacoes, e.media(), e.mediaAbsoluta(), e.rms(), e.maior, e.rmsRelativoPercentual());
+      }
+    }
+
+    // true se o RMS relativo de todas as configurações ficou abaixo do limite (percentual), para uso em CI.
+    bool dentroDoLimite(double limitePercentual) const {
+      for (uint8_t c = 0; c < REPRODUTOR_CONFIGURACOES; c++) {
+        if (_sensores[c] != nullptr && _erros[c].rmsRelativoPercentual() > limitePercentual) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    const ErrosReproducao& lerErros(uint8_t configuracao) const { return _erros[configuracao]; }
+    uint64_t lerBordas() const { return _bordas; }
+    const sensorOpticoPro* lerSensor(uint8_t configuracao) const { return _sensores[configuracao]; } // nullptr antes da primeira borda.
+};
+
+#endif // reprodutorBordas_h
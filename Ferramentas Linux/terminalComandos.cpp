@@ -0,0 +1,52 @@
+/*
+ * terminalComandos.cpp
+ *
+ * Descrição: Terminal de comandos no Linux: cada linha da entrada padrão é
+ * analisada e despachada pela tabela de comandos do gerenciadorComandos, como
+ * o loop() do sketch faz com a Serial, para um sensorOpticoPro no pino
+ * simulado 2. A saída da biblioteca (fila da Serial) vai para a saída padrão.
+ *
+ * Serve para conferir respostas e textos dos comandos sem a placa e garante
+ * que a biblioteca inteira, com a camada de comandos, compila no Linux.
+ *
+ * Compilação (nesta pasta):
+ *   g++ -O2 -std=gnu++11 -IarduinoSimulado \
+ *       -I"../Bibliotecas Arduino/sensorOpticoPro" -I"../Bibliotecas Arduino/gerenciadorComandos" \
+ *       -o terminalComandos terminalComandos.cpp arduinoSimulado/arduinoSimulado.cpp \
+ *       "../Bibliotecas Arduino/sensorOpticoPro/sensorOpticoPro.cpp" \
+ *       "../Bibliotecas Arduino/sensorOpticoPro/saidaAssincrona.cpp" \
+ *       "../Bibliotecas Arduino/gerenciadorComandos/gerenciadorComandos.cpp"
+ *
+ * Utilização:
+ *   echo "estimadorRPM 1" | terminalComandos
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#include "Arduino.h"
+#include "sensorOpticoPro.h"
+#include "gerenciadorComandos.h"
+
+#define TERMINAL_PINO_SENSOR 2      // Pinos do sketch (gerenciadorSensorOpticoPro.ino).
+#define TERMINAL_PINO_LIGAR_MOTOR 3
+#define TERMINAL_PINO_SENTIDO_GIRO 4
+
+int main() {
+  Serial.configurarDestino(stdout);
+  sensorOpticoPro sensor(TERMINAL_PINO_SENSOR);
+  gerenciadorComandos gerenciador(TERMINAL_PINO_LIGAR_MOTOR, TERMINAL_PINO_SENTIDO_GIRO);
+  gerenciador.iniciar();
+  sensor.iniciar();
+
+  char linha[90]; // Mesmo tamanho do buffer de comandos do sketch.
+  while (fgets(linha, sizeof(linha), stdin) != nullptr) {
+    Comando comando = gerenciador.analisarComando(String(linha));
+    if (comando.nome.length() > 0) {
+      gerenciador.processarComando(comando, sensor);
+    }
+    saidaSerial.esvaziar();
+  }
+  return 0;
+}
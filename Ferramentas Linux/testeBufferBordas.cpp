@@ -0,0 +1,220 @@
+/*
+ * testeBufferBordas.cpp
+ *
+ * Descrição: Teste da fila de bordas (bufferBordas.h) no Linux, com o
+ * produtor alimentado por uma fonte de bordas simulada (instantes crescentes
+ * e níveis alternados, como a rotina de interrupção do sensor). Verifica:
+ *
+ *   - ordem e conteúdo dos registros através de muitas voltas dos índices de
+ *     8 bits (capacidades 2, 8 e 128);
+ *   - fila cheia: capacidadeUtil() inserções aceitas e as seguintes recusadas;
+ *   - contador de transbordos, ocupação máxima, zerarContadores() e
+ *     esvaziar();
+ *   - produtor em outra thread (como a interrupção) contra o consumidor em
+ *     lotes: nenhuma borda duplicada, fora de ordem ou perdida sem contar
+ *     como transbordo.
+ *
+ * A fila não depende do Arduino.h: o teste usa apenas a biblioteca padrão.
+ *
+ * Compilação (nesta pasta):
+ *   g++ -O2 -std=gnu++11 -pthread -I"../Bibliotecas Arduino/sensorOpticoPro" \
+ *       -o testeBufferBordas testeBufferBordas.cpp
+ *
+ * Utilização:
+ *   testeBufferBordas     (código de saída 1 se alguma verificação falhar)
+ *
+ * Autor: Tiago Carvalho Pontes
+ * Data: 12/12/2024
+ * Versão: 1.0
+ */
+
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include "bufferBordas.h"
+
+static unsigned falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+  if (!condicao) {
+    printf("Falha: %s\n", descricao);
+    falhas++;
+  }
+}
+
+// Fonte de bordas simulada: período com uma pequena variação e níveis alternados.
+struct FonteBordas {
+  unsigned long instante = 0;
+  unsigned long indice = 0;
+
+  RegistroBorda proxima() {
+    RegistroBorda borda;
+    instante += 50 + (indice % 7);
+    borda.instante = instante;
+    borda.nivel = (uint8_t)(indice & 1);
+    indice++;
+    return borda;
+  }
+};
+
+// Confere uma borda retirada contra a fonte de referência (a mesma sequência do produtor).
+static bool mesmaBorda(const RegistroBorda& borda, FonteBordas& referencia) {
+  RegistroBorda esperada = referencia.proxima();
+  return borda.instante == esperada.instante && borda.nivel == esperada.nivel;
+}
+
+// Produz e consome em passos de tamanhos variados: os índices dão muitas voltas e a ordem deve ser mantida.
+template <uint8_t Capacidade>
+static void testarVoltas() {
+  bufferCircularSPSC<RegistroBorda, Capacidade> fila;
+  FonteBordas fonte, referencia;
+  RegistroBorda lote[Capacidade];
+  unsigned long retiradas = 0;
+  bool ordem = true;
+
+  for (unsigned passo = 0; passo < 20000; passo++) {
+    uint8_t inserir = (uint8_t)(1 + passo % fila.capacidadeUtil());
+    for (uint8_t i = 0; i < inserir && fila.ocupacao() < fila.capacidadeUtil(); i++) {
+      ordem = fila.inserir(fonte.proxima()) && ordem;
+    }
+    uint8_t n = fila.retirarLote(lote, (uint8_t)(1 + passo % Capacidade));
+    for (uint8_t i = 0; i < n; i++) {
+      ordem = mesmaBorda(lote[i], referencia) && ordem;
+    }
+    retiradas += n;
+  }
+  uint8_t n;
+  while ((n = fila.retirarLote(lote, Capacidade)) > 0) {
+    for (uint8_t i = 0; i < n; i++) {
+      ordem = mesmaBorda(lote[i], referencia) && ordem;
+    }
+    retiradas += n;
+  }
+
+  printf("Capacidade %3u: %lu bordas, %lu voltas dos índices\n", Capacidade, retiradas, retiradas / Capacidade);
+  verificar(ordem, "voltas dos índices: borda fora de ordem ou alterada");
+  verificar(retiradas == fonte.indice, "voltas dos índices: bordas inseridas e retiradas diferentes");
+  verificar(retiradas > 256UL * Capacidade, "voltas dos índices: poucas voltas");
+  verificar(fila.lerTransbordos() == 0, "voltas dos índices: transbordo sem fila cheia");
+  verificar(fila.ocupacao() == 0, "voltas dos índices: fila não ficou vazia");
+}
+
+// Enche a fila, transborda, consome parte e volta a encher com a cabeça antes da cauda.
+static void testarFilaCheia() {
+  const uint8_t CAPACIDADE = 8;
+  bufferCircularSPSC<RegistroBorda, CAPACIDADE> fila;
+  FonteBordas fonte, referencia;
+  RegistroBorda lote[CAPACIDADE];
+
+  uint8_t aceitas = 0;
+  while (fila.inserir(fonte.proxima())) {
+    aceitas++;
+  }
+  verificar(aceitas == fila.capacidadeUtil(), "fila cheia: capacidade útil diferente de Capacidade - 1");
+  verificar(fila.ocupacao() == fila.capacidadeUtil(), "fila cheia: ocupação");
+  verificar(fila.lerTransbordos() == 1, "fila cheia: primeiro transbordo não contado");
+  for (uint8_t i = 0; i < 10; i++) {
+    verificar(!fila.inserir(fonte.proxima()), "fila cheia: inserção aceita sem espaço");
+  }
+  verificar(fila.lerTransbordos() == 11, "fila cheia: contador de transbordos");
+
+  // Os registros guardados são os primeiros: os transbordados foram descartados, não sobrescreveram nada.
+  uint8_t n = fila.retirarLote(lote, 3);
+  bool ordem = n == 3;
+  for (uint8_t i = 0; i < n; i++) {
+    ordem = mesmaBorda(lote[i], referencia) && ordem;
+  }
+  verificar(ordem, "fila cheia: registros guardados alterados pelo transbordo");
+  verificar(fila.lerOcupacaoMaxima() == fila.capacidadeUtil(), "fila cheia: ocupação máxima");
+
+  // Três posições livres: a cabeça dá a volta e fica atrás da cauda.
+  FonteBordas segunda;
+  segunda.instante = 1000000;
+  for (uint8_t i = 0; i < 3; i++) {
+    verificar(fila.inserir(segunda.proxima()), "fila cheia: posição liberada não aceita");
+  }
+  verificar(!fila.inserir(segunda.proxima()), "fila cheia: inserção aceita depois da volta");
+  verificar(fila.lerTransbordos() == 12, "fila cheia: transbordo depois da volta");
+
+  n = fila.retirarLote(lote, CAPACIDADE);
+  verificar(n == fila.capacidadeUtil(), "fila cheia: lote depois da volta");
+  for (uint8_t i = 0; i < 4 && i < n; i++) {
+    ordem = mesmaBorda(lote[i], referencia) && ordem;
+  }
+  FonteBordas referenciaSegunda;
+  referenciaSegunda.instante = 1000000;
+  for (uint8_t i = 4; i < n; i++) {
+    ordem = mesmaBorda(lote[i], referenciaSegunda) && ordem;
+  }
+  verificar(ordem, "fila cheia: ordem depois da volta");
+
+  fila.zerarContadores();
+  verificar(fila.lerTransbordos() == 0 && fila.lerOcupacaoMaxima() == 0, "zerarContadores: contadores não zerados");
+  fila.inserir(fonte.proxima());
+  fila.inserir(fonte.proxima());
+  fila.esvaziar();
+  verificar(fila.ocupacao() == 0 && fila.retirarLote(lote, CAPACIDADE) == 0, "esvaziar: registros pendentes");
+  printf("Fila cheia: %u aceitas, transbordos e esvaziar conferidos\n", aceitas);
+}
+
+// Produtor em outra thread, como a interrupção. Na maior parte do tempo espera haver espaço (nenhuma borda se perde);
+// em rajadas periódicas insere sem esperar, mais rápido que o consumidor: os transbordos aparecem e são contados.
+static void testarProdutorConcorrente() {
+  const unsigned long BORDAS = 500000;
+  const uint8_t CAPACIDADE = 64; // A mesma da fila do sensorOpticoPro.
+  static bufferCircularSPSC<RegistroBorda, CAPACIDADE> fila;
+  std::atomic<bool> terminou(false);
+  unsigned long recusadas = 0;
+
+  std::thread produtor([&]() {
+    FonteBordas fonte;
+    for (unsigned long i = 0; i < BORDAS; i++) {
+      bool rajada = (i % 4096) >= 4000;
+      while (!rajada && fila.ocupacao() == fila.capacidadeUtil()) {
+        std::this_thread::yield();
+      }
+      if (!fila.inserir(fonte.proxima())) {
+        recusadas++;
+      }
+    }
+    terminou = true;
+  });
+
+  // Sem transbordo, a sequência é a da fonte; com transbordo, a borda recusada some e a seguinte vem depois dela.
+  RegistroBorda lote[CAPACIDADE];
+  unsigned long retiradas = 0, anterior = 0;
+  bool ordem = true;
+  for (;;) {
+    bool fim = terminou;
+    uint8_t n = fila.retirarLote(lote, (uint8_t)(1 + retiradas % 16));
+    for (uint8_t i = 0; i < n; i++) {
+      ordem = lote[i].instante > anterior && ordem;
+      anterior = lote[i].instante;
+    }
+    retiradas += n;
+    if (n == 0 && fim) {
+      break;
+    }
+    if (n == 0) {
+      std::this_thread::yield(); // Com um só núcleo, deixa o produtor avançar.
+    }
+  }
+  produtor.join();
+
+  printf("Produtor concorrente: %lu bordas, %lu retiradas, %u transbordos, ocupação máxima %u/%u\n",
+         BORDAS, retiradas, fila.lerTransbordos(), fila.lerOcupacaoMaxima(), fila.capacidadeUtil());
+  verificar(ordem, "produtor concorrente: borda duplicada ou fora de ordem");
+  verificar(retiradas + recusadas == BORDAS, "produtor concorrente: borda perdida sem transbordo");
+  verificar(retiradas > BORDAS / 2, "produtor concorrente: poucas bordas passaram pela fila");
+  verificar(fila.lerTransbordos() == (uint16_t)recusadas, "produtor concorrente: contador de transbordos");
+}
+
+int main() {
+  testarVoltas<2>();
+  testarVoltas<8>();
+  testarVoltas<128>();
+  testarFilaCheia();
+  testarProdutorConcorrente();
+  printf(falhas == 0 ? "Todas as verificações passaram.\n" : "%u verificações falharam.\n", falhas);
+  return falhas == 0 ? 0 : 1;
+}